@@ -0,0 +1,163 @@
+/*!*********************************************************************************************************************
+@file host.h
+@brief Header file for the Linux host build of the firmware
+
+Included by SDCard_Interface/hal.h when HOST_BUILD is defined, and by the
+host-only programs in this directory.
+
+**********************************************************************************************************************/
+
+#ifndef __HOST_H
+#define __HOST_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! @brief Runs in main loop context each time the firmware idles; returns true if it did anything */
+typedef bool (*HostIdleHookType)(void);
+
+/*! @brief Told about every DAC1 write with the virtual time it happened */
+typedef void (*HostDacListenerType)(u64 u64Time_, u8 u8Value_);
+
+/*! @brief Told about every byte UART1 sends, with the virtual time its stop bit ends */
+typedef void (*HostUartListenerType)(u64 u64Time_, u8 u8Byte_);
+
+/*! @brief Picks the 0xFF bytes a read of u32Sector_ sends before its data token */
+typedef u16 (*HostSdLatencyModelType)(u32 u32Sector_);
+
+/*!
+@struct HostVectorStatsType
+@brief Per-interrupt counters kept by the host CPU model.
+*/
+typedef struct
+{
+  const char* pcName;             /*!< @brief ISR name */
+  u32 u32Calls;                   /*!< @brief Times the ISR was called */
+} HostVectorStatsType;
+
+/*!
+@struct HostSdStatsType
+@brief Counters kept by the SD card model.
+*/
+typedef struct
+{
+  u64 u64Bytes;                   /*!< @brief SPI bytes exchanged with the card */
+  u32 u32Commands;                /*!< @brief Command frames received */
+  u32 u32SectorsRead;             /*!< @brief CMD17 data blocks sent */
+  u32 u32SectorsWritten;          /*!< @brief CMD24 data blocks stored */
+  u32 u32Errors;                  /*!< @brief Commands rejected (bad address, unknown command) */
+} HostSdStatsType;
+
+
+/*!
+@struct HostWavStatsType
+@brief What a DAC capture found; see host_wav.c for how intervals are classed.
+*/
+typedef struct
+{
+  u32 u32Rate;                    /*!< @brief Nominal sample rate in Hz */
+  u32 u32Samples;                 /*!< @brief Samples rendered */
+  u32 u32Writes;                  /*!< @brief DAC writes seen */
+  u32 u32Regular;                 /*!< @brief Intervals within half a period of nominal */
+  u32 u32Early;                   /*!< @brief Intervals under half a period */
+  u32 u32Dropouts;                /*!< @brief Intervals of 1.5 periods up to HOST_WAV_PAUSE_TICKS */
+  u32 u32MissedSamples;           /*!< @brief Sample periods with no write, over all dropouts */
+  u32 u32Pauses;                  /*!< @brief Intervals over HOST_WAV_PAUSE_TICKS */
+  double dMeanPeriodTicks;        /*!< @brief Mean regular interval */
+  double dRmsJitterTicks;         /*!< @brief RMS deviation of regular intervals from nominal */
+  u64 u64MaxJitterTicks;          /*!< @brief Largest deviation of a regular interval */
+} HostWavStatsType;
+
+/*!
+@struct HostWavCompareType
+@brief Result of comparing a capture with a golden WAV.
+*/
+typedef struct
+{
+  bool bReadable;                 /*!< @brief The golden file is a mono 8-bit PCM WAV */
+  u32 u32GoldenRate;
+  u32 u32GoldenSamples;
+  u32 u32Samples;                 /*!< @brief Samples in the capture */
+  u32 u32Differences;             /*!< @brief Samples that differ, over the common length */
+  u32 u32FirstDifference;         /*!< @brief Index of the first, UINT32_MAX if none */
+  u8  u8MaxError;                 /*!< @brief Largest absolute difference */
+} HostWavCompareType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* host_cpu.c */
+void HostReset(void);
+bool HostRun(u64 u64Until_);
+u64  HostNow(void);
+void HostAdvance(u64 u64Ticks_);
+void HostSetIdleHook(HostIdleHookType pfnHook_);
+void HostSetDacListener(HostDacListenerType pfnListener_);
+void HostSetUartListener(HostUartListenerType pfnListener_);
+void HostUartInput(const u8* pu8Data_, u16 u16Length_);
+bool HostSetIsrCycles(const char* pcIsr_, u16 u16Cycles_);
+const HostVectorStatsType* HostVectorStats(u8* pu8Count_);
+
+/* host_sd.c */
+bool HostSdCreate(u32 u32Sectors_);
+bool HostSdLoad(const char* pcPath_);
+bool HostSdSave(const char* pcPath_);
+u8*  HostSdSector(u32 u32Sector_);
+u32  HostSdSectors(void);
+void HostSdSetReadLatency(u16 u16Bytes_);
+void HostSdSetLatencyModel(HostSdLatencyModelType pfnModel_);
+const HostSdStatsType* HostSdStats(void);
+
+
+/* host_wav.c */
+bool HostWavBegin(u32 u32RateHz_);
+void HostWavDac(u64 u64Time_, u8 u8Value_, bool bSample_);
+void HostWavEnd(u64 u64Time_);
+const HostWavStatsType* HostWavStats(void);
+bool HostWavSave(const char* pcPath_);
+bool HostWavCompare(const char* pcGolden_, u8 u8Tolerance_, HostWavCompareType* pstResult_);
+s16* HostWavLoad(const char* pcPath_, u32* pu32Rate_, u32* pu32Samples_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Firmware side, reached through xc.h and hal.h */
+void HostNop(void);
+void HostSleep(void);
+void HostSpiTransmit(u8 u8Byte_);
+void HostDacWrite(u8 u8Value_);
+void HostUartDma(const u8* pu8Source_, u16 u16Count_);
+bool HostUartRxReady(void);
+u8   HostUartRead(void);
+u8   HostSdExchange(u8 u8Mosi_);
+
+/* main() in SDCard_Interface/main.c, renamed by the Makefile */
+void FirmwareMain(void);
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/*! @brief Virtual time unit: one period of the 64MHz oscillator */
+#define HOST_TICKS_PER_US         (u64)64
+#define HOST_TICKS_PER_MS         (HOST_TICKS_PER_US * 1000)
+#define HOST_TICKS_PER_S          (HOST_TICKS_PER_MS * 1000)
+
+#define HOST_SD_SECTOR_SIZE       512
+#define HOST_SD_READ_LATENCY      (u16)8       /*!< @brief Default 0xFF bytes before a read's data token */
+#define HOST_SD_MAX_READ_LATENCY  (u16)8192    /*!< @brief About 8ms at the 64MHz SPI rate */
+
+#define HOST_WAV_PAUSE_TICKS      (20 * HOST_TICKS_PER_MS)  /*!< @brief DAC silent this long: playback stopped, not a dropout */
+
+
+#endif /* __HOST_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,485 @@
+/*!*********************************************************************************************************************
+@file host_bench.c
+@brief Micro-benchmarks of the firmware's hot paths, run on the host build.
+
+  heart_rate_music_bench [-o results.txt] [-b baseline.txt] [-r revision] [-t percent] [-n name]
+
+-o  also writes the results to a file (the Makefile uses ../bench_output.txt)
+-b  compares with an earlier results file and flags regressions
+-r  revision label for the results header, e.g. the git commit
+-t  host-time change that counts as a regression, default 15 percent
+-n  runs only the benchmark called name
+
+The firmware boots as usual (SD card initialized, cache set up) and the
+benchmarks run from the first main loop idle, so every path sees the state
+it has on the part.  Each reports host_ns, the best of HOST_BENCH_BATCHES
+batches of native CPU time per call.  It follows the code's cost but isn't
+PIC cycles; compare it between commits on one machine only.  The host model
+charges no time for code, so virtual time says nothing here.
+
+The sector copy loop is the body of SD_ReadSector and the cache index
+lookup (SDCache_Find) is most of an SDCache_Read hit, so sd_read_sector and
+sdcache_hit time them; neither has a separate entry point.  There is no song
+library index, DDS, mixer, beat detector or BPM estimator in the firmware.
+
+Output is one line per benchmark in table order, name first, '#' lines are
+comments; scripts can rely on that.  On the part, CRC16_Benchmark() and
+isr_profile.c give real cycle counts.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+***********************************************************************************************************************/
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern volatile u32 G_u32AudioUnderruns;                  /*!< @brief From audio.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostBench_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_BENCH_VERSION        2            /* Bump if the output format changes */
+#define HOST_BENCH_BATCHES        (u8)9
+#define HOST_BENCH_BATCH_NS       (u64)20000000   /* Aim for 20ms per batch */
+#define HOST_BENCH_MAX            (u8)16
+#define HOST_BENCH_CACHE_SECTOR   (u32)7
+#define HOST_BENCH_SECTORS        (u32)64     /* sd_read_sector cycles through sectors 1 - 64 */
+#define HOST_BENCH_EVENT          (u8)0x01    /* Event code posted by event_post_get */
+
+/*!
+@struct HostBenchType
+@brief One benchmark: what it times, and optional set-up and tear-down.
+*/
+typedef struct
+{
+  const char* pcName;
+  const char* pcWhat;
+  void (*pfnSetup)(void);
+  void (*pfnRun)(void);
+  void (*pfnTeardown)(void);
+} HostBenchType;
+
+/*!
+@struct HostBenchResultType
+@brief One line of a results file.
+*/
+typedef struct
+{
+  char acName[32];
+  double dHostNs;
+} HostBenchResultType;
+
+static u8  HostBench_au8Sector[HOST_SD_SECTOR_SIZE];
+static u8  HostBench_au8Frame[5] = {0x51, 0x00, 0x00, 0x12, 0x34};   /* CMD17 frame without its CRC byte */
+static u32 HostBench_u32Sector;
+static volatile u16 HostBench_u16Sink;                    /*!< @brief Keeps results alive past the optimizer */
+static u8  HostBench_au8Decoded[AUDIO_DECODE_CHUNK];
+EVENT_QUEUE_DEFINE(HostBench_stQueue, 16);
+
+static const char* HostBench_pcOutput;
+static const char* HostBench_pcBaseline;
+static const char* HostBench_pcRevision = "unknown";
+static const char* HostBench_pcOnly;
+static double HostBench_dThreshold = 15.0;
+
+static HostBenchResultType HostBench_astResults[HOST_BENCH_MAX];
+static u8 HostBench_u8Results;
+
+static void HostBenchCrc7(void);
+static void HostBenchCrc16Table(void);
+static void HostBenchCrc16Nibble(void);
+static void HostBenchSdRead(void);
+static void HostBenchCacheSetup(void);
+static void HostBenchCacheHit(void);
+static void HostBenchAudioSetup(void);
+static void HostBenchAudioSample(void);
+static void HostBenchAudioTeardown(void);
+static void HostBenchEvent(void);
+static void HostBenchAdpcm(void);
+
+static u64  HostBenchNs(void);
+static void HostBenchMeasure(const HostBenchType* pstBench_, HostBenchResultType* pstResult_, u32* pu32Calls_);
+static bool HostBenchIdle(void);
+static void HostBenchPrint(FILE* pFile_);
+static u8   HostBenchCompare(const char* pcBaseline_);
+
+/*! @brief Every benchmark, in output order.  Paths that don't exist in the firmware yet get a line here when they do. */
+static const HostBenchType HostBench_astBenches[] =
+{
+  {"crc7_frame",        "CRC7_Block (UPDATE_CRC table) over a 5-byte command", NULL, HostBenchCrc7, NULL},
+  {"crc16_table_512",   "CRC16_BlockTable over a sector",                      NULL, HostBenchCrc16Table, NULL},
+  {"crc16_nibble_512",  "CRC16_BlockNibble over a sector",                     NULL, HostBenchCrc16Nibble, NULL},
+  {"sd_read_sector",    "SD_ReadSector: command, copy loop and CRC16",         NULL, HostBenchSdRead, NULL},
+  {"sdcache_hit",       "SDCache_Read of a resident sector (index lookups)",   HostBenchCacheSetup, HostBenchCacheHit, NULL},
+  {"audio_sample",      "AudioSampleCallback: per-sample work in TMR1_ISR",    HostBenchAudioSetup, HostBenchAudioSample, HostBenchAudioTeardown},
+  {"event_post_get",    "EventQueuePost + EventQueueGet of one event",         NULL, HostBenchEvent, NULL},
+  {"adpcm_decode_chunk","AdpcmDecode of AUDIO_DECODE_CHUNK samples",           NULL, HostBenchAdpcm, NULL},
+};
+
+#define HOST_BENCH_COUNT          (u8)(sizeof(HostBench_astBenches) / sizeof(HostBench_astBenches[0]))
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+  for(int i = 1; i < argc; i++)
+  {
+    if( (strcmp(argv[i], "-o") == 0) && (i + 1 < argc) )
+    {
+      HostBench_pcOutput = argv[++i];
+    }
+    else if( (strcmp(argv[i], "-b") == 0) && (i + 1 < argc) )
+    {
+      HostBench_pcBaseline = argv[++i];
+    }
+    else if( (strcmp(argv[i], "-r") == 0) && (i + 1 < argc) )
+    {
+      HostBench_pcRevision = argv[++i];
+    }
+    else if( (strcmp(argv[i], "-t") == 0) && (i + 1 < argc) )
+    {
+      HostBench_dThreshold = atof(argv[++i]);
+    }
+    else if( (strcmp(argv[i], "-n") == 0) && (i + 1 < argc) )
+    {
+      HostBench_pcOnly = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [-o results.txt] [-b baseline.txt] [-r revision] [-t percent] [-n name]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  for(u32 i = 0; i < sizeof(HostBench_au8Sector); i++)
+  {
+    HostBench_au8Sector[i] = (u8)(i * 7 + 3);
+  }
+
+  HostReset();
+  HostSdCreate(HOST_BENCH_SECTORS + 1);
+  for(u32 i = 1; i <= HOST_BENCH_SECTORS; i++)
+  {
+    memcpy(HostSdSector(i), HostBench_au8Sector, HOST_SD_SECTOR_SIZE);
+  }
+  HostSetIdleHook(HostBenchIdle);
+
+  /* HostBenchIdle exits; the time limit is only a backstop */
+  HostRun(3600 * HOST_TICKS_PER_S);
+  fprintf(stderr, "%s: the firmware never reached its main loop\n", argv[0]);
+  return EXIT_FAILURE;
+
+} /* end main() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Benchmarks: one call of pfnRun is one operation */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+static void HostBenchCrc7(void)
+{
+  HostBench_u16Sink = CRC7_Block(HostBench_au8Frame, sizeof(HostBench_au8Frame));
+}
+
+static void HostBenchCrc16Table(void)
+{
+  HostBench_u16Sink = CRC16_BlockTable(HostBench_au8Sector, HOST_SD_SECTOR_SIZE);
+}
+
+static void HostBenchCrc16Nibble(void)
+{
+  HostBench_u16Sink = CRC16_BlockNibble(HostBench_au8Sector, HOST_SD_SECTOR_SIZE);
+}
+
+static void HostBenchSdRead(void)
+{
+  HostBench_u32Sector = (HostBench_u32Sector % HOST_BENCH_SECTORS) + 1;
+  HostBench_u16Sink = SD_ReadSector(HostBench_u32Sector, HostBench_au8Sector);
+}
+
+static void HostBenchCacheSetup(void)
+{
+  SDCache_Read(HOST_BENCH_CACHE_SECTOR, 0);
+}
+
+static void HostBenchCacheHit(void)
+{
+  HostBench_u16Sink = SDCache_Read(HOST_BENCH_CACHE_SECTOR, 0)[0];
+}
+
+/* Playback with Timer1 stopped, so only the benchmark calls the sample
+ * call-back.  Buffers aren't refilled, so once in 512 calls it takes the
+ * buffer-swap path as it does on the part. */
+static void HostBenchAudioSetup(void)
+{
+  AudioStart(1, HOST_BENCH_SECTORS, 125, AUDIO_FORMAT_PCM8);
+  TimerStop(TIMER_1);
+}
+
+static void HostBenchAudioSample(void)
+{
+  AudioSampleCallback();
+}
+
+static void HostBenchAudioTeardown(void)
+{
+  AudioStop();
+  G_u32AudioUnderruns = 0;
+}
+
+static void HostBenchEvent(void)
+{
+  EventType stEvent;
+
+  EventQueuePost(&HostBench_stQueue, HOST_BENCH_EVENT, 0, HostBench_u16Sink);
+  EventQueueGet(&HostBench_stQueue, &stEvent);
+  HostBench_u16Sink = stEvent.u16Data + 1;
+}
+
+/* Mid-block, with the step index mid-range; the sector pattern serves as codes */
+static void HostBenchAdpcm(void)
+{
+  AdpcmStateType stState = {0x8000, 40};
+
+  AdpcmDecode(&stState, HostBench_au8Sector, 1, HostBench_au8Decoded, AUDIO_DECODE_CHUNK);
+  HostBench_u16Sink = HostBench_au8Decoded[AUDIO_DECODE_CHUNK - 1];
+}
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Harness */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u64 HostBenchNs(void)
+
+@brief Returns the CPU time this process has used, in nanoseconds, so time
+spent preempted by other processes does not count.
+
+*/
+static u64 HostBenchNs(void)
+{
+  struct timespec stNow;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stNow);
+  return (u64)stNow.tv_sec * 1000000000u + (u64)stNow.tv_nsec;
+
+} /* end HostBenchNs() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostBenchMeasure(const HostBenchType* pstBench_, HostBenchResultType* pstResult_, u32* pu32Calls_)
+
+@brief Times one benchmark: doubles the calls per batch until a batch takes
+HOST_BENCH_BATCH_NS, then keeps the best of HOST_BENCH_BATCHES batches.
+
+*/
+static void HostBenchMeasure(const HostBenchType* pstBench_, HostBenchResultType* pstResult_, u32* pu32Calls_)
+{
+  u32 u32Calls = 1;
+  u64 u64Start;
+  u64 u64Ns;
+  double dBest = 0.0;
+
+  if(pstBench_->pfnSetup != NULL)
+  {
+    pstBench_->pfnSetup();
+  }
+
+  for(;;)
+  {
+    u64Start = HostBenchNs();
+    for(u32 i = 0; i < u32Calls; i++)
+    {
+      pstBench_->pfnRun();
+    }
+    u64Ns = HostBenchNs() - u64Start;
+
+    if( (u64Ns >= HOST_BENCH_BATCH_NS) || (u32Calls >= 0x40000000u) )
+    {
+      break;
+    }
+    u32Calls *= 2;
+  }
+
+  for(u8 i = 0; i < HOST_BENCH_BATCHES; i++)
+  {
+    u64Start = HostBenchNs();
+    for(u32 j = 0; j < u32Calls; j++)
+    {
+      pstBench_->pfnRun();
+    }
+    u64Ns = HostBenchNs() - u64Start;
+
+    if( (i == 0) || ((double)u64Ns / u32Calls < dBest) )
+    {
+      dBest = (double)u64Ns / u32Calls;
+    }
+  }
+
+  if(pstBench_->pfnTeardown != NULL)
+  {
+    pstBench_->pfnTeardown();
+  }
+
+  strncpy(pstResult_->acName, pstBench_->pcName, sizeof(pstResult_->acName) - 1);
+  pstResult_->dHostNs = dBest;
+  *pu32Calls_ = u32Calls;
+
+} /* end HostBenchMeasure() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static bool HostBenchIdle(void)
+
+@brief Idle hook: runs every benchmark, reports and exits the program.
+
+*/
+static bool HostBenchIdle(void)
+{
+  u32 u32Calls;
+  u8 u8Regressions = 0;
+  FILE* pFile;
+
+  for(u8 i = 0; i < HOST_BENCH_COUNT; i++)
+  {
+    if( (HostBench_pcOnly != NULL) && (strcmp(HostBench_pcOnly, HostBench_astBenches[i].pcName) != 0) )
+    {
+      continue;
+    }
+
+    HostBenchMeasure(&HostBench_astBenches[i], &HostBench_astResults[HostBench_u8Results], &u32Calls);
+    fprintf(stderr, "%-18s %10u calls per batch  %s\n", HostBench_astBenches[i].pcName, u32Calls,
+            HostBench_astBenches[i].pcWhat);
+    HostBench_u8Results++;
+  }
+
+  HostBenchPrint(stdout);
+
+  if(HostBench_pcOutput != NULL)
+  {
+    pFile = fopen(HostBench_pcOutput, "w");
+    if(pFile == NULL)
+    {
+      fprintf(stderr, "can't write %s\n", HostBench_pcOutput);
+      exit(EXIT_FAILURE);
+    }
+    HostBenchPrint(pFile);
+    fclose(pFile);
+  }
+
+  if(HostBench_pcBaseline != NULL)
+  {
+    u8Regressions = HostBenchCompare(HostBench_pcBaseline);
+  }
+
+  exit( (u8Regressions == 0) ? EXIT_SUCCESS : EXIT_FAILURE );
+
+} /* end HostBenchIdle() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostBenchPrint(FILE* pFile_)
+
+@brief Writes the results in the stable results-file format.
+
+*/
+static void HostBenchPrint(FILE* pFile_)
+{
+  fprintf(pFile_, "# heart_rate_music_bench %d\n", HOST_BENCH_VERSION);
+  fprintf(pFile_, "# revision %s\n", HostBench_pcRevision);
+  fprintf(pFile_, "# %-18s %12s\n", "name", "host_ns");
+
+  for(u8 i = 0; i < HostBench_u8Results; i++)
+  {
+    fprintf(pFile_, "%-20s %12.1f\n", HostBench_astResults[i].acName, HostBench_astResults[i].dHostNs);
+  }
+
+} /* end HostBenchPrint() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u8 HostBenchCompare(const char* pcBaseline_)
+
+@brief Prints each result against a baseline file and returns the number of regressions.
+
+A regression is host time up by more than the -t threshold.  Benchmarks
+missing from either side are listed but don't count.  Any columns after
+host_ns in the baseline are ignored.
+
+*/
+static u8 HostBenchCompare(const char* pcBaseline_)
+{
+  char acLine[128];
+  char acRevision[64] = "unknown";
+  HostBenchResultType stOld;
+  HostBenchResultType* pstNew;
+  double dChange;
+  bool bRegressed;
+  u8 u8Regressions = 0;
+  FILE* pFile = fopen(pcBaseline_, "r");
+
+  if(pFile == NULL)
+  {
+    printf("# no baseline %s\n", pcBaseline_);
+    return 0;
+  }
+
+  while(fgets(acLine, sizeof(acLine), pFile) != NULL)
+  {
+    if(sscanf(acLine, "# revision %63s", acRevision) == 1)
+    {
+      printf("# against %s\n", acRevision);
+      continue;
+    }
+
+    if( (acLine[0] == '#') ||
+        (sscanf(acLine, "%31s %lf", stOld.acName, &stOld.dHostNs) != 2) )
+    {
+      continue;
+    }
+
+    pstNew = NULL;
+    for(u8 i = 0; i < HostBench_u8Results; i++)
+    {
+      if(strcmp(HostBench_astResults[i].acName, stOld.acName) == 0)
+      {
+        pstNew = &HostBench_astResults[i];
+      }
+    }
+
+    if(pstNew == NULL)
+    {
+      printf("%-20s gone\n", stOld.acName);
+      continue;
+    }
+
+    dChange = (stOld.dHostNs > 0.0) ? (100.0 * (pstNew->dHostNs - stOld.dHostNs) / stOld.dHostNs) : 0.0;
+    bRegressed = (dChange > HostBench_dThreshold);
+    u8Regressions += bRegressed ? 1 : 0;
+
+    printf("%-20s %12.1f -> %12.1f ns %+7.1f%%%s\n", stOld.acName,
+           stOld.dHostNs, pstNew->dHostNs, dChange, bRegressed ? "   REGRESSION" : "");
+  }
+  fclose(pFile);
+
+  return u8Regressions;
+
+} /* end HostBenchCompare() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,982 @@
+/*!*********************************************************************************************************************
+@file host_cpu.c
+@brief Virtual clock, timers and interrupt controller for the Linux host build.
+
+The firmware runs natively and its registers are plain memory (host_sfr.s,
+generated from pic18f27q43.h).  Firmware code takes no virtual time.  Time
+moves when the firmware does something that takes time on the part:
+
+- an SPI byte (HAL_SPI_TX) takes 8 SCK periods at the SPI1BAUD rate
+- NOP()/__nop() takes one instruction cycle
+- SLEEP() jumps to the next timer event that sets an enabled interrupt flag
+
+While time moves, Timer0 (16-bit mode), Timer1/3/5 and Timer2 count at the
+rate their registers and OSCFRQ select, and set their interrupt flags.
+A UART1 transmit block (HAL_UART_DMA_START) takes 10 bit times per byte at
+the U1BRG rate, then sets DMA1SCNTIF; each byte goes to the UART listener
+with the time it finishes.  Bytes for the firmware to receive are queued
+with HostUartInput().
+Pending interrupts are taken after every step, following the Q43 rules:
+with IPEN set, a source whose IPRx bit is set is high priority, needs GIEH
+and can preempt a low priority ISR; a low priority source needs GIEH and
+GIEL and only runs from the main loop.  Ties go to the lowest IRQ number.
+Interrupts the host does not know about are never raised.
+
+Virtual time is counted in periods of the 64MHz oscillator (HOST_TICKS_PER_US
+per microsecond).  HostRun() runs FirmwareMain() until a virtual time and
+then unwinds out of it with longjmp, so a run is one call and one process.
+
+The hardware CRC module is not modelled; keep the CRC16 kernel on a table
+for host runs.  Address commands carry a dummy CRC, which the SD model
+ignores just as a card does once CMD59 has turned CRC checking off.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- NONE
+
+CONSTANTS
+- HOST_TICKS_PER_US, HOST_TICKS_PER_MS, HOST_TICKS_PER_S
+
+TYPES
+- HostIdleHookType
+- HostDacListenerType
+- HostUartListenerType
+- HostVectorStatsType
+
+PUBLIC FUNCTIONS
+- void HostReset(void)
+- bool HostRun(u64 u64Until_)
+- u64 HostNow(void)
+- void HostAdvance(u64 u64Ticks_)
+- void HostSetIdleHook(HostIdleHookType pfnHook_)
+- void HostSetDacListener(HostDacListenerType pfnListener_)
+- void HostSetUartListener(HostUartListenerType pfnListener_)
+- void HostUartInput(const u8* pu8Data_, u16 u16Length_)
+- bool HostSetIsrCycles(const char* pcIsr_, u16 u16Cycles_)
+- const HostVectorStatsType* HostVectorStats(u8* pu8Count_)
+
+PROTECTED FUNCTIONS
+- void HostNop(void)
+- void HostSleep(void)
+- void HostSpiTransmit(u8 u8Byte_)
+- void HostDacWrite(u8 u8Value_)
+- void HostUartDma(const u8* pu8Source_, u16 u16Count_)
+- bool HostUartRxReady(void)
+- u8 HostUartRead(void)
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+***********************************************************************************************************************/
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern u8 HostSfr[];                                      /*!< @brief From host_sfr.s: the register file */
+
+/* ISRs from interrupts.c; plain functions in the host build */
+void SW_ISR(void);
+void DMA1SCNT_ISR(void);
+void TMR0_ISR(void);
+void TMR1_ISR(void);
+void TMR2_ISR(void);
+void TMR3_ISR(void);
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Host_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_SFR_SIZE             0x500      /* Data-sheet SFR space 0x000 - 0x4FF */
+#define HOST_LEVEL_MAIN           (u8)0
+#define HOST_LEVEL_LOW            (u8)1
+#define HOST_LEVEL_HIGH           (u8)2
+#define HOST_STUCK_LIMIT          (u32)1000000  /* ISR calls with no time passing before giving up */
+#define HOST_UART_RX_SIZE         (u16)256
+
+/*!
+@struct HostVectorType
+@brief One interrupt source: its flag, enable and priority bits and ISR.
+*/
+typedef struct
+{
+  volatile u8* pu8Pir;
+  volatile u8* pu8Pie;
+  volatile u8* pu8Ipr;
+  u8 u8Mask;
+  void (*pfnIsr)(void);
+} HostVectorType;
+
+/* In IRQ number order, which is the order ties are resolved in */
+static const HostVectorType Host_astVectors[] =
+{
+  {&PIR0, &PIE0, &IPR0, _PIR0_SWIF_MASK,   SW_ISR},     /* IRQ_SWINT  0 */
+  {&PIR2, &PIE2, &IPR2, _PIR2_DMA1SCNTIF_MASK, DMA1SCNT_ISR}, /* IRQ_DMA1SCNT 20 */
+  {&PIR3, &PIE3, &IPR3, _PIR3_TMR2IF_MASK, TMR2_ISR},   /* IRQ_TMR2  27 */
+  {&PIR3, &PIE3, &IPR3, _PIR3_TMR1IF_MASK, TMR1_ISR},   /* IRQ_TMR1  28 */
+  {&PIR3, &PIE3, &IPR3, _PIR3_TMR0IF_MASK, TMR0_ISR},   /* IRQ_TMR0  31 */
+  {&PIR5, &PIE5, &IPR5, _PIR5_TMR3IF_MASK, TMR3_ISR},   /* IRQ_TMR3  44 */
+};
+
+#define HOST_VECTORS              (u8)(sizeof(Host_astVectors) / sizeof(Host_astVectors[0]))
+
+static HostVectorStatsType Host_astVectorStats[HOST_VECTORS] =
+{
+  {"SW_ISR", 0}, {"DMA1SCNT_ISR", 0}, {"TMR2_ISR", 0}, {"TMR1_ISR", 0}, {"TMR0_ISR", 0}, {"TMR3_ISR", 0},
+};
+
+/* Timers that are modelled */
+typedef enum {HOST_TMR0, HOST_TMR1, HOST_TMR2, HOST_TMR3, HOST_TMR5, HOST_TIMERS} HostTimerType;
+
+static u64 Host_u64Now;                                   /*!< @brief Virtual time */
+static u64 Host_u64Until;                                 /*!< @brief HostRun stops here */
+static jmp_buf Host_jbStop;                               /*!< @brief Back into HostRun */
+static u8  Host_u8Level;                                  /*!< @brief HOST_LEVEL_xxx currently executing */
+static u32 Host_u32StuckCount;                            /*!< @brief ISR calls since time last moved */
+
+static u64 Host_au64TimerTicks[HOST_TIMERS];              /*!< @brief Virtual ticks not yet making a whole count */
+static u64 Host_au64TimerPeriod[HOST_TIMERS];             /*!< @brief HostTimerPeriod() as of the last HostNextEvent() */
+static u8  Host_u8Timer2Postscale;                        /*!< @brief Timer2 periods since the last TMR2IF */
+
+static u64 Host_u64UartDone;                              /*!< @brief Time the UART block under way ends, 0 if none */
+static u8  Host_au8UartRx[HOST_UART_RX_SIZE];             /*!< @brief Bytes queued for the firmware to receive */
+static u16 Host_u16UartRxHead;
+static u16 Host_u16UartRxTail;
+
+static HostIdleHookType Host_pfnIdleHook;
+static HostDacListenerType Host_pfnDacListener;
+static HostUartListenerType Host_pfnUartListener;
+static u16 Host_au16IsrCycles[HOST_VECTORS];              /*!< @brief Instruction cycles charged per ISR call */
+
+static u64  HostCycleTicks(void);
+static u64  HostTimerPeriod(HostTimerType eTimer_);
+static u32  HostTimerCountsToEvent(HostTimerType eTimer_);
+static void HostTimerCount(HostTimerType eTimer_, u32 u32Counts_);
+static u64  HostNextEvent(void);
+static void HostStep(u64 u64Ticks_);
+static void HostAdvanceTo(u64 u64Time_);
+static bool HostWakePending(void);
+static void HostInterruptPoint(void);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostReset(void)
+
+@brief Puts the register file and virtual clock into their power-on state.
+
+Requires:
+- Called once before HostRun
+
+Promises:
+- Registers zero except those with non-zero reset values the firmware
+  relies on (IPRx, T2PR, OSCFRQ from RSTOSC, oscillator ready bits)
+- Virtual time 0, no ISR running, statistics cleared
+
+*/
+void HostReset(void)
+{
+  volatile u8* pu8Ipr = &IPR0;
+
+  memset(HostSfr, 0, HOST_SFR_SIZE);
+
+  /* Every source is high priority out of reset (IPR0 - IPR15 are consecutive) */
+  for(u8 i = 0; i < 16; i++)
+  {
+    pu8Ipr[i] = 0xFF;
+  }
+
+  OSCFRQ  = 0x08;         /* RSTOSC = HFINTOSC_64MHZ */
+  OSCSTAT = 0xFF;         /* Every oscillator ready, so HFOR polls pass */
+  T2PR    = 0xFF;
+  TMR0H   = 0xFF;         /* PR0 in 8-bit mode */
+  U1ERRIRbits.TXMTIF = 1; /* Transmit shift register empty */
+
+  Host_u64Now = 0;
+  Host_u8Level = HOST_LEVEL_MAIN;
+  Host_u32StuckCount = 0;
+  Host_u8Timer2Postscale = 0;
+  memset(Host_au64TimerTicks, 0, sizeof(Host_au64TimerTicks));
+  Host_u64UartDone = 0;
+  Host_u16UartRxHead = 0;
+  Host_u16UartRxTail = 0;
+
+  for(u8 i = 0; i < HOST_VECTORS; i++)
+  {
+    Host_astVectorStats[i].u32Calls = 0;
+  }
+
+} /* end HostReset() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostRun(u64 u64Until_)
+
+@brief Runs the firmware from reset until virtual time u64Until_.
+
+Requires:
+- HostReset called and the SD model loaded
+- Only called once per process: the firmware's static data is not reset
+
+Promises:
+- Returns true when virtual time reaches u64Until_; false if main()
+  returned, which it should never do
+
+*/
+bool HostRun(u64 u64Until_)
+{
+  Host_u64Until = u64Until_;
+
+  if(setjmp(Host_jbStop) == 0)
+  {
+    FirmwareMain();
+    return false;
+  }
+
+  Host_u8Level = HOST_LEVEL_MAIN;
+  return true;
+
+} /* end HostRun() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u64 HostNow(void)
+
+@brief Returns the virtual time in HOST_TICKS_PER_US units.
+
+*/
+u64 HostNow(void)
+{
+  return Host_u64Now;
+
+} /* end HostNow() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostAdvance(u64 u64Ticks_)
+
+@brief Lets u64Ticks_ of virtual time pass as if the firmware were busy.
+
+For models of work that takes time on the part but not on the host.
+
+Requires:
+- Called from firmware context (inside HostRun)
+
+Promises:
+- Timers count and interrupts are taken along the way
+
+*/
+void HostAdvance(u64 u64Ticks_)
+{
+  HostAdvanceTo(Host_u64Now + u64Ticks_);
+
+} /* end HostAdvance() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostSetIdleHook(HostIdleHookType pfnHook_)
+
+@brief Registers a function for HostSleep to call from main loop context.
+
+The hook is how a host program drives the firmware: it can call any public
+firmware function, as UserAppRun could.  It runs with GIEL set.  When it
+returns true the SLEEP it was called from returns at once so the firmware
+rechecks its state; when false the firmware sleeps as usual.
+
+Requires:
+- NONE
+
+Promises:
+- pfnHook_ (or nothing, for NULL) is called on every SLEEP from the main loop
+
+*/
+void HostSetIdleHook(HostIdleHookType pfnHook_)
+{
+  Host_pfnIdleHook = pfnHook_;
+
+} /* end HostSetIdleHook() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostSetDacListener(HostDacListenerType pfnListener_)
+
+@brief Registers a function to be told about every DAC1 write.
+
+*/
+void HostSetDacListener(HostDacListenerType pfnListener_)
+{
+  Host_pfnDacListener = pfnListener_;
+
+} /* end HostSetDacListener() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostSetUartListener(HostUartListenerType pfnListener_)
+
+@brief Registers a function to be told about every byte UART1 sends.
+
+*/
+void HostSetUartListener(HostUartListenerType pfnListener_)
+{
+  Host_pfnUartListener = pfnListener_;
+
+} /* end HostSetUartListener() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostUartInput(const u8* pu8Data_, u16 u16Length_)
+
+@brief Queues bytes as if they had arrived on U1RX.
+
+Requires:
+- NONE
+
+Promises:
+- The firmware's next UartRead calls return the bytes in order; bytes that
+  don't fit in HOST_UART_RX_SIZE are dropped, as an overflow would
+
+*/
+void HostUartInput(const u8* pu8Data_, u16 u16Length_)
+{
+  u16 u16Next;
+
+  for(u16 i = 0; i < u16Length_; i++)
+  {
+    u16Next = (u16)((Host_u16UartRxHead + 1) % HOST_UART_RX_SIZE);
+    if(u16Next == Host_u16UartRxTail)
+    {
+      return;
+    }
+
+    Host_au8UartRx[Host_u16UartRxHead] = pu8Data_[i];
+    Host_u16UartRxHead = u16Next;
+  }
+
+} /* end HostUartInput() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostSetIsrCycles(const char* pcIsr_, u16 u16Cycles_)
+
+@brief Charges u16Cycles_ instruction cycles of virtual time for every call of an ISR.
+
+Firmware code is otherwise free, so this is how measured ISR times (from
+isr_profile.c on the part) are made to delay the main loop and lower
+priority ISRs.  Higher priority interrupts are still taken while the time
+passes.
+
+Requires:
+- pcIsr_ is one of the names HostVectorStats reports
+
+Promises:
+- Returns true and sets the cost, or false if pcIsr_ isn't known
+
+*/
+bool HostSetIsrCycles(const char* pcIsr_, u16 u16Cycles_)
+{
+  for(u8 i = 0; i < HOST_VECTORS; i++)
+  {
+    if(strcmp(Host_astVectorStats[i].pcName, pcIsr_) == 0)
+    {
+      Host_au16IsrCycles[i] = u16Cycles_;
+      return true;
+    }
+  }
+
+  return false;
+
+} /* end HostSetIsrCycles() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn const HostVectorStatsType* HostVectorStats(u8* pu8Count_)
+
+@brief Returns the per-ISR call counts and sets *pu8Count_ to how many there are.
+
+*/
+const HostVectorStatsType* HostVectorStats(u8* pu8Count_)
+{
+  *pu8Count_ = HOST_VECTORS;
+  return Host_astVectorStats;
+
+} /* end HostVectorStats() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostNop(void)
+
+@brief One instruction cycle; pending interrupts are taken.  NOP() and __nop().
+
+*/
+void HostNop(void)
+{
+  HostAdvance(HostCycleTicks());
+
+} /* end HostNop() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostSleep(void)
+
+@brief SLEEP() in Idle mode: waits for an enabled interrupt flag.
+
+Like the part, an enabled flag wakes the core whether or not GIEH/GIEL let
+it vector; anything they do allow is taken before returning.
+
+Requires:
+- Some enabled source will eventually set its flag
+
+Promises:
+- Returns once an enabled flag is set, or straight after an idle hook that
+  returned true
+- Exits the program if nothing can ever wake the core
+
+*/
+void HostSleep(void)
+{
+  u64 u64Next;
+  u8 u8Intcon0;
+  bool bActed;
+
+  if( (Host_pfnIdleHook != NULL) && (Host_u8Level == HOST_LEVEL_MAIN) )
+  {
+    u8Intcon0 = INTCON0;
+    INTCON0bits.GIEL = 1;
+    bActed = Host_pfnIdleHook();
+    INTCON0 = u8Intcon0;
+
+    if(bActed)
+    {
+      return;
+    }
+  }
+
+  while(!HostWakePending())
+  {
+    if(Host_u64Now >= Host_u64Until)
+    {
+      longjmp(Host_jbStop, 1);
+    }
+
+    u64Next = HostNextEvent();
+    if(u64Next == 0)
+    {
+      fprintf(stderr, "host: SLEEP with no timer running and no interrupt pending at %llu ticks\n",
+              (unsigned long long)Host_u64Now);
+      exit(EXIT_FAILURE);
+    }
+
+    if(u64Next > Host_u64Until - Host_u64Now)
+    {
+      u64Next = Host_u64Until - Host_u64Now;
+    }
+
+    HostStep(u64Next);
+  }
+
+  HostInterruptPoint();
+
+} /* end HostSleep() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostSpiTransmit(u8 u8Byte_)
+
+@brief SPI1 exchange of one byte with the SD card model.
+
+Requires:
+- SPI1 set up by SPI_Init; SPI1CLK = 0 (Fosc) is assumed
+
+Promises:
+- Virtual time moves by 8 SCK periods: 16 * (SPI1BAUD + 1) Fosc periods
+- SPI1RXB holds the card's reply when it returns
+
+*/
+void HostSpiTransmit(u8 u8Byte_)
+{
+  HostAdvance( (HostCycleTicks() / 4) * 16 * ((u64)SPI1BAUD + 1) );
+  SPI1RXB = HostSdExchange(u8Byte_);
+
+} /* end HostSpiTransmit() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostDacWrite(u8 u8Value_)
+
+@brief DAC1DATL write: stores the value and tells the DAC listener.
+
+*/
+void HostDacWrite(u8 u8Value_)
+{
+  DAC1DATL = u8Value_;
+
+  if(Host_pfnDacListener != NULL)
+  {
+    Host_pfnDacListener(Host_u64Now, u8Value_);
+  }
+
+} /* end HostDacWrite() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostUartDma(const u8* pu8Source_, u16 u16Count_)
+
+@brief DMA1 block to U1TXB: sends u16Count_ bytes from pu8Source_.
+
+Requires:
+- UART1 on with the rate in U1BRG/BRGS; no block under way
+
+Promises:
+- Each byte goes to the UART listener stamped with the time its stop bit ends
+- DMA1SCNTIF is set and SIRQEN cleared when the last byte is out; the
+  transmit shift register reads busy (TXMTIF clear) until then
+
+*/
+void HostUartDma(const u8* pu8Source_, u16 u16Count_)
+{
+  /* 10 bits per byte; a bit is 4 (BRGS) or 16 Fosc periods per U1BRG count */
+  u64 u64ByteTicks = 10 * (U1CON0bits.BRGS ? 4 : 16) * ((u64)U1BRG + 1) * (HostCycleTicks() / 4);
+
+  for(u16 i = 0; i < u16Count_; i++)
+  {
+    if(Host_pfnUartListener != NULL)
+    {
+      Host_pfnUartListener(Host_u64Now + (i + 1) * u64ByteTicks, pu8Source_[i]);
+    }
+  }
+
+  DMAnCON0bits.SIRQEN = 1;
+  U1ERRIRbits.TXMTIF = 0;
+  Host_u64UartDone = Host_u64Now + ((u16Count_ != 0) ? u16Count_ : 1) * u64ByteTicks;
+
+} /* end HostUartDma() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostUartRxReady(void)
+
+@brief HAL_UART_RX_READY(): true if a byte queued by HostUartInput is waiting.
+
+*/
+bool HostUartRxReady(void)
+{
+  return Host_u16UartRxHead != Host_u16UartRxTail;
+
+} /* end HostUartRxReady() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 HostUartRead(void)
+
+@brief HAL_UART_READ(): pops the oldest received byte, 0 if there is none.
+
+*/
+u8 HostUartRead(void)
+{
+  u8 u8Byte;
+
+  if(!HostUartRxReady())
+  {
+    return 0;
+  }
+
+  u8Byte = Host_au8UartRx[Host_u16UartRxTail];
+  Host_u16UartRxTail = (u16)((Host_u16UartRxTail + 1) % HOST_UART_RX_SIZE);
+  return u8Byte;
+
+} /* end HostUartRead() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u64 HostCycleTicks(void)
+
+@brief Returns the virtual ticks in one instruction cycle (Fosc/4) at the OSCFRQ setting.
+
+*/
+static u64 HostCycleTicks(void)
+{
+  /* OSCFRQ 0 - 8: 1, 2, 4, 8, 12, 16, 32, 48, 64MHz.  12 and 48 are rounded. */
+  static const u16 au16CycleTicks[] = {256, 128, 64, 32, 21, 16, 8, 5, 4};
+  u8 u8Frq = OSCFRQ & 0x0F;
+
+  return (u8Frq < sizeof(au16CycleTicks) / sizeof(au16CycleTicks[0])) ? au16CycleTicks[u8Frq] : 4;
+
+} /* end HostCycleTicks() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u64 HostTimerPeriod(HostTimerType eTimer_)
+
+@brief Returns the virtual ticks per count of a timer, or 0 if it isn't counting.
+
+Only the Fosc/4 clock source is modelled; any other source leaves the timer
+stopped.  Timer0 is only modelled in 16-bit mode.
+
+*/
+static u64 HostTimerPeriod(HostTimerType eTimer_)
+{
+  u64 u64Cycle = HostCycleTicks();
+
+  switch(eTimer_)
+  {
+    case HOST_TMR0:
+      if( !T0CON0bits.EN || !T0CON0bits.MD16 || (T0CON1bits.CS != 2) )
+      {
+        return 0;
+      }
+      return u64Cycle << T0CON1bits.CKPS;
+
+    case HOST_TMR1:
+      return (T1CONbits.ON && (T1CLK == 0x01)) ? (u64Cycle << T1CONbits.CKPS) : 0;
+
+    case HOST_TMR3:
+      return (T3CONbits.ON && (T3CLK == 0x01)) ? (u64Cycle << T3CONbits.CKPS) : 0;
+
+    case HOST_TMR5:
+      return (T5CONbits.ON && (T5CLK == 0x01)) ? (u64Cycle << T5CONbits.CKPS) : 0;
+
+    case HOST_TMR2:
+      return (T2CONbits.ON && (T2CLKCON == 0x01)) ? (u64Cycle << T2CONbits.CKPS) : 0;
+
+    default:
+      return 0;
+  }
+
+} /* end HostTimerPeriod() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostTimerCountsToEvent(HostTimerType eTimer_)
+
+@brief Returns how many counts until the timer next sets its interrupt flag.
+
+*/
+static u32 HostTimerCountsToEvent(HostTimerType eTimer_)
+{
+  switch(eTimer_)
+  {
+    case HOST_TMR0:
+      return 0x10000 - (((u32)TMR0H << 8) | TMR0L);
+    case HOST_TMR1:
+      return 0x10000 - (((u32)TMR1H << 8) | TMR1L);
+    case HOST_TMR3:
+      return 0x10000 - (((u32)TMR3H << 8) | TMR3L);
+    case HOST_TMR5:
+      return 0x10000 - (((u32)TMR5H << 8) | TMR5L);
+    case HOST_TMR2:
+      /* The count after matching T2PR resets the timer; the postscaler
+       * then decides which resets set TMR2IF */
+      return ((u32)(u8)(T2PR - T2TMR) + 1) +
+             (u32)(T2CONbits.OUTPS - Host_u8Timer2Postscale) * ((u32)T2PR + 1);
+    default:
+      return 0;
+  }
+
+} /* end HostTimerCountsToEvent() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTimerCount(HostTimerType eTimer_, u32 u32Counts_)
+
+@brief Adds u32Counts_ to a timer, setting its flag if it overflows or resets.
+
+*/
+static void HostTimerCount(HostTimerType eTimer_, u32 u32Counts_)
+{
+  volatile u8* pu8Low;
+  volatile u8* pu8High;
+  volatile u8* pu8Pir;
+  u8 u8Mask;
+  u32 u32Value;
+  u32 u32ToReset;
+
+  switch(eTimer_)
+  {
+    case HOST_TMR0: pu8Low = &TMR0L; pu8High = &TMR0H; pu8Pir = &PIR3; u8Mask = _PIR3_TMR0IF_MASK; break;
+    case HOST_TMR1: pu8Low = &TMR1L; pu8High = &TMR1H; pu8Pir = &PIR3; u8Mask = _PIR3_TMR1IF_MASK; break;
+    case HOST_TMR3: pu8Low = &TMR3L; pu8High = &TMR3H; pu8Pir = &PIR5; u8Mask = _PIR5_TMR3IF_MASK; break;
+    case HOST_TMR5: pu8Low = &TMR5L; pu8High = &TMR5H; pu8Pir = &PIR8; u8Mask = _PIR8_TMR5IF_MASK; break;
+
+    case HOST_TMR2:
+      while(u32Counts_ != 0)
+      {
+        u32ToReset = (u32)(u8)(T2PR - T2TMR) + 1;
+        if(u32Counts_ < u32ToReset)
+        {
+          T2TMR += (u8)u32Counts_;
+          return;
+        }
+
+        u32Counts_ -= u32ToReset;
+        T2TMR = 0;
+        if(++Host_u8Timer2Postscale > T2CONbits.OUTPS)
+        {
+          Host_u8Timer2Postscale = 0;
+          PIR3bits.TMR2IF = 1;
+        }
+      }
+      return;
+
+    default:
+      return;
+  }
+
+  /* 16-bit timers */
+  u32Value = ((u32)*pu8High << 8) + *pu8Low + u32Counts_;
+  if(u32Value > 0xFFFF)
+  {
+    *pu8Pir |= u8Mask;
+  }
+  *pu8Low = (u8)u32Value;
+  *pu8High = (u8)(u32Value >> 8);
+
+} /* end HostTimerCount() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u64 HostNextEvent(void)
+
+@brief Returns the virtual ticks until the next timer flag or UART block end, or 0 if there is none.
+
+Also records each timer's period for the HostStep() that follows.
+
+*/
+static u64 HostNextEvent(void)
+{
+  u64 u64Next = 0;
+  u64 u64Period;
+  u64 u64Ticks;
+
+  for(u8 i = 0; i < HOST_TIMERS; i++)
+  {
+    u64Period = HostTimerPeriod((HostTimerType)i);
+    Host_au64TimerPeriod[i] = u64Period;
+    if(u64Period == 0)
+    {
+      continue;
+    }
+
+    u64Ticks = HostTimerCountsToEvent((HostTimerType)i) * u64Period;
+    u64Ticks = (u64Ticks > Host_au64TimerTicks[i]) ? (u64Ticks - Host_au64TimerTicks[i]) : 1;
+
+    if( (u64Next == 0) || (u64Ticks < u64Next) )
+    {
+      u64Next = u64Ticks;
+    }
+  }
+
+  if(Host_u64UartDone != 0)
+  {
+    u64Ticks = (Host_u64UartDone > Host_u64Now) ? (Host_u64UartDone - Host_u64Now) : 1;
+    if( (u64Next == 0) || (u64Ticks < u64Next) )
+    {
+      u64Next = u64Ticks;
+    }
+  }
+
+  return u64Next;
+
+} /* end HostNextEvent() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostStep(u64 u64Ticks_)
+
+@brief Moves virtual time on by u64Ticks_, counts every running timer and ends a UART block that is due.
+
+Requires:
+- HostNextEvent() was just called, with no firmware running since, so its
+  copy of the timer periods is current
+- u64Ticks_ is no more than HostNextEvent(), so each timer sets its flag
+  at most once
+
+*/
+static void HostStep(u64 u64Ticks_)
+{
+  u64 u64Period;
+
+  for(u8 i = 0; i < HOST_TIMERS; i++)
+  {
+    u64Period = Host_au64TimerPeriod[i];
+    if(u64Period == 0)
+    {
+      continue;
+    }
+
+    Host_au64TimerTicks[i] += u64Ticks_;
+    if(Host_au64TimerTicks[i] >= u64Period)
+    {
+      HostTimerCount((HostTimerType)i, (u32)(Host_au64TimerTicks[i] / u64Period));
+      Host_au64TimerTicks[i] %= u64Period;
+    }
+  }
+
+  Host_u64Now += u64Ticks_;
+  Host_u32StuckCount = 0;
+
+  if( (Host_u64UartDone != 0) && (Host_u64Now >= Host_u64UartDone) )
+  {
+    Host_u64UartDone = 0;
+    DMAnCON0bits.SIRQEN = 0;
+    U1ERRIRbits.TXMTIF = 1;
+    PIR2bits.DMA1SCNTIF = 1;
+  }
+
+} /* end HostStep() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostAdvanceTo(u64 u64Time_)
+
+@brief Runs virtual time up to u64Time_, stopping at every timer event to take interrupts.
+
+An ISR taken on the way may itself advance time (an SD read in SW_ISR);
+the loop works on absolute times so that is harmless.
+
+*/
+static void HostAdvanceTo(u64 u64Time_)
+{
+  u64 u64Step;
+  u64 u64Next;
+
+  while(Host_u64Now < u64Time_)
+  {
+    if(Host_u64Now >= Host_u64Until)
+    {
+      longjmp(Host_jbStop, 1);
+    }
+
+    u64Step = u64Time_ - Host_u64Now;
+    u64Next = HostNextEvent();
+    if( (u64Next != 0) && (u64Next < u64Step) )
+    {
+      u64Step = u64Next;
+    }
+
+    HostStep(u64Step);
+    HostInterruptPoint();
+  }
+
+} /* end HostAdvanceTo() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static bool HostWakePending(void)
+
+@brief Returns true if any known source has both its flag and enable set.
+
+*/
+static bool HostWakePending(void)
+{
+  for(u8 i = 0; i < HOST_VECTORS; i++)
+  {
+    if(*Host_astVectors[i].pu8Pir & *Host_astVectors[i].pu8Pie & Host_astVectors[i].u8Mask)
+    {
+      return true;
+    }
+  }
+
+  return false;
+
+} /* end HostWakePending() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostInterruptPoint(void)
+
+@brief Calls every ISR that may run now, highest priority first.
+
+*/
+static void HostInterruptPoint(void)
+{
+  const HostVectorType* pstVector;
+  s8 s8Chosen;
+  u8 u8ChosenLevel;
+  u8 u8Level;
+  u8 u8SavedLevel;
+
+  for(;;)
+  {
+    if(!INTCON0bits.GIEH)
+    {
+      return;
+    }
+
+    s8Chosen = -1;
+    u8ChosenLevel = HOST_LEVEL_MAIN;
+
+    for(u8 i = 0; i < HOST_VECTORS; i++)
+    {
+      pstVector = &Host_astVectors[i];
+      if( (*pstVector->pu8Pir & *pstVector->pu8Pie & pstVector->u8Mask) == 0 )
+      {
+        continue;
+      }
+
+      u8Level = HOST_LEVEL_HIGH;
+      if(INTCON0bits.IPEN && ((*pstVector->pu8Ipr & pstVector->u8Mask) == 0))
+      {
+        u8Level = HOST_LEVEL_LOW;
+        if(!INTCON0bits.GIEL)
+        {
+          continue;
+        }
+      }
+
+      if( (u8Level > Host_u8Level) && (u8Level > u8ChosenLevel) )
+      {
+        s8Chosen = (s8)i;
+        u8ChosenLevel = u8Level;
+      }
+    }
+
+    if(s8Chosen < 0)
+    {
+      return;
+    }
+
+    if(++Host_u32StuckCount > HOST_STUCK_LIMIT)
+    {
+      fprintf(stderr, "host: %s keeps being called without its flag clearing\n",
+              Host_astVectorStats[s8Chosen].pcName);
+      exit(EXIT_FAILURE);
+    }
+
+    u8SavedLevel = Host_u8Level;
+    Host_u8Level = u8ChosenLevel;
+    Host_astVectorStats[s8Chosen].u32Calls++;
+    Host_astVectors[s8Chosen].pfnIsr();
+    if(Host_au16IsrCycles[s8Chosen] != 0)
+    {
+      HostAdvanceTo(Host_u64Now + Host_au16IsrCycles[s8Chosen] * HostCycleTicks());
+    }
+    Host_u8Level = u8SavedLevel;
+  }
+
+} /* end HostInterruptPoint() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
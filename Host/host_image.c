@@ -0,0 +1,530 @@
+/*!*********************************************************************************************************************
+@file host_image.c
+@brief Builds an SD card image of tracks from WAV files, 8-bit PCM or IMA-ADPCM.
+
+  heart_rate_music_image [-n sectors] -o card.img [-f pcm8|adpcm] file.wav ...
+
+-n  card size in sectors, default 4096
+-o  the image to write
+-f  format of the files after it, default pcm8
+file.wav  mono 8 or 16-bit PCM at any rate the firmware can play
+
+Tracks are laid out one after another from sector 1, stepping over the
+flight recorder's TRACE_SD_SECTORS at TRACE_SD_SECTOR.  For each one the
+AudioStart arguments are printed as heart_rate_music_host -p takes them:
+
+  tone.wav  adpcm  8000Hz  16000 samples  16 sectors  -p 1:16:125:adpcm
+
+pcm8 is one unsigned byte per sample, what the DAC takes.  adpcm is the
+block format in adpcm.h: ADPCM_BLOCK_SAMPLES per sector from the standard
+IMA encoder, with the last block padded with the last sample.  The first
+block starts at whichever step index suits it best, rather than ramping up
+from the smallest step.  Every block
+is decoded again with the firmware's AdpcmDecode and must match the
+encoder's own reconstruction exactly; the error against the source is
+reported as the worst 8-bit step and an SNR.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostImage_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_IMAGE_SECTOR_SIZE    512
+#define HOST_IMAGE_SECTORS        (u32)4096    /* Default card size, as heart_rate_music_host's */
+
+/* The IMA-ADPCM quantizer steps; adpcm.c only keeps what the decoder needs */
+static const u16 HostImage_au16Step[ADPCM_STEP_INDEX_MAX + 1] =
+{
+      7,     8,     9,    10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,    31,
+     34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,   107,   118,   130,   143,
+    157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,   544,   598,   658,
+    724,   796,   876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,
+   3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const s8 HostImage_as8IndexStep[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+static u8*  HostImage_pu8Card;
+static u32  HostImage_u32Sectors = HOST_IMAGE_SECTORS;
+static u32  HostImage_u32Next = 1;             /* First free sector */
+
+/* Error against the source of the track being written */
+static u8     HostImage_u8MaxError;
+static double HostImage_dSignal;
+static double HostImage_dNoise;
+
+static bool HostImageTrack(const char* pcPath_, u8 u8Format_);
+static u32  HostImageAllocate(u32 u32Count_);
+static void HostImagePcm8(const s16* ps16Samples_, u32 u32Samples_, u8* pu8Track_);
+static bool HostImageAdpcm(const s16* ps16Samples_, u32 u32Samples_, u8* pu8Track_);
+static double HostImageBlock(const s16* ps16Samples_, u32 u32Samples_, u32 u32Block_, u8* pu8StepIndex_,
+                             u8* pu8Block_, u8* pu8Expected_);
+static u8   HostImageEncode(s32* ps32Predictor_, u8* pu8StepIndex_, s16 s16Sample_);
+static u8   HostImageByte(s32 s32Sample_);
+static void HostImageMeasure(s16 s16Source_, u8 u8Output_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn int main(int argc, char* argv[])
+
+@brief Writes each file as a track, then the whole card to the image.
+
+*/
+int main(int argc, char* argv[])
+{
+  const char* pcImage = NULL;
+  u8 u8Format = AUDIO_FORMAT_PCM8;
+  u8 u8Tracks = 0;
+  bool bUsage = false;
+  FILE* pFile;
+
+  /* The card size first, so the tracks can be placed as they are read */
+  for(int iOption = 1; iOption < argc; iOption++)
+  {
+    if( (strcmp(argv[iOption], "-n") == 0) && (iOption + 1 < argc) )
+    {
+      HostImage_u32Sectors = (u32)strtoul(argv[++iOption], NULL, 0);
+    }
+    else if( (strcmp(argv[iOption], "-o") == 0) && (iOption + 1 < argc) )
+    {
+      pcImage = argv[++iOption];
+    }
+    else if( (strcmp(argv[iOption], "-f") == 0) && (iOption + 1 < argc) )
+    {
+      iOption++;
+    }
+    else if(argv[iOption][0] == '-')
+    {
+      bUsage = true;
+    }
+  }
+
+  if( bUsage || (pcImage == NULL) || (HostImage_u32Sectors < 2) )
+  {
+    fprintf(stderr, "usage: %s [-n sectors] -o card.img [-f pcm8|adpcm] file.wav ...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  HostImage_pu8Card = calloc(HostImage_u32Sectors, HOST_IMAGE_SECTOR_SIZE);
+  if(HostImage_pu8Card == NULL)
+  {
+    fprintf(stderr, "%s: out of memory for %u sectors\n", argv[0], HostImage_u32Sectors);
+    return EXIT_FAILURE;
+  }
+
+  for(int iOption = 1; iOption < argc; iOption++)
+  {
+    if( (strcmp(argv[iOption], "-n") == 0) || (strcmp(argv[iOption], "-o") == 0) )
+    {
+      iOption++;
+    }
+    else if(strcmp(argv[iOption], "-f") == 0)
+    {
+      iOption++;
+      if(strcmp(argv[iOption], "pcm8") == 0)
+      {
+        u8Format = AUDIO_FORMAT_PCM8;
+      }
+      else if(strcmp(argv[iOption], "adpcm") == 0)
+      {
+        u8Format = AUDIO_FORMAT_ADPCM4;
+      }
+      else
+      {
+        fprintf(stderr, "%s: unknown format %s\n", argv[0], argv[iOption]);
+        return EXIT_FAILURE;
+      }
+    }
+    else
+    {
+      if(!HostImageTrack(argv[iOption], u8Format))
+      {
+        return EXIT_FAILURE;
+      }
+      u8Tracks++;
+    }
+  }
+
+  pFile = fopen(pcImage, "wb");
+  if( (pFile == NULL) ||
+      (fwrite(HostImage_pu8Card, HOST_IMAGE_SECTOR_SIZE, HostImage_u32Sectors, pFile) != HostImage_u32Sectors) ||
+      (fclose(pFile) != 0) )
+  {
+    fprintf(stderr, "%s: can't write %s\n", argv[0], pcImage);
+    return EXIT_FAILURE;
+  }
+
+  fprintf(stderr, "%u tracks, %u of %u sectors used\n", u8Tracks, HostImage_u32Next, HostImage_u32Sectors);
+  free(HostImage_pu8Card);
+
+  return EXIT_SUCCESS;
+
+} /* end main() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static bool HostImageTrack(const char* pcPath_, u8 u8Format_)
+
+@brief Reads one WAV, writes it to the next free sectors and prints its -p argument.
+
+*/
+static bool HostImageTrack(const char* pcPath_, u8 u8Format_)
+{
+  s16* ps16Samples;
+  u32 u32Rate;
+  u32 u32Samples;
+  u32 u32Count;
+  u32 u32First;
+  u16 u16PeriodUs;
+  bool bOk;
+
+  ps16Samples = HostWavLoad(pcPath_, &u32Rate, &u32Samples);
+  if( (ps16Samples == NULL) || (u32Samples == 0) )
+  {
+    fprintf(stderr, "%s: not a mono 8 or 16-bit PCM WAV with samples\n", pcPath_);
+    free(ps16Samples);
+    return false;
+  }
+
+  /* AudioStart takes the sample period in whole microseconds */
+  if( (u32Rate < 16) || (u32Rate > 1000000) )
+  {
+    fprintf(stderr, "%s: no sample period in microseconds for %uHz\n", pcPath_, u32Rate);
+    free(ps16Samples);
+    return false;
+  }
+  u16PeriodUs = (u16)lround(1000000.0 / u32Rate);
+
+  if(u8Format_ == AUDIO_FORMAT_ADPCM4)
+  {
+    u32Count = (u32Samples + ADPCM_BLOCK_SAMPLES - 1) / ADPCM_BLOCK_SAMPLES;
+  }
+  else
+  {
+    u32Count = (u32Samples + HOST_IMAGE_SECTOR_SIZE - 1) / HOST_IMAGE_SECTOR_SIZE;
+  }
+
+  u32First = HostImageAllocate(u32Count);
+  if(u32First == 0)
+  {
+    fprintf(stderr, "%s: %u sectors don't fit on the card after sector %u\n", pcPath_, u32Count, HostImage_u32Next);
+    free(ps16Samples);
+    return false;
+  }
+
+  HostImage_u8MaxError = 0;
+  HostImage_dSignal = 0.0;
+  HostImage_dNoise = 0.0;
+
+  bOk = true;
+  if(u8Format_ == AUDIO_FORMAT_ADPCM4)
+  {
+    bOk = HostImageAdpcm(ps16Samples, u32Samples, &HostImage_pu8Card[u32First * HOST_IMAGE_SECTOR_SIZE]);
+  }
+  else
+  {
+    HostImagePcm8(ps16Samples, u32Samples, &HostImage_pu8Card[u32First * HOST_IMAGE_SECTOR_SIZE]);
+  }
+  free(ps16Samples);
+
+  if(!bOk)
+  {
+    fprintf(stderr, "%s: AdpcmDecode disagrees with the encoder\n", pcPath_);
+    return false;
+  }
+
+  printf("%s  %s  %uHz  %u samples  %u sectors  max error %u  snr %.1f dB  -p %u:%u:%u%s\n",
+         pcPath_, (u8Format_ == AUDIO_FORMAT_ADPCM4) ? "adpcm" : "pcm8", u32Rate, u32Samples, u32Count,
+         HostImage_u8MaxError,
+         (HostImage_dNoise > 0.0) ? 10.0 * log10(HostImage_dSignal / HostImage_dNoise) : INFINITY,
+         u32First, u32Count, u16PeriodUs, (u8Format_ == AUDIO_FORMAT_ADPCM4) ? ":adpcm" : "");
+
+  return true;
+
+} /* end HostImageTrack() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostImageAllocate(u32 u32Count_)
+
+@brief Returns the first of u32Count_ free sectors clear of the trace, or 0 if the card is full.
+
+*/
+static u32 HostImageAllocate(u32 u32Count_)
+{
+  u32 u32First = HostImage_u32Next;
+
+  if( (u32First < TRACE_SD_SECTOR + TRACE_SD_SECTORS) && (u32First + u32Count_ > TRACE_SD_SECTOR) )
+  {
+    u32First = TRACE_SD_SECTOR + TRACE_SD_SECTORS;
+  }
+
+  if(u32First + u32Count_ > HostImage_u32Sectors)
+  {
+    return 0;
+  }
+
+  HostImage_u32Next = u32First + u32Count_;
+  return u32First;
+
+} /* end HostImageAllocate() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostImagePcm8(const s16* ps16Samples_, u32 u32Samples_, u8* pu8Track_)
+
+@brief Writes the samples as unsigned bytes; the rest of the last sector is the last sample.
+
+*/
+static void HostImagePcm8(const s16* ps16Samples_, u32 u32Samples_, u8* pu8Track_)
+{
+  u32 u32Sectors = (u32Samples_ + HOST_IMAGE_SECTOR_SIZE - 1) / HOST_IMAGE_SECTOR_SIZE;
+
+  for(u32 i = 0; i < u32Sectors * HOST_IMAGE_SECTOR_SIZE; i++)
+  {
+    pu8Track_[i] = HostImageByte(ps16Samples_[(i < u32Samples_) ? i : u32Samples_ - 1]);
+    if(i < u32Samples_)
+    {
+      HostImageMeasure(ps16Samples_[i], pu8Track_[i]);
+    }
+  }
+
+} /* end HostImagePcm8() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static bool HostImageAdpcm(const s16* ps16Samples_, u32 u32Samples_, u8* pu8Track_)
+
+@brief Encodes the samples into ADPCM blocks and checks each one with the firmware decoder.
+
+*/
+static bool HostImageAdpcm(const s16* ps16Samples_, u32 u32Samples_, u8* pu8Track_)
+{
+  u32 u32Blocks = (u32Samples_ + ADPCM_BLOCK_SAMPLES - 1) / ADPCM_BLOCK_SAMPLES;
+  u8 au8Expected[ADPCM_BLOCK_SAMPLES];
+  u8 au8Decoded[ADPCM_BLOCK_SAMPLES];
+  AdpcmStateType stState;
+  u8 u8StepIndex;
+  u8 u8BestIndex = 0;
+  double dError;
+  double dBestError = INFINITY;
+  u8* pu8Block;
+  u32 u32Sample;
+
+  /* Any step index will do for the first block; the rest carry on from the one before */
+  for(u8 u8Start = 0; u8Start <= ADPCM_STEP_INDEX_MAX; u8Start++)
+  {
+    u8StepIndex = u8Start;
+    dError = HostImageBlock(ps16Samples_, u32Samples_, 0, &u8StepIndex, pu8Track_, au8Expected);
+    if(dError < dBestError)
+    {
+      dBestError = dError;
+      u8BestIndex = u8Start;
+    }
+  }
+
+  u8StepIndex = u8BestIndex;
+  for(u32 u32Block = 0; u32Block < u32Blocks; u32Block++)
+  {
+    pu8Block = &pu8Track_[u32Block * ADPCM_BLOCK_SIZE];
+    (void)HostImageBlock(ps16Samples_, u32Samples_, u32Block, &u8StepIndex, pu8Block, au8Expected);
+
+    for(u16 i = 0; i < ADPCM_BLOCK_SAMPLES; i++)
+    {
+      u32Sample = u32Block * ADPCM_BLOCK_SAMPLES + i;
+      if(u32Sample < u32Samples_)
+      {
+        HostImageMeasure(ps16Samples_[u32Sample], au8Expected[i]);
+      }
+    }
+
+    /* Decoded in two pieces, as AudioDecode picks up mid-block */
+    if(!AdpcmBlockBegin(&stState, pu8Block))
+    {
+      return false;
+    }
+    AdpcmDecode(&stState, pu8Block, 0, au8Decoded, AUDIO_DECODE_CHUNK);
+    AdpcmDecode(&stState, pu8Block, AUDIO_DECODE_CHUNK, &au8Decoded[AUDIO_DECODE_CHUNK],
+                ADPCM_BLOCK_SAMPLES - AUDIO_DECODE_CHUNK);
+
+    if(memcmp(au8Decoded, au8Expected, ADPCM_BLOCK_SAMPLES) != 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+
+} /* end HostImageAdpcm() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static double HostImageBlock(const s16* ps16Samples_, u32 u32Samples_, u32 u32Block_, u8* pu8StepIndex_,
+                                 u8* pu8Block_, u8* pu8Expected_)
+
+@brief Encodes one block from *pu8StepIndex_ and returns its squared error.
+
+Each block starts from the sample it holds in its header, as IMA WAV
+encoders do.  *pu8StepIndex_ is left where the block ends, pu8Expected_ gets
+the ADPCM_BLOCK_SAMPLES DAC values the decoder should produce, and the error
+is theirs against the source, padding included.
+
+*/
+static double HostImageBlock(const s16* ps16Samples_, u32 u32Samples_, u32 u32Block_, u8* pu8StepIndex_,
+                             u8* pu8Block_, u8* pu8Expected_)
+{
+  s32 s32Predictor = 0;
+  u32 u32Sample;
+  s16 s16Sample;
+  s32 s32Noise;
+  u8 u8Code;
+  double dError = 0.0;
+
+  memset(pu8Block_, 0, ADPCM_BLOCK_SIZE);
+  for(u16 i = 0; i < ADPCM_BLOCK_SAMPLES; i++)
+  {
+    u32Sample = u32Block_ * ADPCM_BLOCK_SAMPLES + i;
+    s16Sample = ps16Samples_[(u32Sample < u32Samples_) ? u32Sample : u32Samples_ - 1];
+
+    if(i == 0)
+    {
+      s32Predictor = s16Sample;
+      pu8Block_[0] = (u8)s16Sample;
+      pu8Block_[1] = (u8)((u16)s16Sample >> 8);
+      pu8Block_[2] = *pu8StepIndex_;
+    }
+    else
+    {
+      /* Code i - 1, low nibble first */
+      u8Code = HostImageEncode(&s32Predictor, pu8StepIndex_, s16Sample);
+      pu8Block_[ADPCM_HEADER_SIZE + (i - 1) / 2] |= (i & 1) ? u8Code : (u8)(u8Code << 4);
+    }
+
+    /* The DAC gets the high byte of the offset binary predictor */
+    pu8Expected_[i] = (u8)((s32Predictor + 32768) >> 8);
+    s32Noise = ((s32)pu8Expected_[i] - 128) * 256 - s16Sample;
+    dError += (double)s32Noise * s32Noise;
+  }
+
+  return dError;
+
+} /* end HostImageBlock() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u8 HostImageEncode(s32* ps32Predictor_, u8* pu8StepIndex_, s16 s16Sample_)
+
+@brief Returns the 4-bit code for one sample and moves the predictor and step index on.
+
+The predictor moves by exactly what the decoder will add for the code, so
+the two stay in step.
+
+*/
+static u8 HostImageEncode(s32* ps32Predictor_, u8* pu8StepIndex_, s16 s16Sample_)
+{
+  s32 s32Difference = s16Sample_ - *ps32Predictor_;
+  s32 s32Step = HostImage_au16Step[*pu8StepIndex_];
+  s32 s32Change = s32Step >> 3;
+  s8 s8Index;
+  u8 u8Code = 0;
+
+  if(s32Difference < 0)
+  {
+    u8Code = 8;
+    s32Difference = -s32Difference;
+  }
+
+  for(u8 u8Bit = 4; u8Bit != 0; u8Bit >>= 1)
+  {
+    if(s32Difference >= s32Step)
+    {
+      u8Code |= u8Bit;
+      s32Difference -= s32Step;
+      s32Change += s32Step;
+    }
+    s32Step >>= 1;
+  }
+
+  *ps32Predictor_ += (u8Code & 8) ? -s32Change : s32Change;
+  if(*ps32Predictor_ > 32767)
+  {
+    *ps32Predictor_ = 32767;
+  }
+  else if(*ps32Predictor_ < -32768)
+  {
+    *ps32Predictor_ = -32768;
+  }
+
+  s8Index = (s8)(*pu8StepIndex_ + HostImage_as8IndexStep[u8Code & 7]);
+  if(s8Index < 0)
+  {
+    s8Index = 0;
+  }
+  else if(s8Index > ADPCM_STEP_INDEX_MAX)
+  {
+    s8Index = ADPCM_STEP_INDEX_MAX;
+  }
+  *pu8StepIndex_ = (u8)s8Index;
+
+  return u8Code;
+
+} /* end HostImageEncode() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u8 HostImageByte(s32 s32Sample_)
+
+@brief Rounds a signed 16-bit sample to the DAC's unsigned 8 bits.
+
+*/
+static u8 HostImageByte(s32 s32Sample_)
+{
+  s32Sample_ = (s32Sample_ + 32768 + 128) >> 8;
+
+  return (u8)((s32Sample_ > 255) ? 255 : s32Sample_);
+
+} /* end HostImageByte() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostImageMeasure(s16 s16Source_, u8 u8Output_)
+
+@brief Adds one output sample's error against its source to the track's figures.
+
+The worst error is in DAC steps from the source rounded to 8 bits, so a
+lossless 8-bit track reports 0.
+
+*/
+static void HostImageMeasure(s16 s16Source_, u8 u8Output_)
+{
+  s32 s32Noise = ((s32)u8Output_ - 128) * 256 - s16Source_;
+  u8 u8Error = (u8)abs((s32)u8Output_ - (s32)HostImageByte(s16Source_));
+
+  if(u8Error > HostImage_u8MaxError)
+  {
+    HostImage_u8MaxError = u8Error;
+  }
+  HostImage_dSignal += (double)s16Source_ * s16Source_;
+  HostImage_dNoise += (double)s32Noise * s32Noise;
+
+} /* end HostImageMeasure() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,390 @@
+/*!*********************************************************************************************************************
+@file host_main.c
+@brief Runs the firmware on the host for a stretch of virtual time and reports on it.
+
+  heart_rate_music_host [-t seconds] [-i image] [-p first:count:period_us[:adpcm]]
+                        [-w out.wav] [-g golden.wav] [-e tolerance] [-r rate]
+                        [-u uart.out] [-k seconds:text] [-s card.img]
+
+-t  virtual time to run, default 2 seconds
+-i  SD card image; without one the card is 4096 sectors holding an 8kHz
+    440Hz test tone from sector 1
+-p  calls AudioStart(first, count, period_us) from the main loop once the
+    firmware is up, e.g. -p 1:64:125; with :adpcm the sectors are
+    IMA-ADPCM (AUDIO_FORMAT_ADPCM4), as heart_rate_music_image writes them
+-w  renders every DAC write to a WAV file (see host_wav.c)
+-g  compares the rendered output with a golden WAV; the exit status is
+    failure if the rate or length differ or any sample is off by more
+    than the -e tolerance (default 0, bit-exact)
+-r  nominal rate of the WAV and the jitter figures; defaults to
+    1000000 / period_us from -p, else 8000Hz
+-u  writes everything the firmware sends on UART1 to a file, - for stdout
+-k  sends text to the firmware's UART1 receiver at a virtual time, e.g.
+    -k 1.5:p asks a REGION_PROFILE build for its table; may be repeated
+-s  saves the SD card image at the end, e.g. for host_trace.c to read the
+    flight recorder trace from
+
+DAC jitter and dropout figures are always reported.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+***********************************************************************************************************************/
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern volatile u32 G_u32SystemTime1ms;                   /*!< @brief From main.c */
+extern volatile u8  G_u8SystemIdlePercent;                /*!< @brief From encm369_pic18.c */
+extern volatile u32 G_u32AudioUnderruns;                  /*!< @brief From audio.c */
+extern u16 G_u16SDInitTimeMs;                             /*!< @brief From sd.c */
+extern u32 G_u32SDCrcErrors;                              /*!< @brief From sd.c */
+extern LoopStatsType G_stLoopStats;                       /*!< @brief From loop_stats.c */
+extern u32 G_u32UartDropped;                              /*!< @brief From uart.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostMain_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_MAIN_DEFAULT_SECTORS (u32)4096
+#define HOST_MAIN_TONE_RATE       8000.0
+#define HOST_MAIN_TONE_HZ         440.0
+#define HOST_MAIN_INPUTS          (u8)8
+
+static bool HostMain_bPlayRequested;
+static u32  HostMain_u32PlayFirst;
+static u32  HostMain_u32PlayCount;
+static u16  HostMain_u16PlayPeriodUs;
+static u8   HostMain_u8PlayFormat;
+static u32  HostMain_u32DacWrites;
+static FILE* HostMain_pUartFile;
+static u32  HostMain_u32UartBytes;
+
+static u8   HostMain_u8Inputs;
+static u64  HostMain_au64InputTime[HOST_MAIN_INPUTS];
+static const char* HostMain_apcInputText[HOST_MAIN_INPUTS];
+
+static bool HostMainIdle(void);
+static void HostMainDac(u64 u64Time_, u8 u8Value_);
+static void HostMainUart(u64 u64Time_, u8 u8Byte_);
+static void HostMainTone(void);
+static void HostMainReport(double dSeconds_, double dWallSeconds_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+  double dSeconds = 2.0;
+  const char* pcImage = NULL;
+  const char* pcWav = NULL;
+  const char* pcGolden = NULL;
+  const char* pcUart = NULL;
+  const char* pcSave = NULL;
+  const char* pcText;
+  unsigned uTolerance = 0;
+  u32 u32Rate = 0;
+  HostWavCompareType stCompare;
+  bool bPass = true;
+  clock_t stStart;
+  int iOption;
+  int iFields;
+  char acFormat[8];
+
+  for(iOption = 1; iOption < argc; iOption++)
+  {
+    if( (strcmp(argv[iOption], "-t") == 0) && (iOption + 1 < argc) )
+    {
+      dSeconds = atof(argv[++iOption]);
+    }
+    else if( (strcmp(argv[iOption], "-i") == 0) && (iOption + 1 < argc) )
+    {
+      pcImage = argv[++iOption];
+    }
+    else if( (strcmp(argv[iOption], "-p") == 0) && (iOption + 1 < argc) &&
+             ((iFields = sscanf(argv[++iOption], "%u:%u:%hu:%7s", &HostMain_u32PlayFirst,
+                                &HostMain_u32PlayCount, &HostMain_u16PlayPeriodUs, acFormat)) >= 3) &&
+             ((iFields == 3) || (strcmp(acFormat, "adpcm") == 0)) )
+    {
+      HostMain_u8PlayFormat = (iFields == 3) ? AUDIO_FORMAT_PCM8 : AUDIO_FORMAT_ADPCM4;
+      HostMain_bPlayRequested = true;
+    }
+    else if( (strcmp(argv[iOption], "-w") == 0) && (iOption + 1 < argc) )
+    {
+      pcWav = argv[++iOption];
+    }
+    else if( (strcmp(argv[iOption], "-g") == 0) && (iOption + 1 < argc) )
+    {
+      pcGolden = argv[++iOption];
+    }
+    else if( (strcmp(argv[iOption], "-e") == 0) && (iOption + 1 < argc) &&
+             (sscanf(argv[++iOption], "%u", &uTolerance) == 1) && (uTolerance <= 0xFF) )
+    {
+    }
+    else if( (strcmp(argv[iOption], "-r") == 0) && (iOption + 1 < argc) )
+    {
+      u32Rate = (u32)strtoul(argv[++iOption], NULL, 0);
+    }
+    else if( (strcmp(argv[iOption], "-u") == 0) && (iOption + 1 < argc) )
+    {
+      pcUart = argv[++iOption];
+    }
+    else if( (strcmp(argv[iOption], "-k") == 0) && (iOption + 1 < argc) &&
+             (HostMain_u8Inputs < HOST_MAIN_INPUTS) && ((pcText = strchr(argv[iOption + 1], ':')) != NULL) )
+    {
+      HostMain_au64InputTime[HostMain_u8Inputs] = (u64)(atof(argv[++iOption]) * HOST_TICKS_PER_S);
+      HostMain_apcInputText[HostMain_u8Inputs] = pcText + 1;
+      HostMain_u8Inputs++;
+    }
+    else if( (strcmp(argv[iOption], "-s") == 0) && (iOption + 1 < argc) )
+    {
+      pcSave = argv[++iOption];
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [-t seconds] [-i image] [-p first:count:period_us[:adpcm]]\n"
+                      "       [-w out.wav] [-g golden.wav] [-e tolerance] [-r rate]\n"
+                      "       [-u uart.out] [-k seconds:text] [-s card.img]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(u32Rate == 0)
+  {
+    u32Rate = (HostMain_bPlayRequested && (HostMain_u16PlayPeriodUs != 0)) ?
+              (1000000u / HostMain_u16PlayPeriodUs) : 8000u;
+  }
+
+  if(!HostWavBegin(u32Rate))
+  {
+    fprintf(stderr, "%s: can't capture at %u Hz\n", argv[0], u32Rate);
+    return EXIT_FAILURE;
+  }
+
+  HostReset();
+
+  if(pcImage != NULL)
+  {
+    if(!HostSdLoad(pcImage))
+    {
+      fprintf(stderr, "%s: can't load %s\n", argv[0], pcImage);
+      return EXIT_FAILURE;
+    }
+  }
+  else
+  {
+    HostMainTone();
+  }
+
+  if(pcUart != NULL)
+  {
+    HostMain_pUartFile = (strcmp(pcUart, "-") == 0) ? stdout : fopen(pcUart, "wb");
+    if(HostMain_pUartFile == NULL)
+    {
+      fprintf(stderr, "%s: can't write %s\n", argv[0], pcUart);
+      return EXIT_FAILURE;
+    }
+  }
+
+  HostSetIdleHook(HostMainIdle);
+  HostSetDacListener(HostMainDac);
+  HostSetUartListener(HostMainUart);
+
+  stStart = clock();
+  if(!HostRun((u64)(dSeconds * HOST_TICKS_PER_S)))
+  {
+    fprintf(stderr, "%s: firmware main() returned\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  HostWavEnd(HostNow());
+  if( (HostMain_pUartFile != NULL) && (HostMain_pUartFile != stdout) )
+  {
+    fclose(HostMain_pUartFile);
+  }
+  HostMainReport(dSeconds, (double)(clock() - stStart) / CLOCKS_PER_SEC);
+
+  if( (pcWav != NULL) && !HostWavSave(pcWav) )
+  {
+    fprintf(stderr, "%s: can't write %s\n", argv[0], pcWav);
+    bPass = false;
+  }
+
+  if( (pcSave != NULL) && !HostSdSave(pcSave) )
+  {
+    fprintf(stderr, "%s: can't write %s\n", argv[0], pcSave);
+    bPass = false;
+  }
+
+  if(pcGolden != NULL)
+  {
+    bPass = HostWavCompare(pcGolden, (u8)uTolerance, &stCompare) && bPass;
+    if(!stCompare.bReadable)
+    {
+      printf("golden           %s is not a mono 8-bit PCM WAV\n", pcGolden);
+    }
+    else
+    {
+      printf("golden           %u Hz %u samples vs %u Hz %u samples, %u differ",
+             stCompare.u32GoldenRate, stCompare.u32GoldenSamples, HostWavStats()->u32Rate,
+             stCompare.u32Samples, stCompare.u32Differences);
+      if(stCompare.u32Differences != 0)
+      {
+        printf(" from sample %u, max error %u", stCompare.u32FirstDifference, stCompare.u8MaxError);
+      }
+      printf(": %s\n", bPass ? "PASS" : "FAIL");
+    }
+  }
+
+  return bPass ? EXIT_SUCCESS : EXIT_FAILURE;
+
+} /* end main() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static bool HostMainIdle(void)
+
+@brief Idle hook: sends -k input that is due and starts playback once if -p was given.
+
+*/
+static bool HostMainIdle(void)
+{
+  for(u8 i = 0; i < HostMain_u8Inputs; i++)
+  {
+    if( (HostMain_apcInputText[i] != NULL) && (HostNow() >= HostMain_au64InputTime[i]) )
+    {
+      HostUartInput((const u8*)HostMain_apcInputText[i], (u16)strlen(HostMain_apcInputText[i]));
+      HostMain_apcInputText[i] = NULL;
+    }
+  }
+
+  if(!HostMain_bPlayRequested)
+  {
+    return false;
+  }
+
+  HostMain_bPlayRequested = false;
+  if(!AudioStart(HostMain_u32PlayFirst, HostMain_u32PlayCount, HostMain_u16PlayPeriodUs, HostMain_u8PlayFormat))
+  {
+    fprintf(stderr, "AudioStart(%u, %u, %u) failed\n", HostMain_u32PlayFirst,
+            HostMain_u32PlayCount, HostMain_u16PlayPeriodUs);
+  }
+
+  return true;
+
+} /* end HostMainIdle() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostMainDac(u64 u64Time_, u8 u8Value_)
+
+@brief DAC listener: counts writes and passes them to the capture.
+
+Only TMR1_ISR writes while Timer1 runs, so that marks the sample writes.
+
+*/
+static void HostMainDac(u64 u64Time_, u8 u8Value_)
+{
+  HostMain_u32DacWrites++;
+  HostWavDac(u64Time_, u8Value_, T1CONbits.ON);
+
+} /* end HostMainDac() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostMainUart(u64 u64Time_, u8 u8Byte_)
+
+@brief UART listener: counts bytes and writes them to the -u file.
+
+*/
+static void HostMainUart(u64 u64Time_, u8 u8Byte_)
+{
+  (void)u64Time_;
+
+  HostMain_u32UartBytes++;
+  if(HostMain_pUartFile != NULL)
+  {
+    fputc(u8Byte_, HostMain_pUartFile);
+  }
+
+} /* end HostMainUart() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostMainTone(void)
+
+@brief Default card: 8-bit unsigned 440Hz tone at 8kHz in every sector but 0.
+
+*/
+static void HostMainTone(void)
+{
+  u32 u32Sample = 0;
+  u8* pu8Sector;
+
+  HostSdCreate(HOST_MAIN_DEFAULT_SECTORS);
+
+  for(u32 u32Sector = 1; u32Sector < HOST_MAIN_DEFAULT_SECTORS; u32Sector++)
+  {
+    pu8Sector = HostSdSector(u32Sector);
+    for(u16 i = 0; i < HOST_SD_SECTOR_SIZE; i++, u32Sample++)
+    {
+      pu8Sector[i] = (u8)lround(128.0 + 100.0 * sin(2.0 * M_PI * HOST_MAIN_TONE_HZ * u32Sample / HOST_MAIN_TONE_RATE));
+    }
+  }
+
+} /* end HostMainTone() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostMainReport(double dSeconds_, double dWallSeconds_)
+
+@brief Prints what the firmware did during the run.
+
+*/
+static void HostMainReport(double dSeconds_, double dWallSeconds_)
+{
+  const HostVectorStatsType* pstVectors;
+  const HostSdStatsType* pstSd = HostSdStats();
+  const HostWavStatsType* pstWav = HostWavStats();
+  u8 u8Vectors;
+
+  printf("virtual time     %.3f s in %.3f s host time\n", dSeconds_, dWallSeconds_);
+  printf("system time      %u ms\n", G_u32SystemTime1ms);
+  printf("sd init          %u ms\n", G_u16SDInitTimeMs);
+  printf("sd               %u commands, %u sectors read, %u written, %u errors, %u crc errors\n",
+         pstSd->u32Commands, pstSd->u32SectorsRead, pstSd->u32SectorsWritten, pstSd->u32Errors,
+         G_u32SDCrcErrors);
+  printf("audio            %u dac writes, %u underruns\n", HostMain_u32DacWrites, G_u32AudioUnderruns);
+  printf("uart             %u bytes sent, %u messages dropped\n", HostMain_u32UartBytes, G_u32UartDropped);
+  printf("dac timing       %u Hz nominal, mean period %.3f us, jitter %.3f us rms %.3f us max\n",
+         pstWav->u32Rate, pstWav->dMeanPeriodTicks / HOST_TICKS_PER_US,
+         pstWav->dRmsJitterTicks / HOST_TICKS_PER_US, (double)pstWav->u64MaxJitterTicks / HOST_TICKS_PER_US);
+  printf("dac gaps         %u dropouts missing %u samples, %u pauses, %u early writes, %u samples rendered\n",
+         pstWav->u32Dropouts, pstWav->u32MissedSamples, pstWav->u32Pauses, pstWav->u32Early,
+         pstWav->u32Samples);
+  printf("loop             %u passes, %u overruns, busy %u%%, max busy %u us, max deferred %u us, idle %u%%\n",
+         G_stLoopStats.u32Loops, G_stLoopStats.u32Overruns, LoopStatsBusyPercent(),
+         G_stLoopStats.u16MaxBusyUs, G_stLoopStats.u16MaxDeferUs, G_u8SystemIdlePercent);
+
+  pstVectors = HostVectorStats(&u8Vectors);
+  for(u8 i = 0; i < u8Vectors; i++)
+  {
+    printf("%-16s %u calls\n", pstVectors[i].pcName, pstVectors[i].u32Calls);
+  }
+
+} /* end HostMainReport() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
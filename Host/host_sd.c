@@ -0,0 +1,472 @@
+/*!*********************************************************************************************************************
+@file host_sd.c
+@brief SD card model on the host SPI bus.
+
+Emulates an SDHC card in SPI mode closely enough for sd.c: CMD0, CMD8,
+CMD55/ACMD41 (ready on the third try), CMD59, CMD17 and CMD24 with block
+addressing.  The card's contents are a RAM image that can be loaded from and
+saved to a file.
+
+Replies come out of a queue that HostSdExchange() shifts one byte from per
+SPI exchange, 0xFF when it is empty.  Every reply starts after one 0xFF byte
+(Ncr).  A read sends HOST_SD_READ_LATENCY 0xFF bytes (or what
+HostSdSetReadLatency or a HostSdSetLatencyModel model asks for) before the
+0xFE token, then the data and its CRC16.  A write takes the token, 512
+bytes and two CRC bytes, then replies 0xE5, which is what sd.c checks for.
+The card is never busy after a write.  Command CRCs are never checked, as
+after CMD59.  Chip select is ignored; sd.c keeps it low after SD_Init.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostSd_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_SD_REPLY_SIZE        (HOST_SD_MAX_READ_LATENCY + HOST_SD_SECTOR_SIZE + 8)
+#define HOST_SD_ACMD41_TRIES      (u8)3      /* ACMD41 returns "idle" until this try */
+
+/*! @enum HostSdStateType @brief What the card expects next from the host */
+typedef enum
+{
+  HOST_SD_COMMAND,                /*!< @brief Waiting for or collecting a command frame */
+  HOST_SD_WRITE_TOKEN,            /*!< @brief CMD24 accepted; waiting for 0xFE */
+  HOST_SD_WRITE_DATA,             /*!< @brief Collecting the 512 data bytes */
+  HOST_SD_WRITE_CRC               /*!< @brief Two CRC bytes, then the data response */
+} HostSdStateType;
+
+static u8* HostSd_pu8Image;                               /*!< @brief Card contents */
+static u32 HostSd_u32Sectors;                             /*!< @brief Size of HostSd_pu8Image in sectors */
+
+static HostSdStateType HostSd_eState;
+static u8  HostSd_au8Frame[6];                            /*!< @brief Command frame being collected */
+static u8  HostSd_u8FrameLength;
+static bool HostSd_bIdle = true;                          /*!< @brief In the idle state until ACMD41 completes */
+static bool HostSd_bAppCommand;                           /*!< @brief Last command was CMD55 */
+static u8  HostSd_u8Acmd41Tries;
+
+static u32 HostSd_u32WriteSector;
+static u16 HostSd_u16WriteCount;
+static u8  HostSd_au8WriteData[HOST_SD_SECTOR_SIZE];
+
+static u8  HostSd_au8Reply[HOST_SD_REPLY_SIZE];           /*!< @brief Bytes the card will send next */
+static u16 HostSd_u16ReplyHead;
+static u16 HostSd_u16ReplyLength;
+
+static u16 HostSd_u16ReadLatency = HOST_SD_READ_LATENCY;
+static HostSdLatencyModelType HostSd_pfnLatencyModel;     /*!< @brief Overrides HostSd_u16ReadLatency when set */
+static HostSdStatsType HostSd_stStats;
+
+static void HostSdReply(u8 u8Byte_);
+static u16  HostSdCrc16(const u8* pu8Data_, u16 u16Length_);
+static void HostSdCommand(void);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostSdCreate(u32 u32Sectors_)
+
+@brief Gives the card u32Sectors_ sectors of zeros.
+
+*/
+bool HostSdCreate(u32 u32Sectors_)
+{
+  free(HostSd_pu8Image);
+  HostSd_pu8Image = calloc(u32Sectors_, HOST_SD_SECTOR_SIZE);
+  HostSd_u32Sectors = (HostSd_pu8Image != NULL) ? u32Sectors_ : 0;
+
+  return (HostSd_pu8Image != NULL);
+
+} /* end HostSdCreate() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostSdLoad(const char* pcPath_)
+
+@brief Loads the card image from a file; a partial last sector is padded with zeros.
+
+*/
+bool HostSdLoad(const char* pcPath_)
+{
+  FILE* pFile = fopen(pcPath_, "rb");
+  long lSize;
+  bool bResult = false;
+
+  if(pFile == NULL)
+  {
+    return false;
+  }
+
+  if( (fseek(pFile, 0, SEEK_END) == 0) && ((lSize = ftell(pFile)) > 0) &&
+      (fseek(pFile, 0, SEEK_SET) == 0) &&
+      HostSdCreate((u32)((lSize + HOST_SD_SECTOR_SIZE - 1) / HOST_SD_SECTOR_SIZE)) )
+  {
+    bResult = (fread(HostSd_pu8Image, 1, (size_t)lSize, pFile) == (size_t)lSize);
+  }
+
+  fclose(pFile);
+  return bResult;
+
+} /* end HostSdLoad() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostSdSave(const char* pcPath_)
+
+@brief Writes the whole card image to a file.
+
+*/
+bool HostSdSave(const char* pcPath_)
+{
+  FILE* pFile = fopen(pcPath_, "wb");
+  bool bResult;
+
+  if(pFile == NULL)
+  {
+    return false;
+  }
+
+  bResult = (fwrite(HostSd_pu8Image, HOST_SD_SECTOR_SIZE, HostSd_u32Sectors, pFile) == HostSd_u32Sectors);
+  return (fclose(pFile) == 0) && bResult;
+
+} /* end HostSdSave() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8* HostSdSector(u32 u32Sector_)
+
+@brief Returns the 512 bytes of a sector for the host to read or fill, or NULL past the end.
+
+*/
+u8* HostSdSector(u32 u32Sector_)
+{
+  if(u32Sector_ >= HostSd_u32Sectors)
+  {
+    return NULL;
+  }
+
+  return HostSd_pu8Image + (size_t)u32Sector_ * HOST_SD_SECTOR_SIZE;
+
+} /* end HostSdSector() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u32 HostSdSectors(void)
+
+@brief Returns the card size in sectors.
+
+*/
+u32 HostSdSectors(void)
+{
+  return HostSd_u32Sectors;
+
+} /* end HostSdSectors() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostSdSetReadLatency(u16 u16Bytes_)
+
+@brief Sets how many 0xFF bytes a read sends before its data token.
+
+Limited to 1 - HOST_SD_MAX_READ_LATENCY.
+
+*/
+void HostSdSetReadLatency(u16 u16Bytes_)
+{
+  if(u16Bytes_ == 0)
+  {
+    u16Bytes_ = 1;
+  }
+
+  HostSd_u16ReadLatency = (u16Bytes_ > HOST_SD_MAX_READ_LATENCY) ? HOST_SD_MAX_READ_LATENCY : u16Bytes_;
+
+} /* end HostSdSetReadLatency() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostSdSetLatencyModel(HostSdLatencyModelType pfnModel_)
+
+@brief Has pfnModel_ choose the latency of every read from then on.
+
+The model is called once per CMD17 with the sector being read and returns
+the number of 0xFF bytes before the data token, limited as for
+HostSdSetReadLatency.  NULL goes back to the fixed latency.
+
+*/
+void HostSdSetLatencyModel(HostSdLatencyModelType pfnModel_)
+{
+  HostSd_pfnLatencyModel = pfnModel_;
+
+} /* end HostSdSetLatencyModel() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn const HostSdStatsType* HostSdStats(void)
+
+@brief Returns the card's counters.
+
+*/
+const HostSdStatsType* HostSdStats(void)
+{
+  return &HostSd_stStats;
+
+} /* end HostSdStats() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 HostSdExchange(u8 u8Mosi_)
+
+@brief One SPI byte: takes u8Mosi_ from the host and returns the card's byte.
+
+Requires:
+- Called by HostSpiTransmit
+
+Promises:
+- Returns the next queued reply byte, or 0xFF
+- Acts on u8Mosi_ according to the state the card is in
+
+*/
+u8 HostSdExchange(u8 u8Mosi_)
+{
+  u8 u8Miso = 0xFF;
+
+  HostSd_stStats.u64Bytes++;
+
+  if(HostSd_u16ReplyHead < HostSd_u16ReplyLength)
+  {
+    u8Miso = HostSd_au8Reply[HostSd_u16ReplyHead++];
+  }
+
+  switch(HostSd_eState)
+  {
+    case HOST_SD_COMMAND:
+      /* A frame starts with 01 in the top bits; 0xFF filler never does */
+      if( (HostSd_u8FrameLength != 0) || ((u8Mosi_ & 0xC0) == 0x40) )
+      {
+        HostSd_au8Frame[HostSd_u8FrameLength++] = u8Mosi_;
+        if(HostSd_u8FrameLength == sizeof(HostSd_au8Frame))
+        {
+          HostSd_u8FrameLength = 0;
+          HostSdCommand();
+        }
+      }
+      break;
+
+    case HOST_SD_WRITE_TOKEN:
+      if(u8Mosi_ == 0xFE)
+      {
+        HostSd_u16WriteCount = 0;
+        HostSd_eState = HOST_SD_WRITE_DATA;
+      }
+      break;
+
+    case HOST_SD_WRITE_DATA:
+      HostSd_au8WriteData[HostSd_u16WriteCount++] = u8Mosi_;
+      if(HostSd_u16WriteCount == HOST_SD_SECTOR_SIZE)
+      {
+        HostSd_u16WriteCount = 0;
+        HostSd_eState = HOST_SD_WRITE_CRC;
+      }
+      break;
+
+    case HOST_SD_WRITE_CRC:
+      if(++HostSd_u16WriteCount == 2)
+      {
+        memcpy(HostSdSector(HostSd_u32WriteSector), HostSd_au8WriteData, HOST_SD_SECTOR_SIZE);
+        HostSd_stStats.u32SectorsWritten++;
+        HostSdReply(0xE5);
+        HostSd_eState = HOST_SD_COMMAND;
+      }
+      break;
+  }
+
+  return u8Miso;
+
+} /* end HostSdExchange() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostSdReply(u8 u8Byte_)
+
+@brief Queues one byte for the card to send.
+
+*/
+static void HostSdReply(u8 u8Byte_)
+{
+  if(HostSd_u16ReplyHead == HostSd_u16ReplyLength)
+  {
+    HostSd_u16ReplyHead = 0;
+    HostSd_u16ReplyLength = 0;
+  }
+
+  if(HostSd_u16ReplyLength < HOST_SD_REPLY_SIZE)
+  {
+    HostSd_au8Reply[HostSd_u16ReplyLength++] = u8Byte_;
+  }
+
+} /* end HostSdReply() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u16 HostSdCrc16(const u8* pu8Data_, u16 u16Length_)
+
+@brief CRC16-CCITT (0x1021, seed 0) of a data block, bit by bit.
+
+Deliberately not the firmware's table so a broken table shows up as CRC errors.
+
+*/
+static u16 HostSdCrc16(const u8* pu8Data_, u16 u16Length_)
+{
+  u16 u16Crc = 0;
+
+  while(u16Length_--)
+  {
+    u16Crc ^= (u16)(*pu8Data_++) << 8;
+    for(u8 i = 0; i < 8; i++)
+    {
+      u16Crc = (u16Crc & 0x8000) ? (u16)((u16Crc << 1) ^ 0x1021) : (u16)(u16Crc << 1);
+    }
+  }
+
+  return u16Crc;
+
+} /* end HostSdCrc16() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostSdCommand(void)
+
+@brief Acts on the command frame in HostSd_au8Frame and queues the reply.
+
+*/
+static void HostSdCommand(void)
+{
+  u8  u8Command = HostSd_au8Frame[0] & 0x3F;
+  u32 u32Argument = ((u32)HostSd_au8Frame[1] << 24) | ((u32)HostSd_au8Frame[2] << 16) |
+                    ((u32)HostSd_au8Frame[3] << 8)  | HostSd_au8Frame[4];
+  u8  u8Idle = HostSd_bIdle ? 0x01 : 0x00;
+  bool bAppCommand = HostSd_bAppCommand;
+  u8* pu8Sector;
+  u16 u16Crc;
+  u16 u16Latency;
+
+  HostSd_stStats.u32Commands++;
+  HostSd_bAppCommand = false;
+
+  /* Ncr: one byte of 0xFF before every reply */
+  HostSd_u16ReplyHead = 0;
+  HostSd_u16ReplyLength = 0;
+  HostSdReply(0xFF);
+
+  switch(u8Command)
+  {
+    case 0:
+      HostSd_bIdle = true;
+      HostSd_u8Acmd41Tries = 0;
+      HostSdReply(0x01);
+      break;
+
+    case 8:
+      /* R7: voltage accepted, check pattern echoed */
+      HostSdReply(u8Idle);
+      HostSdReply(0x00);
+      HostSdReply(0x00);
+      HostSdReply(HostSd_au8Frame[3] & 0x0F);
+      HostSdReply(HostSd_au8Frame[4]);
+      break;
+
+    case 55:
+      HostSd_bAppCommand = true;
+      HostSdReply(u8Idle);
+      break;
+
+    case 41:
+      if(bAppCommand && (++HostSd_u8Acmd41Tries >= HOST_SD_ACMD41_TRIES))
+      {
+        HostSd_bIdle = false;
+      }
+      HostSdReply(HostSd_bIdle ? 0x01 : 0x00);
+      break;
+
+    case 59:
+      HostSdReply(u8Idle);
+      break;
+
+    case 17:
+      pu8Sector = HostSdSector(u32Argument);
+      if(HostSd_bIdle || (pu8Sector == NULL))
+      {
+        HostSd_stStats.u32Errors++;
+        HostSdReply(u8Idle | 0x40);    /* Parameter error */
+        break;
+      }
+
+      u16Latency = HostSd_u16ReadLatency;
+      if(HostSd_pfnLatencyModel != NULL)
+      {
+        u16Latency = HostSd_pfnLatencyModel(u32Argument);
+        u16Latency = (u16Latency == 0) ? 1 : u16Latency;
+        u16Latency = (u16Latency > HOST_SD_MAX_READ_LATENCY) ? HOST_SD_MAX_READ_LATENCY : u16Latency;
+      }
+
+      HostSdReply(0x00);
+      for(u16 i = 0; i < u16Latency; i++)
+      {
+        HostSdReply(0xFF);
+      }
+      HostSdReply(0xFE);
+      for(u16 i = 0; i < HOST_SD_SECTOR_SIZE; i++)
+      {
+        HostSdReply(pu8Sector[i]);
+      }
+      u16Crc = HostSdCrc16(pu8Sector, HOST_SD_SECTOR_SIZE);
+      HostSdReply((u8)(u16Crc >> 8));
+      HostSdReply((u8)u16Crc);
+      HostSd_stStats.u32SectorsRead++;
+      break;
+
+    case 24:
+      if(HostSd_bIdle || (HostSdSector(u32Argument) == NULL))
+      {
+        HostSd_stStats.u32Errors++;
+        HostSdReply(u8Idle | 0x40);
+        break;
+      }
+
+      HostSd_u32WriteSector = u32Argument;
+      HostSd_eState = HOST_SD_WRITE_TOKEN;
+      HostSdReply(0x00);
+      break;
+
+    default:
+      HostSd_stStats.u32Errors++;
+      HostSdReply(u8Idle | 0x04);      /* Illegal command */
+      break;
+  }
+
+} /* end HostSdCommand() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,554 @@
+/*!*********************************************************************************************************************
+@file host_sim.c
+@brief Long-session simulator: hours of playback, song changes and logging in virtual time.
+
+  heart_rate_music_sim [-h hours] [-s seed] [-c ISR=cycles]...
+
+-h  virtual session length, default 10 hours
+-s  seed for every random choice, default 1; the same seed gives the same run
+-c  instruction cycles to charge per call of an ISR (see HostSetIsrCycles),
+    e.g. -c TMR1_ISR=90 -c TMR2_ISR=150 with figures from isr_profile.c
+
+The card holds SIM_SONGS songs of random length from sector 1, then a ring
+of SIM_LOG_SECTORS log sectors.  From the main loop (the idle hook) the
+session:
+
+- starts a random song whenever nothing is playing
+- switches song at random intervals, as a heart-rate change would
+- writes a log record sector with SD_WriteBlock every SIM_LOG_PERIOD_MS
+
+Reads get a random latency: mostly tens of microseconds with the odd stall
+of up to HOST_SD_MAX_READ_LATENCY bytes, as real cards do while they
+erase or remap.  At the end the log ring is read back and every record
+checked.  Everything printed on stdout depends only on the arguments; the
+host time goes to stderr.  Exits with failure on underruns, SD write
+failures or a bad log.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+***********************************************************************************************************************/
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern volatile u32 G_u32SystemTime1ms;                   /*!< @brief From main.c */
+extern volatile u32 G_u32AudioUnderruns;                  /*!< @brief From audio.c */
+extern u32 G_u32SDCrcErrors;                              /*!< @brief From sd.c */
+extern u8 G_au8SDWriteBuffer[512];                        /*!< @brief From sd.c */
+extern LoopStatsType G_stLoopStats;                       /*!< @brief From loop_stats.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostSim_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define SIM_SONGS                 (u8)12
+#define SIM_SONG_MIN_S            (u32)30
+#define SIM_SONG_MAX_S            (u32)300
+#define SIM_SAMPLE_PERIOD_US      (u16)125     /* 8kHz */
+#define SIM_SAMPLES_PER_S         (u32)8000
+#define SIM_CHANGE_MIN_S          (u32)20      /* Heart-rate song changes */
+#define SIM_CHANGE_MAX_S          (u32)600
+#define SIM_LOG_PERIOD_MS         (u32)1000
+#define SIM_LOG_SECTORS           (u32)4096
+#define SIM_LOG_MAGIC             (u32)0x474C5248  /* "HRLG" */
+
+/*!
+@struct HostSimSongType
+@brief Where a song is on the simulated card.
+*/
+typedef struct
+{
+  u32 u32FirstSector;
+  u32 u32Sectors;
+} HostSimSongType;
+
+static HostSimSongType HostSim_astSongs[SIM_SONGS];
+static u32 HostSim_u32LogBase;                           /*!< @brief First sector of the log ring */
+static u32 HostSim_u32Random = 1;                        /*!< @brief xorshift32 state */
+
+static u8  HostSim_u8Song;
+static u32 HostSim_u32NextChangeMs;
+static u32 HostSim_u32NextLogMs;
+static u32 HostSim_u32LogRecords;                        /*!< @brief Records written, and the next sequence number */
+
+static u32 HostSim_u32SongsStarted;
+static u32 HostSim_u32SongsFinished;
+static u32 HostSim_u32SongChanges;
+static u32 HostSim_u32StartFailures;
+static u32 HostSim_u32WriteFailures;
+static u64 HostSim_u64WorstLogWrite;                     /*!< @brief Virtual ticks in the slowest SD_WriteBlock */
+static u64 HostSim_u64WorstStart;                        /*!< @brief Virtual ticks in the slowest AudioStart */
+static u16 HostSim_u16WorstLatency;                      /*!< @brief Longest read latency handed out, in bytes */
+static u32 HostSim_u32Stalls;                            /*!< @brief Reads given more than 1000 bytes of latency */
+static u32 HostSim_u32Hour;                              /*!< @brief Progress reported on stderr */
+
+static u32 HostSim_u32DacHash = 2166136261u;             /*!< @brief FNV-1a of every DAC write, for comparing runs */
+static u64 HostSim_u64DacWrites;
+
+static u32  HostSimRandom(u32 u32Limit_);
+static u16  HostSimLatency(u32 u32Sector_);
+static void HostSimDac(u64 u64Time_, u8 u8Value_);
+static bool HostSimIdle(void);
+static void HostSimStartSong(void);
+static void HostSimWriteLog(void);
+static void HostSimFillRecord(u8* pu8Record_, u32 u32Sequence_, u32 u32TimeMs_);
+static u16  HostSimFletcher(const u8* pu8Data_, u16 u16Length_);
+static void HostSimCard(void);
+static u32  HostSimAllocate(u32* pu32Next_, u32 u32Count_);
+static u32  HostSimCheckLog(u32* pu32Checked_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+  double dHours = 10.0;
+  u32 u32Seed = 1;
+  char acIsr[32];
+  unsigned uCycles;
+  clock_t stStart;
+  const HostSdStatsType* pstSd;
+  const HostVectorStatsType* pstVectors;
+  u8 u8Vectors;
+  u32 u32Checked;
+  u32 u32BadRecords;
+  double dSeconds;
+  u64 u64SpiTicks;
+  bool bPass;
+
+  for(int i = 1; i < argc; i++)
+  {
+    if( (strcmp(argv[i], "-h") == 0) && (i + 1 < argc) )
+    {
+      dHours = atof(argv[++i]);
+    }
+    else if( (strcmp(argv[i], "-s") == 0) && (i + 1 < argc) )
+    {
+      u32Seed = (u32)strtoul(argv[++i], NULL, 0);
+    }
+    else if( (strcmp(argv[i], "-c") == 0) && (i + 1 < argc) &&
+             (sscanf(argv[++i], "%31[^=]=%u", acIsr, &uCycles) == 2) &&
+             (uCycles <= 0xFFFF) && HostSetIsrCycles(acIsr, (u16)uCycles) )
+    {
+      printf("isr cost         %s %u cycles\n", acIsr, uCycles);
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [-h hours] [-s seed] [-c ISR=cycles]...\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  /* xorshift32 must not start at 0 */
+  HostSim_u32Random = (u32Seed != 0) ? u32Seed : 1;
+  dSeconds = dHours * 3600.0;
+
+  HostReset();
+  HostSimCard();
+  HostSdSetLatencyModel(HostSimLatency);
+  HostSetDacListener(HostSimDac);
+  HostSetIdleHook(HostSimIdle);
+
+  stStart = clock();
+  if(!HostRun((u64)(dSeconds * HOST_TICKS_PER_S)))
+  {
+    fprintf(stderr, "%s: firmware main() returned\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "%.1f virtual hours in %.1f s host time\n", dHours,
+          (double)(clock() - stStart) / CLOCKS_PER_SEC);
+
+  u32BadRecords = HostSimCheckLog(&u32Checked);
+  pstSd = HostSdStats();
+  u64SpiTicks = pstSd->u64Bytes * 16 * ((u64)SPI1BAUD + 1);
+
+  printf("session          %.3f h, seed %u, %u songs on the card\n", dHours, u32Seed, SIM_SONGS);
+  printf("songs            %u started, %u played to the end, %u changed, %u failed to start\n",
+         HostSim_u32SongsStarted, HostSim_u32SongsFinished, HostSim_u32SongChanges, HostSim_u32StartFailures);
+  printf("audio            %llu dac writes, %u underruns, hash %08x\n",
+         (unsigned long long)HostSim_u64DacWrites, G_u32AudioUnderruns, HostSim_u32DacHash);
+  printf("loop             %u passes, %u overruns, busy %u%%, worst busy %u us, worst deferred %u us\n",
+         G_stLoopStats.u32Loops, G_stLoopStats.u32Overruns, LoopStatsBusyPercent(),
+         G_stLoopStats.u16MaxBusyUs, G_stLoopStats.u16MaxDeferUs);
+  printf("main loop work   worst AudioStart %llu us, worst log write %llu us\n",
+         (unsigned long long)(HostSim_u64WorstStart / HOST_TICKS_PER_US),
+         (unsigned long long)(HostSim_u64WorstLogWrite / HOST_TICKS_PER_US));
+  printf("sd reads         %u sectors, %.1f kB/s, %u crc errors, %u stalls, worst latency %u us\n",
+         pstSd->u32SectorsRead, pstSd->u32SectorsRead * 0.512 / dSeconds, G_u32SDCrcErrors,
+         HostSim_u32Stalls, HostSim_u16WorstLatency * 16 * (SPI1BAUD + 1) / 64);
+  printf("sd writes        %u sectors, %u failed\n", pstSd->u32SectorsWritten, HostSim_u32WriteFailures);
+  printf("sd bus           %llu bytes, %.2f%% busy, %u commands, %u rejected\n",
+         (unsigned long long)pstSd->u64Bytes, 100.0 * u64SpiTicks / (dSeconds * HOST_TICKS_PER_S),
+         pstSd->u32Commands, pstSd->u32Errors);
+  printf("log              %u records written, %u checked, %u bad\n",
+         HostSim_u32LogRecords, u32Checked, u32BadRecords);
+
+  pstVectors = HostVectorStats(&u8Vectors);
+  for(u8 i = 0; i < u8Vectors; i++)
+  {
+    printf("%-16s %u calls\n", pstVectors[i].pcName, pstVectors[i].u32Calls);
+  }
+
+  bPass = (G_u32AudioUnderruns == 0) && (HostSim_u32WriteFailures == 0) &&
+          (HostSim_u32StartFailures == 0) && (u32BadRecords == 0) && (G_u32SDCrcErrors == 0);
+  printf("result           %s\n", bPass ? "PASS" : "FAIL");
+
+  return bPass ? EXIT_SUCCESS : EXIT_FAILURE;
+
+} /* end main() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostSimRandom(u32 u32Limit_)
+
+@brief Returns a pseudo-random number from 0 to u32Limit_ - 1 (xorshift32).
+
+*/
+static u32 HostSimRandom(u32 u32Limit_)
+{
+  HostSim_u32Random ^= HostSim_u32Random << 13;
+  HostSim_u32Random ^= HostSim_u32Random >> 17;
+  HostSim_u32Random ^= HostSim_u32Random << 5;
+
+  return (u32Limit_ != 0) ? (HostSim_u32Random % u32Limit_) : 0;
+
+} /* end HostSimRandom() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u16 HostSimLatency(u32 u32Sector_)
+
+@brief SD read latency model: 2 - 40 bytes usually, 0.1 - 1ms one read in 25,
+up to HOST_SD_MAX_READ_LATENCY one read in 200.
+
+*/
+static u16 HostSimLatency(u32 u32Sector_)
+{
+  u32 u32Roll = HostSimRandom(1000);
+  u16 u16Latency;
+
+  (void)u32Sector_;
+
+  if(u32Roll < 5)
+  {
+    u16Latency = (u16)(1000 + HostSimRandom(HOST_SD_MAX_READ_LATENCY - 1000 + 1));
+    HostSim_u32Stalls++;
+  }
+  else if(u32Roll < 45)
+  {
+    u16Latency = (u16)(100 + HostSimRandom(901));
+  }
+  else
+  {
+    u16Latency = (u16)(2 + HostSimRandom(39));
+  }
+
+  if(u16Latency > HostSim_u16WorstLatency)
+  {
+    HostSim_u16WorstLatency = u16Latency;
+  }
+
+  return u16Latency;
+
+} /* end HostSimLatency() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostSimDac(u64 u64Time_, u8 u8Value_)
+
+@brief DAC listener: counts and hashes every write.
+
+*/
+static void HostSimDac(u64 u64Time_, u8 u8Value_)
+{
+  (void)u64Time_;
+
+  HostSim_u32DacHash = (HostSim_u32DacHash ^ u8Value_) * 16777619u;
+  HostSim_u64DacWrites++;
+
+} /* end HostSimDac() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static bool HostSimIdle(void)
+
+@brief Idle hook: drives the session from the main loop.
+
+*/
+static bool HostSimIdle(void)
+{
+  u32 u32Now = G_u32SystemTime1ms;
+
+  if(u32Now / 3600000u != HostSim_u32Hour)
+  {
+    HostSim_u32Hour = u32Now / 3600000u;
+    fprintf(stderr, "hour %u\n", HostSim_u32Hour);
+  }
+
+  if(!AudioIsPlaying())
+  {
+    if(HostSim_u32SongsStarted != 0)
+    {
+      HostSim_u32SongsFinished++;
+    }
+    HostSimStartSong();
+    return true;
+  }
+
+  if( (s32)(u32Now - HostSim_u32NextChangeMs) >= 0 )
+  {
+    HostSim_u32SongChanges++;
+    HostSimStartSong();
+    return true;
+  }
+
+  if( (s32)(u32Now - HostSim_u32NextLogMs) >= 0 )
+  {
+    HostSim_u32NextLogMs += SIM_LOG_PERIOD_MS;
+    HostSimWriteLog();
+    return true;
+  }
+
+  return false;
+
+} /* end HostSimIdle() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostSimStartSong(void)
+
+@brief Starts a random song other than the current one and picks when to change next.
+
+*/
+static void HostSimStartSong(void)
+{
+  u8 u8Song = (u8)HostSimRandom(SIM_SONGS - 1);
+  u64 u64Start;
+
+  /* Skip the song just played */
+  HostSim_u8Song = (u8Song >= HostSim_u8Song) ? (u8)(u8Song + 1) : u8Song;
+  HostSim_u32NextChangeMs = G_u32SystemTime1ms +
+                            1000 * (SIM_CHANGE_MIN_S + HostSimRandom(SIM_CHANGE_MAX_S - SIM_CHANGE_MIN_S + 1));
+
+  u64Start = HostNow();
+  if(!AudioStart(HostSim_astSongs[HostSim_u8Song].u32FirstSector,
+                 HostSim_astSongs[HostSim_u8Song].u32Sectors, SIM_SAMPLE_PERIOD_US, AUDIO_FORMAT_PCM8))
+  {
+    HostSim_u32StartFailures++;
+  }
+  HostSim_u32SongsStarted++;
+
+  if(HostNow() - u64Start > HostSim_u64WorstStart)
+  {
+    HostSim_u64WorstStart = HostNow() - u64Start;
+  }
+
+} /* end HostSimStartSong() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostSimWriteLog(void)
+
+@brief Writes the next log record to the log ring.
+
+*/
+static void HostSimWriteLog(void)
+{
+  u32 u32Sector = HostSim_u32LogBase + (HostSim_u32LogRecords % SIM_LOG_SECTORS);
+  u64 u64Start;
+
+  HostSimFillRecord(G_au8SDWriteBuffer, HostSim_u32LogRecords, G_u32SystemTime1ms);
+  HostSim_u32LogRecords++;
+
+  u64Start = HostNow();
+  if(!SD_WriteBlock((u8)(u32Sector >> 24), (u8)(u32Sector >> 16), (u8)(u32Sector >> 8), (u8)u32Sector))
+  {
+    HostSim_u32WriteFailures++;
+  }
+
+  if(HostNow() - u64Start > HostSim_u64WorstLogWrite)
+  {
+    HostSim_u64WorstLogWrite = HostNow() - u64Start;
+  }
+
+} /* end HostSimWriteLog() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostSimFillRecord(u8* pu8Record_, u32 u32Sequence_, u32 u32TimeMs_)
+
+@brief Builds log record u32Sequence_ in a sector buffer.
+
+Little-endian: magic, sequence, time in ms, then a filler pattern that
+depends on the sequence number, with a Fletcher-16 in the last two bytes.
+
+*/
+static void HostSimFillRecord(u8* pu8Record_, u32 u32Sequence_, u32 u32TimeMs_)
+{
+  u32 au32Header[3] = {SIM_LOG_MAGIC, u32Sequence_, u32TimeMs_};
+  u16 u16Check;
+
+  for(u16 i = 0; i < HOST_SD_SECTOR_SIZE - 2; i++)
+  {
+    pu8Record_[i] = (u8)(u32Sequence_ * 31 + i);
+  }
+
+  for(u8 i = 0; i < 12; i++)
+  {
+    pu8Record_[i] = (u8)(au32Header[i / 4] >> (8 * (i % 4)));
+  }
+
+  u16Check = HostSimFletcher(pu8Record_, HOST_SD_SECTOR_SIZE - 2);
+  pu8Record_[HOST_SD_SECTOR_SIZE - 2] = (u8)u16Check;
+  pu8Record_[HOST_SD_SECTOR_SIZE - 1] = (u8)(u16Check >> 8);
+
+} /* end HostSimFillRecord() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u16 HostSimFletcher(const u8* pu8Data_, u16 u16Length_)
+
+@brief Fletcher-16 of a buffer.
+
+*/
+static u16 HostSimFletcher(const u8* pu8Data_, u16 u16Length_)
+{
+  u16 u16Sum1 = 0;
+  u16 u16Sum2 = 0;
+
+  while(u16Length_--)
+  {
+    u16Sum1 = (u16)((u16Sum1 + *pu8Data_++) % 255);
+    u16Sum2 = (u16)((u16Sum2 + u16Sum1) % 255);
+  }
+
+  return (u16)((u16Sum2 << 8) | u16Sum1);
+
+} /* end HostSimFletcher() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostSimCard(void)
+
+@brief Lays out the card: sector 0, SIM_SONGS songs, then the log ring, all
+clear of the flight recorder sectors.
+
+Each song is a square wave of its own pitch so the DAC hash depends on
+which song played where.
+
+*/
+static void HostSimCard(void)
+{
+  u32 u32Sector = 1;
+  u32 u32Sample;
+  u8* pu8Data;
+
+  for(u8 i = 0; i < SIM_SONGS; i++)
+  {
+    HostSim_astSongs[i].u32Sectors = (SIM_SONG_MIN_S + HostSimRandom(SIM_SONG_MAX_S - SIM_SONG_MIN_S + 1)) *
+                                     SIM_SAMPLES_PER_S / HOST_SD_SECTOR_SIZE;
+    HostSim_astSongs[i].u32FirstSector = HostSimAllocate(&u32Sector, HostSim_astSongs[i].u32Sectors);
+  }
+
+  HostSim_u32LogBase = HostSimAllocate(&u32Sector, SIM_LOG_SECTORS);
+  if(!HostSdCreate(u32Sector))
+  {
+    fprintf(stderr, "no memory for a %u sector card\n", u32Sector);
+    exit(EXIT_FAILURE);
+  }
+
+  for(u8 i = 0; i < SIM_SONGS; i++)
+  {
+    u32Sample = 0;
+    for(u32 j = 0; j < HostSim_astSongs[i].u32Sectors; j++)
+    {
+      pu8Data = HostSdSector(HostSim_astSongs[i].u32FirstSector + j);
+      for(u16 k = 0; k < HOST_SD_SECTOR_SIZE; k++, u32Sample++)
+      {
+        pu8Data[k] = ((u32Sample / (4 + i)) & 1) ? (u8)(0xC0 - i) : (u8)(0x40 + i);
+      }
+    }
+  }
+
+  /* The first song is never "the one just played" */
+  HostSim_u8Song = SIM_SONGS;
+
+} /* end HostSimCard() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostSimAllocate(u32* pu32Next_, u32 u32Count_)
+
+@brief Returns the first of u32Count_ sectors from *pu32Next_ clear of the trace, and moves *pu32Next_ past them.
+
+*/
+static u32 HostSimAllocate(u32* pu32Next_, u32 u32Count_)
+{
+  u32 u32First = *pu32Next_;
+
+  if( (u32First < TRACE_SD_SECTOR + TRACE_SD_SECTORS) && (u32First + u32Count_ > TRACE_SD_SECTOR) )
+  {
+    u32First = TRACE_SD_SECTOR + TRACE_SD_SECTORS;
+  }
+
+  *pu32Next_ = u32First + u32Count_;
+  return u32First;
+
+} /* end HostSimAllocate() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostSimCheckLog(u32* pu32Checked_)
+
+@brief Checks the records still in the log ring; returns how many are wrong.
+
+Each sector must hold exactly the record that was written there last, its
+times must not go backwards and its checksum must match.
+
+*/
+static u32 HostSimCheckLog(u32* pu32Checked_)
+{
+  u8 au8Expected[HOST_SD_SECTOR_SIZE];
+  u32 u32First = (HostSim_u32LogRecords > SIM_LOG_SECTORS) ? (HostSim_u32LogRecords - SIM_LOG_SECTORS) : 0;
+  u32 u32Bad = 0;
+  u32 u32LastTime = 0;
+  u32 u32Time;
+  u8* pu8Stored;
+
+  *pu32Checked_ = 0;
+  for(u32 u32Sequence = u32First; u32Sequence < HostSim_u32LogRecords; u32Sequence++)
+  {
+    pu8Stored = HostSdSector(HostSim_u32LogBase + (u32Sequence % SIM_LOG_SECTORS));
+    u32Time = (u32)pu8Stored[8] | ((u32)pu8Stored[9] << 8) | ((u32)pu8Stored[10] << 16) | ((u32)pu8Stored[11] << 24);
+
+    HostSimFillRecord(au8Expected, u32Sequence, u32Time);
+    if( (memcmp(au8Expected, pu8Stored, HOST_SD_SECTOR_SIZE) != 0) || (u32Time < u32LastTime) )
+    {
+      if(u32Bad++ < 10)
+      {
+        printf("bad log record %u in sector %u\n", u32Sequence, HostSim_u32LogBase + (u32Sequence % SIM_LOG_SECTORS));
+      }
+    }
+
+    u32LastTime = u32Time;
+    (*pu32Checked_)++;
+  }
+
+  return u32Bad;
+
+} /* end HostSimCheckLog() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
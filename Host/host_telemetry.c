@@ -0,0 +1,296 @@
+/*!*********************************************************************************************************************
+@file host_telemetry.c
+@brief Decodes the firmware's UART1 telemetry stream (telemetry.c) into text or CSV.
+
+  heart_rate_music_telemetry [-c] [file]
+
+-c  CSV, one row per stats frame with a header row, for a spreadsheet or
+    gnuplot; other frames become '#' lines
+file  a capture (heart_rate_music_host -u) or a serial port already set to
+    115200 8N1 raw, e.g. /dev/ttyUSB0; default stdin
+
+Frames are decoded as they arrive and stdout is flushed after each one, so
+it follows a live board or a pipe from the host build.  Bytes that aren't
+part of a frame with a good checksum are skipped.  A count of frames,
+checksum failures and skipped bytes goes to stderr at the end.
+
+Only the frame layout comes from the firmware headers; the payload offsets
+and loop histogram bins here must follow telemetry.c, region_profile.c and
+loop_stats.c.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostTelemetry_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_TELEMETRY_FRAME_MAX  (TELEMETRY_PAYLOAD_MAX + TELEMETRY_OVERHEAD)
+#define HOST_TELEMETRY_REGION_MIN 17           /* Region payload before the name */
+
+static bool HostTelemetry_bCsv;
+static u32  HostTelemetry_u32Frames;
+static u32  HostTelemetry_u32BadFrames;        /* SYNC found but the length or checksum was wrong */
+static u32  HostTelemetry_u32Skipped;          /* Bytes dropped looking for SYNC */
+
+/* Upper limits of the loop histogram bins, from loop_stats.c; the last bin has none */
+static const u16 HostTelemetry_au16LoopBinUs[LOOP_STATS_BINS - 1] = {50, 100, 250, 500, 750, 1000, 2000};
+
+static u8  HostTelemetry_au8Frame[HOST_TELEMETRY_FRAME_MAX];
+static u16 HostTelemetry_u16Length;            /* Bytes in HostTelemetry_au8Frame */
+
+static void HostTelemetryByte(u8 u8Byte_);
+static void HostTelemetryDrop(u16 u16Bytes_);
+static void HostTelemetryFrame(u8 u8Type_, const u8* pu8Payload_, u8 u8Length_);
+static u32  HostTelemetryGet(const u8* pu8Payload_, u8 u8Offset_, u8 u8Bytes_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn int main(int argc, char* argv[])
+
+@brief Decodes a file or stdin until it ends.
+
+*/
+int main(int argc, char* argv[])
+{
+  const char* pcFile = NULL;
+  u8 au8Read[256];
+  ssize_t sRead;
+  int iFd = STDIN_FILENO;
+
+  for(int iOption = 1; iOption < argc; iOption++)
+  {
+    if(strcmp(argv[iOption], "-c") == 0)
+    {
+      HostTelemetry_bCsv = true;
+    }
+    else if( (argv[iOption][0] != '-') && (pcFile == NULL) )
+    {
+      pcFile = argv[iOption];
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [-c] [file]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(pcFile != NULL)
+  {
+    iFd = open(pcFile, O_RDONLY);
+    if(iFd < 0)
+    {
+      fprintf(stderr, "%s: can't read %s\n", argv[0], pcFile);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(HostTelemetry_bCsv)
+  {
+    printf("time_s,bpm,playing,full_clock,trace_frozen,buffered,underruns,sd_max_us,loop_peak_us,busy_percent,overruns,uart_dropped,stack_levels\n");
+  }
+  else
+  {
+    printf("#   time_s bpm play clock trace buffered underruns sd_max_us loop_peak_us busy%% overruns uart_dropped stack\n");
+  }
+
+  /* read() rather than stdio so a live port is decoded byte by byte */
+  while((sRead = read(iFd, au8Read, sizeof(au8Read))) > 0)
+  {
+    for(ssize_t i = 0; i < sRead; i++)
+    {
+      HostTelemetryByte(au8Read[i]);
+    }
+  }
+
+  if(pcFile != NULL)
+  {
+    close(iFd);
+  }
+
+  fprintf(stderr, "%u frames, %u bad, %u bytes skipped\n",
+          HostTelemetry_u32Frames, HostTelemetry_u32BadFrames,
+          HostTelemetry_u32Skipped + HostTelemetry_u16Length);
+
+  return EXIT_SUCCESS;
+
+} /* end main() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTelemetryByte(u8 u8Byte_)
+
+@brief Adds one received byte and decodes every complete frame.
+
+A frame that fails its checks loses only its SYNC byte, so a real frame
+starting inside it is still found.
+
+*/
+static void HostTelemetryByte(u8 u8Byte_)
+{
+  u8 u8Sum1;
+  u8 u8Sum2;
+  u16 u16Size;
+
+  HostTelemetry_au8Frame[HostTelemetry_u16Length++] = u8Byte_;
+
+  while(HostTelemetry_u16Length != 0)
+  {
+    if(HostTelemetry_au8Frame[0] != TELEMETRY_SYNC)
+    {
+      HostTelemetry_u32Skipped++;
+      HostTelemetryDrop(1);
+      continue;
+    }
+
+    if(HostTelemetry_u16Length < 3)
+    {
+      return;
+    }
+
+    if(HostTelemetry_au8Frame[2] > TELEMETRY_PAYLOAD_MAX)
+    {
+      HostTelemetry_u32BadFrames++;
+      HostTelemetryDrop(1);
+      continue;
+    }
+
+    u16Size = (u16)(HostTelemetry_au8Frame[2] + TELEMETRY_OVERHEAD);
+    if(HostTelemetry_u16Length < u16Size)
+    {
+      return;
+    }
+
+    /* Fletcher-16 over type, length and payload, as TelemetrySend */
+    u8Sum1 = 0;
+    u8Sum2 = 0;
+    for(u16 i = 1; i < u16Size - 2; i++)
+    {
+      u8Sum1 = (u8)((u8Sum1 + HostTelemetry_au8Frame[i]) % 255);
+      u8Sum2 = (u8)((u8Sum2 + u8Sum1) % 255);
+    }
+
+    if( (u8Sum1 != HostTelemetry_au8Frame[u16Size - 2]) ||
+        (u8Sum2 != HostTelemetry_au8Frame[u16Size - 1]) )
+    {
+      HostTelemetry_u32BadFrames++;
+      HostTelemetryDrop(1);
+      continue;
+    }
+
+    HostTelemetry_u32Frames++;
+    HostTelemetryFrame(HostTelemetry_au8Frame[1], &HostTelemetry_au8Frame[3], HostTelemetry_au8Frame[2]);
+    fflush(stdout);
+    HostTelemetryDrop(u16Size);
+  }
+
+} /* end HostTelemetryByte() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTelemetryDrop(u16 u16Bytes_)
+
+@brief Removes bytes from the front of the frame buffer.
+
+*/
+static void HostTelemetryDrop(u16 u16Bytes_)
+{
+  HostTelemetry_u16Length -= u16Bytes_;
+  memmove(HostTelemetry_au8Frame, &HostTelemetry_au8Frame[u16Bytes_], HostTelemetry_u16Length);
+
+} /* end HostTelemetryDrop() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTelemetryFrame(u8 u8Type_, const u8* pu8Payload_, u8 u8Length_)
+
+@brief Prints one good frame.
+
+*/
+static void HostTelemetryFrame(u8 u8Type_, const u8* pu8Payload_, u8 u8Length_)
+{
+  const char* pcFormat;
+  u8 u8Flags;
+
+  if( (u8Type_ == TELEMETRY_TYPE_STATS) && (u8Length_ >= TELEMETRY_STATS_SIZE) )
+  {
+    pcFormat = HostTelemetry_bCsv ? "%.3f,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n" :
+                                    "%10.3f %3u %4u %5u %5u %8u %9u %9u %12u %5u %8u %12u %5u\n";
+    u8Flags = pu8Payload_[5];
+    printf(pcFormat,
+           HostTelemetryGet(pu8Payload_, 0, 4) / 1000.0,
+           pu8Payload_[4],
+           (u8Flags & TELEMETRY_FLAG_PLAYING) ? 1u : 0u,
+           (u8Flags & TELEMETRY_FLAG_FULL_CLOCK) ? 64u : 16u,
+           (u8Flags & TELEMETRY_FLAG_TRACE_FROZEN) ? 1u : 0u,
+           HostTelemetryGet(pu8Payload_, 6, 2),
+           HostTelemetryGet(pu8Payload_, 8, 4),
+           HostTelemetryGet(pu8Payload_, 12, 2),
+           HostTelemetryGet(pu8Payload_, 14, 2),
+           pu8Payload_[16],
+           HostTelemetryGet(pu8Payload_, 17, 4),
+           HostTelemetryGet(pu8Payload_, 21, 4),
+           pu8Payload_[25]);
+  }
+  else if( (u8Type_ == TELEMETRY_TYPE_REGION) && (u8Length_ >= HOST_TELEMETRY_REGION_MIN) )
+  {
+    printf("# region %-14.*s %10u calls %14llu cycles %10u max\n",
+           u8Length_ - HOST_TELEMETRY_REGION_MIN, (const char*)&pu8Payload_[HOST_TELEMETRY_REGION_MIN],
+           HostTelemetryGet(pu8Payload_, 1, 4),
+           ((unsigned long long)HostTelemetryGet(pu8Payload_, 9, 4) << 32) | HostTelemetryGet(pu8Payload_, 5, 4),
+           HostTelemetryGet(pu8Payload_, 13, 4));
+  }
+  else if( (u8Type_ == TELEMETRY_TYPE_LOOP) && (u8Length_ >= TELEMETRY_LOOP_SIZE) )
+  {
+    printf("# loop passes");
+    for(u8 i = 0; i < LOOP_STATS_BINS - 1; i++)
+    {
+      printf(" <%uus:%u", HostTelemetry_au16LoopBinUs[i], HostTelemetryGet(pu8Payload_, (u8)(4 * i), 4));
+    }
+    printf(" >=%uus:%u\n", HostTelemetry_au16LoopBinUs[LOOP_STATS_BINS - 2],
+           HostTelemetryGet(pu8Payload_, (u8)(4 * (LOOP_STATS_BINS - 1)), 4));
+  }
+  else
+  {
+    printf("# type 0x%02X, %u bytes\n", u8Type_, u8Length_);
+  }
+
+} /* end HostTelemetryFrame() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostTelemetryGet(const u8* pu8Payload_, u8 u8Offset_, u8 u8Bytes_)
+
+@brief Reads a little-endian field of 1 to 4 bytes, the reverse of TelemetryPack().
+
+*/
+static u32 HostTelemetryGet(const u8* pu8Payload_, u8 u8Offset_, u8 u8Bytes_)
+{
+  u32 u32Value = 0;
+
+  while(u8Bytes_-- != 0)
+  {
+    u32Value = (u32Value << 8) | pu8Payload_[u8Offset_ + u8Bytes_];
+  }
+
+  return u32Value;
+
+} /* end HostTelemetryGet() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,1060 @@
+/*!*********************************************************************************************************************
+@file host_test.c
+@brief Tests of firmware modules that have no user yet, run on the host build.
+
+  heart_rate_music_test [-n name]
+
+-n  runs only the test called name
+
+The firmware boots as usual and the tests run from the first main loop
+idle, one after the other.  They call the module's public functions as a
+future user would and let virtual time pass with HostAdvance(), so the
+tick and Timer0 interrupts are taken just as they are on the part.  The
+scheduler doesn't run while a test does, so a test drives the module's
+scheduler task itself.
+
+Prints one line per failed check, then one PASS or FAIL line per test and
+a result line.  Exits with failure if any check failed.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+***********************************************************************************************************************/
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern u16 G_u16TimerWheelActive;                         /*!< @brief From timer_wheel.c */
+extern volatile u16 G_u16UsTimerLateMaxUs;                /*!< @brief From us_timer.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostTest_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_TEST_TIMERS          (u8)64       /* Timers in the randomised wheel test */
+#define HOST_TEST_EVENTS          (u8)16       /* Microsecond events */
+#define HOST_TEST_US_LATE_MAX     (u32)1       /* Timer0 call-backs run at most this late (code takes no time here) */
+#define HOST_TEST_NONE            (u32)0xFFFFFFFF
+
+/*!
+@struct HostTestType
+@brief One test: its name and the function that runs it.
+*/
+typedef struct
+{
+  const char* pcName;
+  void (*pfnRun)(void);
+} HostTestType;
+
+/*!
+@struct HostTestWheelTimerType
+@brief A wheel timer under test and what the test expects of it.
+*/
+typedef struct
+{
+  TimerWheelEntryType stTimer;
+  u32 u32ExpiresMs;               /*!< @brief TimeBaseMs() it should fire at, or the earliest it may */
+  u32 u32FiredMs;                 /*!< @brief TimeBaseMs() in its call-back, HOST_TEST_NONE until then */
+  u32 u32Fires;                   /*!< @brief Call-backs so far */
+  u32 u32Order;                   /*!< @brief HostTest_u32Fires when it fired */
+  u32 u32Restarts;                /*!< @brief Times its call-back should start it again */
+  u32 u32RestartMs;               /*!< @brief Delay for those restarts */
+  TimerWheelEntryType* pstStop;   /*!< @brief Timer its call-back stops, or NULL */
+} HostTestWheelTimerType;
+
+static const char* HostTest_pcOnly;
+static u32 HostTest_u32Checks;
+static u32 HostTest_u32Failures;                          /*!< @brief Failed checks in the test being run */
+static u32 HostTest_u32Random = 1;                        /*!< @brief xorshift32 state */
+
+/*!
+@struct HostTestUsEventType
+@brief A microsecond event under test and what it recorded.
+*/
+typedef struct
+{
+  UsTimerEventType stEvent;
+  u32 u32DeadlineUs;              /*!< @brief Deadline it was started with */
+  u32 u32Sequence;                /*!< @brief Order it was started in, to break deadline ties */
+  u32 u32FiredUs;                 /*!< @brief UsTimerNow() in its call-back */
+  u64 u64FiredTicks;              /*!< @brief HostNow() in its call-back */
+  u32 u32Fires;                   /*!< @brief Call-backs so far */
+  u32 u32Order;                   /*!< @brief HostTest_u32Fires when it fired */
+  u32 u32PeriodUs;                /*!< @brief Re-armed from its call-back this far after its deadline... */
+  u32 u32Repeats;                 /*!< @brief ...this many more times */
+} HostTestUsEventType;
+
+static HostTestWheelTimerType HostTest_astWheel[HOST_TEST_TIMERS];
+static HostTestUsEventType HostTest_astUs[HOST_TEST_EVENTS];
+static u32 HostTest_u32Fires;                             /*!< @brief Wheel or Timer0 call-backs in the test so far */
+static u32 HostTest_u32LateLimitUs;                       /*!< @brief Latest a Timer0 call-back may run in the test */
+
+static bool HostTestIdle(void);
+static void HostTestCheck(bool bOk_, const char* pcFormat_, ...);
+static u32  HostTestRandom(u32 u32Limit_);
+static void HostTestAdvanceMs(u32 u32Ms_);
+
+static void HostTestWheelReset(void);
+static void HostTestWheelCallback(u16 u16Index_);
+static void HostTestWheelBoundaries(void);
+static void HostTestWheelRestart(void);
+static void HostTestWheelStop(void);
+static void HostTestWheelCatchUp(void);
+static void HostTestWheelMaxDelayLagging(void);
+static void HostTestWheelRandom(void);
+
+static u32  HostTestHostUs(void);
+static void HostTestUsReset(void);
+static void HostTestUsCallback(u16 u16Index_);
+static void HostTestUsOrder(void);
+static void HostTestUsPeriodic(void);
+static void HostTestUsNowWrap(void);
+
+static void HostTestTimeBaseUs(void);
+
+/*! @brief Every test, in run order */
+static const HostTestType HostTest_astTests[] =
+{
+  {"wheel_boundaries",        HostTestWheelBoundaries},
+  {"wheel_restart",           HostTestWheelRestart},
+  {"wheel_stop",              HostTestWheelStop},
+  {"wheel_catch_up",          HostTestWheelCatchUp},
+  {"wheel_max_delay_lagging", HostTestWheelMaxDelayLagging},
+  {"wheel_random",            HostTestWheelRandom},
+  {"us_order",                HostTestUsOrder},
+  {"us_periodic",             HostTestUsPeriodic},
+  {"us_now_wrap",             HostTestUsNowWrap},
+  {"time_base_us",            HostTestTimeBaseUs},
+};
+
+#define HOST_TEST_COUNT           (u8)(sizeof(HostTest_astTests) / sizeof(HostTest_astTests[0]))
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+int main(int argc, char* argv[])
+{
+  for(int i = 1; i < argc; i++)
+  {
+    if( (strcmp(argv[i], "-n") == 0) && (i + 1 < argc) )
+    {
+      HostTest_pcOnly = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [-n name]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  HostReset();
+  HostSdCreate(64);
+  HostSetIdleHook(HostTestIdle);
+
+  /* HostTestIdle exits; the time limit is only a backstop */
+  HostRun(24 * 3600 * HOST_TICKS_PER_S);
+  fprintf(stderr, "%s: the firmware never reached its main loop\n", argv[0]);
+  return EXIT_FAILURE;
+
+} /* end main() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static bool HostTestIdle(void)
+
+@brief Idle hook: runs every test, reports and exits the program.
+
+*/
+static bool HostTestIdle(void)
+{
+  u8 u8Failed = 0;
+  u8 u8Run = 0;
+
+  for(u8 i = 0; i < HOST_TEST_COUNT; i++)
+  {
+    if( (HostTest_pcOnly != NULL) && (strcmp(HostTest_pcOnly, HostTest_astTests[i].pcName) != 0) )
+    {
+      continue;
+    }
+
+    HostTest_u32Failures = 0;
+    HostTest_u32Random = 1;
+    HostTest_astTests[i].pfnRun();
+
+    printf("%-24s %s\n", HostTest_astTests[i].pcName, (HostTest_u32Failures == 0) ? "PASS" : "FAIL");
+    u8Run++;
+    if(HostTest_u32Failures != 0)
+    {
+      u8Failed++;
+    }
+  }
+
+  printf("# %u tests, %u checks\n", u8Run, HostTest_u32Checks);
+  printf("result                   %s\n", ((u8Run != 0) && (u8Failed == 0)) ? "PASS" : "FAIL");
+  exit( ((u8Run != 0) && (u8Failed == 0)) ? EXIT_SUCCESS : EXIT_FAILURE );
+
+} /* end HostTestIdle() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestCheck(bool bOk_, const char* pcFormat_, ...)
+
+@brief Counts a check and prints the printf-style message if it failed.
+
+*/
+static void HostTestCheck(bool bOk_, const char* pcFormat_, ...)
+{
+  va_list args;
+
+  HostTest_u32Checks++;
+  if(bOk_)
+  {
+    return;
+  }
+
+  HostTest_u32Failures++;
+  printf("  failed: ");
+  va_start(args, pcFormat_);
+  vprintf(pcFormat_, args);
+  va_end(args);
+  printf("\n");
+
+} /* end HostTestCheck() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostTestRandom(u32 u32Limit_)
+
+@brief Returns a pseudo-random number from 0 to u32Limit_ - 1 (xorshift32).
+
+*/
+static u32 HostTestRandom(u32 u32Limit_)
+{
+  HostTest_u32Random ^= HostTest_u32Random << 13;
+  HostTest_u32Random ^= HostTest_u32Random >> 17;
+  HostTest_u32Random ^= HostTest_u32Random << 5;
+
+  return HostTest_u32Random % u32Limit_;
+
+} /* end HostTestRandom() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestAdvanceMs(u32 u32Ms_)
+
+@brief Lets u32Ms_ system ticks pass, taking interrupts, without running the scheduler.
+
+*/
+static void HostTestAdvanceMs(u32 u32Ms_)
+{
+  u32 u32Target = TimeBaseMs() + u32Ms_;
+
+  /* Whole milliseconds at once, then up to the tick itself */
+  if(u32Ms_ > 1)
+  {
+    HostAdvance((u64)(u32Ms_ - 1) * HOST_TICKS_PER_MS);
+  }
+  while(TimeBaseMs() != u32Target)
+  {
+    HostAdvance(HOST_TICKS_PER_MS / 8);
+  }
+
+} /* end HostTestAdvanceMs() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Timer wheel (timer_wheel.c) */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelReset(void)
+
+@brief Stops every test timer, brings the wheel up to date and clears the records.
+
+*/
+static void HostTestWheelReset(void)
+{
+  for(u8 i = 0; i < HOST_TEST_TIMERS; i++)
+  {
+    if(HostTest_astWheel[i].stTimer.pfnCallback != NULL)
+    {
+      TimerWheelStop(&HostTest_astWheel[i].stTimer);
+    }
+    memset(&HostTest_astWheel[i], 0, sizeof(HostTest_astWheel[i]));
+    TimerWheelSetup(&HostTest_astWheel[i].stTimer, HostTestWheelCallback, i);
+    HostTest_astWheel[i].u32ExpiresMs = HOST_TEST_NONE;
+    HostTest_astWheel[i].u32FiredMs   = HOST_TEST_NONE;
+  }
+
+  HostTest_u32Fires = 0;
+  TimerWheelRun();
+  HostTestCheck(G_u16TimerWheelActive == 0, "%u wheel timers left running", G_u16TimerWheelActive);
+
+} /* end HostTestWheelReset() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelCallback(u16 u16Index_)
+
+@brief Records a fire and does whatever the timer was set up to do from its call-back.
+
+*/
+static void HostTestWheelCallback(u16 u16Index_)
+{
+  HostTestWheelTimerType* pstTest = &HostTest_astWheel[u16Index_];
+
+  HostTestCheck(!TimerWheelIsActive(&pstTest->stTimer), "timer %u still active in its call-back", u16Index_);
+
+  pstTest->u32FiredMs = TimeBaseMs();
+  pstTest->u32Fires++;
+  pstTest->u32Order = HostTest_u32Fires++;
+
+  if(pstTest->pstStop != NULL)
+  {
+    TimerWheelStop(pstTest->pstStop);
+  }
+
+  if(pstTest->u32Restarts != 0)
+  {
+    pstTest->u32Restarts--;
+    pstTest->u32ExpiresMs = pstTest->u32FiredMs + pstTest->u32RestartMs;
+    TimerWheelStart(&pstTest->stTimer, pstTest->u32RestartMs);
+  }
+
+} /* end HostTestWheelCallback() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelBoundaries(void)
+
+@brief Delays either side of each level's span fire on exactly the right tick.
+
+Each delay is started at several phases of the wheel, so the expiry lands
+both inside and across the level 0, 1 and 2 boundaries (32, 1024 and 32768
+slots).  Time jumps to a tick before the next expiry, with one catch-up run,
+then the wheel is run on the expiry tick itself.
+
+*/
+static void HostTestWheelBoundaries(void)
+{
+  static const u32 au32Delays[] = {1, 2, 31, 32, 33, 63, 64, 1023, 1024, 1025, 2047, 32767, 32768, 32769,
+                                   65535, 65536, TIMER_WHEEL_MAX_DELAY_MS - 1, TIMER_WHEEL_MAX_DELAY_MS};
+  static const u32 au32Phases[] = {0, 1, 30, 31, 1023, 32767};
+  const u8 u8Delays = sizeof(au32Delays) / sizeof(au32Delays[0]);
+  HostTestWheelTimerType* pstTest;
+  u32 u32Start;
+
+  for(u8 p = 0; p < sizeof(au32Phases) / sizeof(au32Phases[0]); p++)
+  {
+    HostTestWheelReset();
+
+    /* Move to the phase within a 32768 tick level 2 slot */
+    HostTestAdvanceMs( ((au32Phases[p] - TimeBaseMs()) & 0x7FFF) + 0x8000 );
+    TimerWheelRun();
+
+    u32Start = TimeBaseMs();
+    for(u8 i = 0; i < u8Delays; i++)
+    {
+      pstTest = &HostTest_astWheel[i];
+      pstTest->u32ExpiresMs = u32Start + au32Delays[i];
+      TimerWheelStart(&pstTest->stTimer, au32Delays[i]);
+    }
+
+    for(u8 i = 0; i < u8Delays; i++)
+    {
+      pstTest = &HostTest_astWheel[i];
+      if(pstTest->u32ExpiresMs - TimeBaseMs() > 1)
+      {
+        HostTestAdvanceMs(pstTest->u32ExpiresMs - TimeBaseMs() - 1);
+        TimerWheelRun();
+        HostTestCheck(pstTest->u32Fires == 0, "phase %u delay %u fired at +%u, early",
+                      au32Phases[p], au32Delays[i], pstTest->u32FiredMs - u32Start);
+      }
+      if(pstTest->u32ExpiresMs != TimeBaseMs())
+      {
+        HostTestAdvanceMs(1);
+        TimerWheelRun();
+      }
+      HostTestCheck( (pstTest->u32Fires == 1) && (pstTest->u32FiredMs == pstTest->u32ExpiresMs),
+                    "phase %u delay %u fired %u times, last at +%u",
+                    au32Phases[p], au32Delays[i], pstTest->u32Fires, pstTest->u32FiredMs - u32Start);
+    }
+  }
+
+} /* end HostTestWheelBoundaries() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelRestart(void)
+
+@brief Timers restarted from their own call-back keep their period, and a
+call-back can stop a timer due on the same tick.
+
+*/
+static void HostTestWheelRestart(void)
+{
+  static const u32 au32Periods[] = {1, 7, 32, 100, 1024, 5000};
+  const u8 u8Periods = sizeof(au32Periods) / sizeof(au32Periods[0]);
+  HostTestWheelTimerType* pstTest;
+  u32 u32Start;
+
+  HostTestWheelReset();
+  u32Start = TimeBaseMs();
+
+  for(u8 i = 0; i < u8Periods; i++)
+  {
+    pstTest = &HostTest_astWheel[i];
+    pstTest->u32Restarts  = 9;
+    pstTest->u32RestartMs = au32Periods[i];
+    pstTest->u32ExpiresMs = u32Start + au32Periods[i];
+    TimerWheelStart(&pstTest->stTimer, au32Periods[i]);
+  }
+
+  /* Two timers due on the same tick; whichever runs first stops the other */
+  HostTest_astWheel[10].pstStop = &HostTest_astWheel[11].stTimer;
+  HostTest_astWheel[11].pstStop = &HostTest_astWheel[10].stTimer;
+  TimerWheelStart(&HostTest_astWheel[10].stTimer, 40);
+  TimerWheelStart(&HostTest_astWheel[11].stTimer, 40);
+
+  for(u32 u32Ms = 0; u32Ms < 10 * 5000 + 10; u32Ms++)
+  {
+    HostTestAdvanceMs(1);
+    TimerWheelRun();
+
+    for(u8 i = 0; i < u8Periods; i++)
+    {
+      pstTest = &HostTest_astWheel[i];
+      if(pstTest->u32FiredMs == TimeBaseMs())
+      {
+        HostTestCheck((pstTest->u32FiredMs - u32Start) == pstTest->u32Fires * au32Periods[i],
+                      "period %u: fire %u at %u", au32Periods[i], pstTest->u32Fires, pstTest->u32FiredMs - u32Start);
+      }
+    }
+  }
+
+  for(u8 i = 0; i < u8Periods; i++)
+  {
+    HostTestCheck(HostTest_astWheel[i].u32Fires == 10, "period %u fired %u times, not 10",
+                  au32Periods[i], HostTest_astWheel[i].u32Fires);
+  }
+  HostTestCheck(HostTest_astWheel[10].u32Fires + HostTest_astWheel[11].u32Fires == 1,
+                "timers stopping each other fired %u and %u times",
+                HostTest_astWheel[10].u32Fires, HostTest_astWheel[11].u32Fires);
+  HostTestCheck(G_u16TimerWheelActive == 0, "%u timers still active", G_u16TimerWheelActive);
+
+} /* end HostTestWheelRestart() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelStop(void)
+
+@brief Stopped timers, at every level, never fire, and the rest are not disturbed.
+
+*/
+static void HostTestWheelStop(void)
+{
+  static const u32 au32Delays[] = {5, 40, 1500, 40000, 300000};
+  const u8 u8Delays = sizeof(au32Delays) / sizeof(au32Delays[0]);
+  u32 u32Start;
+
+  HostTestWheelReset();
+  u32Start = TimeBaseMs();
+
+  /* Even timers are stopped, odd ones share their slots and keep running */
+  for(u8 i = 0; i < 2 * u8Delays; i++)
+  {
+    HostTest_astWheel[i].u32ExpiresMs = u32Start + au32Delays[i / 2];
+    TimerWheelStart(&HostTest_astWheel[i].stTimer, au32Delays[i / 2]);
+  }
+  HostTestCheck(G_u16TimerWheelActive == 2 * u8Delays, "%u timers active after starting %u",
+                G_u16TimerWheelActive, 2 * u8Delays);
+
+  for(u8 i = 0; i < 2 * u8Delays; i += 2)
+  {
+    TimerWheelStop(&HostTest_astWheel[i].stTimer);
+    HostTestCheck(!TimerWheelIsActive(&HostTest_astWheel[i].stTimer), "timer %u active after stop", i);
+  }
+
+  /* Stopping again does nothing */
+  TimerWheelStop(&HostTest_astWheel[0].stTimer);
+  HostTestCheck(G_u16TimerWheelActive == u8Delays, "%u timers active after stopping half", G_u16TimerWheelActive);
+
+  HostTestAdvanceMs(300001);
+  TimerWheelRun();
+
+  for(u8 i = 0; i < 2 * u8Delays; i++)
+  {
+    HostTestCheck(HostTest_astWheel[i].u32Fires == (u32)(i & 1), "timer %u (delay %u) fired %u times",
+                  i, au32Delays[i / 2], HostTest_astWheel[i].u32Fires);
+  }
+  HostTestCheck(G_u16TimerWheelActive == 0, "%u timers still active", G_u16TimerWheelActive);
+
+} /* end HostTestWheelStop() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelCatchUp(void)
+
+@brief After the wheel has lagged, one run fires everything now due, in expiry order, and nothing else.
+
+*/
+static void HostTestWheelCatchUp(void)
+{
+  u32 u32Start;
+  u32 u32Now;
+
+  HostTestWheelReset();
+  u32Start = TimeBaseMs();
+
+  for(u8 i = 0; i < HOST_TEST_TIMERS; i++)
+  {
+    /* Distinct delays so the expiry order is unambiguous */
+    HostTest_astWheel[i].u32ExpiresMs = u32Start + 1 + 37 * (u32)((i * 29) % HOST_TEST_TIMERS);
+    TimerWheelStart(&HostTest_astWheel[i].stTimer, HostTest_astWheel[i].u32ExpiresMs - u32Start);
+  }
+
+  /* Lag 1200 ticks, across level 1 and 2 cascades, then catch up */
+  HostTestAdvanceMs(1200);
+  TimerWheelRun();
+  u32Now = TimeBaseMs();
+
+  for(u8 i = 0; i < HOST_TEST_TIMERS; i++)
+  {
+    if( (s32)(u32Now - HostTest_astWheel[i].u32ExpiresMs) >= 0 )
+    {
+      HostTestCheck(HostTest_astWheel[i].u32Fires == 1, "due timer %u (+%u) fired %u times",
+                    i, HostTest_astWheel[i].u32ExpiresMs - u32Start, HostTest_astWheel[i].u32Fires);
+      for(u8 j = 0; j < HOST_TEST_TIMERS; j++)
+      {
+        if( (HostTest_astWheel[j].u32Fires != 0) &&
+            ((s32)(HostTest_astWheel[j].u32ExpiresMs - HostTest_astWheel[i].u32ExpiresMs) > 0) )
+        {
+          HostTestCheck(HostTest_astWheel[j].u32Order > HostTest_astWheel[i].u32Order,
+                        "timer +%u fired before timer +%u", HostTest_astWheel[j].u32ExpiresMs - u32Start,
+                        HostTest_astWheel[i].u32ExpiresMs - u32Start);
+        }
+      }
+    }
+    else
+    {
+      HostTestCheck(HostTest_astWheel[i].u32Fires == 0, "timer %u (+%u) fired %u ms early",
+                    i, HostTest_astWheel[i].u32ExpiresMs - u32Start, HostTest_astWheel[i].u32ExpiresMs - u32Now);
+    }
+  }
+
+  /* The rest then fire on their own tick */
+  for(u32 u32Ms = 0; u32Ms < 37 * HOST_TEST_TIMERS; u32Ms++)
+  {
+    HostTestAdvanceMs(1);
+    TimerWheelRun();
+  }
+  for(u8 i = 0; i < HOST_TEST_TIMERS; i++)
+  {
+    if( (s32)(u32Now - HostTest_astWheel[i].u32ExpiresMs) < 0 )
+    {
+      HostTestCheck( (HostTest_astWheel[i].u32Fires == 1) &&
+                     (HostTest_astWheel[i].u32FiredMs == HostTest_astWheel[i].u32ExpiresMs),
+                     "timer +%u fired %u times, last at +%u", HostTest_astWheel[i].u32ExpiresMs - u32Start,
+                     HostTest_astWheel[i].u32Fires, HostTest_astWheel[i].u32FiredMs - u32Start);
+    }
+  }
+
+} /* end HostTestWheelCatchUp() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelMaxDelayLagging(void)
+
+@brief A maximum delay started while the wheel lags is capped to the wheel's
+reach and fires there, not early or in a wrapped slot.
+
+*/
+static void HostTestWheelMaxDelayLagging(void)
+{
+  static const u32 au32Lags[] = {1, 31, 32, 1000, 40000};
+  HostTestWheelTimerType* pstTest;
+  u32 u32Start;
+  u32 u32WheelNow;
+
+  for(u8 l = 0; l < sizeof(au32Lags) / sizeof(au32Lags[0]); l++)
+  {
+    HostTestWheelReset();
+    pstTest = &HostTest_astWheel[0];
+
+    /* The wheel is up to date at u32WheelNow, then the system time runs on */
+    u32WheelNow = TimeBaseMs();
+    HostTestAdvanceMs(au32Lags[l]);
+    u32Start = TimeBaseMs();
+    pstTest->u32ExpiresMs = u32WheelNow + TIMER_WHEEL_MAX_DELAY_MS;
+    TimerWheelStart(&pstTest->stTimer, TIMER_WHEEL_MAX_DELAY_MS);
+
+    /* Catch up, then run to a second before the expiry in large steps */
+    while((pstTest->u32ExpiresMs - TimeBaseMs()) > 1000)
+    {
+      TimerWheelRun();
+      HostTestCheck(pstTest->u32Fires == 0, "lag %u: fired at +%u, %u ms early", au32Lags[l],
+                    pstTest->u32FiredMs - u32Start, pstTest->u32ExpiresMs - pstTest->u32FiredMs);
+      if(pstTest->u32Fires != 0)
+      {
+        break;
+      }
+      HostTestAdvanceMs( ((pstTest->u32ExpiresMs - TimeBaseMs() - 1000) > 65536) ? 65536 :
+                         (pstTest->u32ExpiresMs - TimeBaseMs() - 1000) );
+    }
+
+    for(u32 u32Ms = 0; (u32Ms < 1001) && (pstTest->u32Fires == 0); u32Ms++)
+    {
+      HostTestAdvanceMs(1);
+      TimerWheelRun();
+    }
+
+    HostTestCheck( (pstTest->u32Fires == 1) && (pstTest->u32FiredMs == pstTest->u32ExpiresMs),
+                   "lag %u: fired %u times at +%u, expected +%u", au32Lags[l], pstTest->u32Fires,
+                   pstTest->u32FiredMs - u32Start, pstTest->u32ExpiresMs - u32Start);
+  }
+
+} /* end HostTestWheelMaxDelayLagging() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestWheelRandom(void)
+
+@brief Random delays up to the maximum, random starts and stops, and the wheel
+run after random gaps: every timer fires once, on the first run at or after its expiry.
+
+*/
+static void HostTestWheelRandom(void)
+{
+  HostTestWheelTimerType* pstTest;
+  u32 u32LastRunMs;
+  u32 u32Delay;
+  u32 u32Pending = 0;
+  u32 u32Started = 0;
+
+  HostTestWheelReset();
+  u32LastRunMs = TimeBaseMs();
+
+  while( (u32Started < 4 * HOST_TEST_TIMERS) || (u32Pending != 0) )
+  {
+    /* Let the system time run on by a random gap, sometimes none, then start,
+    restart or stop a few timers before the wheel catches up */
+    HostTestAdvanceMs(HostTestRandom(8) == 0 ? 1 + HostTestRandom(70000) : HostTestRandom(3000));
+
+    for(u8 n = 0; (n < 4) && (u32Started < 4 * HOST_TEST_TIMERS); n++)
+    {
+      pstTest = &HostTest_astWheel[HostTestRandom(HOST_TEST_TIMERS)];
+      if(TimerWheelIsActive(&pstTest->stTimer) && (HostTestRandom(4) == 0))
+      {
+        TimerWheelStop(&pstTest->stTimer);
+        pstTest->u32ExpiresMs = HOST_TEST_NONE;
+        continue;
+      }
+
+      u32Delay = (HostTestRandom(2) == 0) ? 1 + HostTestRandom(2000) : 1 + HostTestRandom(TIMER_WHEEL_MAX_DELAY_MS);
+      pstTest->u32Fires = 0;
+      TimerWheelStart(&pstTest->stTimer, u32Delay);
+
+      /* Long delays are capped to what the lagging wheel can reach */
+      if(u32Delay > TIMER_WHEEL_MAX_DELAY_MS - (TimeBaseMs() - u32LastRunMs))
+      {
+        u32Delay = TIMER_WHEEL_MAX_DELAY_MS - (TimeBaseMs() - u32LastRunMs);
+      }
+      pstTest->u32ExpiresMs = TimeBaseMs() + u32Delay;
+      u32Started++;
+    }
+
+    TimerWheelRun();
+
+    u32Pending = 0;
+    for(u8 i = 0; i < HOST_TEST_TIMERS; i++)
+    {
+      pstTest = &HostTest_astWheel[i];
+      if(pstTest->u32ExpiresMs == HOST_TEST_NONE)
+      {
+        HostTestCheck(!TimerWheelIsActive(&pstTest->stTimer), "stopped timer %u running", i);
+        continue;
+      }
+
+      if( (s32)(TimeBaseMs() - pstTest->u32ExpiresMs) >= 0 )
+      {
+        HostTestCheck( (pstTest->u32Fires == 1) && ((s32)(pstTest->u32ExpiresMs - u32LastRunMs) > 0),
+                       "timer %u due at %u fired %u times (runs at %u and %u)", i, pstTest->u32ExpiresMs,
+                       pstTest->u32Fires, u32LastRunMs, TimeBaseMs());
+        pstTest->u32ExpiresMs = HOST_TEST_NONE;
+        pstTest->u32Fires = 0;
+      }
+      else
+      {
+        HostTestCheck(pstTest->u32Fires == 0, "timer %u fired %u ms early", i, pstTest->u32ExpiresMs - TimeBaseMs());
+        u32Pending++;
+      }
+    }
+
+    u32LastRunMs = TimeBaseMs();
+    if(HostTest_u32Failures > 20)
+    {
+      break;
+    }
+  }
+
+  HostTestCheck(G_u16TimerWheelActive == 0, "%u timers still active", G_u16TimerWheelActive);
+
+} /* end HostTestWheelRandom() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Microsecond events (us_timer.c) */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostTestHostUs(void)
+
+@brief Returns the virtual time in whole microseconds, to check UsTimerNow() against.
+
+*/
+static u32 HostTestHostUs(void)
+{
+  return (u32)(HostNow() / HOST_TICKS_PER_US);
+
+} /* end HostTestHostUs() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestUsReset(void)
+
+@brief Stops every test event and clears the records.
+
+*/
+static void HostTestUsReset(void)
+{
+  for(u8 i = 0; i < HOST_TEST_EVENTS; i++)
+  {
+    if(HostTest_astUs[i].stEvent.pfnCallback != NULL)
+    {
+      UsTimerStop(&HostTest_astUs[i].stEvent);
+    }
+    memset(&HostTest_astUs[i], 0, sizeof(HostTest_astUs[i]));
+    UsTimerSetup(&HostTest_astUs[i].stEvent, HostTestUsCallback, i);
+  }
+
+  HostTest_u32Fires = 0;
+  HostTest_u32LateLimitUs = HOST_TEST_US_LATE_MAX;
+
+} /* end HostTestUsReset() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestUsCallback(u16 u16Index_)
+
+@brief Records a fire, checks it against the deadline and re-arms periodic events from it.
+
+Runs in TMR0_ISR.  An event may run up to US_TIMER_REARM_TICKS early, since
+Timer0 can't be loaded that close to its deadline.
+
+*/
+static void HostTestUsCallback(u16 u16Index_)
+{
+  HostTestUsEventType* pstTest = &HostTest_astUs[u16Index_];
+  s32 s32Late;
+
+  pstTest->u32FiredUs = UsTimerNow();
+  pstTest->u64FiredTicks = HostNow();
+  pstTest->u32Fires++;
+  pstTest->u32Order = HostTest_u32Fires++;
+
+  HostTestCheck(pstTest->stEvent.u32DeadlineUs == pstTest->u32DeadlineUs, "event %u ran for deadline %u, not %u",
+                u16Index_, pstTest->stEvent.u32DeadlineUs, pstTest->u32DeadlineUs);
+
+  s32Late = (s32)(pstTest->u32FiredUs - pstTest->u32DeadlineUs);
+  HostTestCheck( (s32Late >= -(s32)US_TIMER_REARM_TICKS) && (s32Late <= (s32)HostTest_u32LateLimitUs),
+                 "event %u fire %u ran %d us after its deadline", u16Index_, pstTest->u32Fires, s32Late);
+
+  if(pstTest->u32Repeats != 0)
+  {
+    pstTest->u32Repeats--;
+    pstTest->u32DeadlineUs += pstTest->u32PeriodUs;
+    UsTimerStartAt(&pstTest->stEvent, pstTest->stEvent.u32DeadlineUs + pstTest->u32PeriodUs);
+  }
+
+} /* end HostTestUsCallback() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestUsOrder(void)
+
+@brief Events run once each, in deadline order with ties in start order, on time.
+
+The delays straddle one Timer0 period (65536us), include deadlines close
+enough to run straight away, and some events are restarted or stopped
+while queued.
+
+*/
+static void HostTestUsOrder(void)
+{
+  static const u32 au32Delays[] = {500, 100, 100, 70000, 65536, 65535, 65537, 3, 1, 0,
+                                   200000, 100, 131072, 2, 40, 1000};
+  const u8 u8Events = sizeof(au32Delays) / sizeof(au32Delays[0]);
+  HostTestUsEventType* pstTest;
+  HostTestUsEventType* pstOther;
+  u32 u32Start;
+
+  HostTestUsReset();
+  u32Start = UsTimerNow();
+
+  for(u8 i = 0; i < u8Events; i++)
+  {
+    pstTest = &HostTest_astUs[i];
+    pstTest->u32DeadlineUs = u32Start + au32Delays[i];
+    pstTest->u32Sequence = i;
+    UsTimerStartAt(&pstTest->stEvent, pstTest->u32DeadlineUs);
+  }
+
+  /* Move one event behind the others due at 100us and another from first 
+  to last, then take one out of the middle */
+  HostTest_astUs[1].u32Sequence = u8Events;
+  UsTimerStartAt(&HostTest_astUs[1].stEvent, HostTest_astUs[1].u32DeadlineUs);
+  HostTest_astUs[14].u32DeadlineUs = u32Start + 300000;
+  UsTimerStartAt(&HostTest_astUs[14].stEvent, HostTest_astUs[14].u32DeadlineUs);
+  UsTimerStop(&HostTest_astUs[15].stEvent);
+
+  HostAdvance( (u64)310000 * HOST_TICKS_PER_US );
+
+  for(u8 i = 0; i < u8Events; i++)
+  {
+    pstTest = &HostTest_astUs[i];
+    HostTestCheck(pstTest->u32Fires == ((i == 15) ? 0 : 1), "event %u (+%u) ran %u times",
+                  i, pstTest->u32DeadlineUs - u32Start, pstTest->u32Fires);
+    if(pstTest->u32Fires == 0)
+    {
+      continue;
+    }
+
+    for(u8 j = 0; j < u8Events; j++)
+    {
+      pstOther = &HostTest_astUs[j];
+      if( (pstOther->u32Fires != 0) && 
+          ( ((s32)(pstOther->u32DeadlineUs - pstTest->u32DeadlineUs) > 0) ||
+            ((pstOther->u32DeadlineUs == pstTest->u32DeadlineUs) && (pstOther->u32Sequence > pstTest->u32Sequence)) ) )
+      {
+        HostTestCheck(pstOther->u32Order > pstTest->u32Order, "event %u (+%u) ran before event %u (+%u)",
+                      j, pstOther->u32DeadlineUs - u32Start, i, pstTest->u32DeadlineUs - u32Start);
+      }
+    }
+  }
+
+} /* end HostTestUsOrder() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestUsPeriodic(void)
+
+@brief Events that re-arm from their own deadline keep their period exactly,
+in UsTimerNow() time and in virtual time.
+
+*/
+static void HostTestUsPeriodic(void)
+{
+  static const u32 au32Periods[] = {50, 250, 1000, 65536, 100000};
+  const u8 u8Events = sizeof(au32Periods) / sizeof(au32Periods[0]);
+  HostTestUsEventType* pstTest;
+  u64 au64StartTicks[sizeof(au32Periods) / sizeof(au32Periods[0])];
+  u32 u32Start;
+  u32 u32Fires;
+  s32 s32Drift;
+
+  HostTestUsReset();
+  u32Start = UsTimerNow();
+
+  for(u8 i = 0; i < u8Events; i++)
+  {
+    pstTest = &HostTest_astUs[i];
+    pstTest->u32PeriodUs   = au32Periods[i];
+    pstTest->u32Repeats    = 1000000 / au32Periods[i];
+    pstTest->u32DeadlineUs = u32Start + au32Periods[i];
+    au64StartTicks[i] = HostNow();
+    UsTimerStartAt(&pstTest->stEvent, pstTest->u32DeadlineUs);
+  }
+
+  /* Two seconds of virtual time, in uneven steps */
+  for(u32 u32Step = 0; u32Step < 2000; u32Step++)
+  {
+    HostAdvance( (u64)(1 + HostTestRandom(1999)) * HOST_TICKS_PER_US );
+  }
+
+  for(u8 i = 0; i < u8Events; i++)
+  {
+    pstTest = &HostTest_astUs[i];
+    u32Fires = 1 + 1000000 / au32Periods[i];
+    HostTestCheck(pstTest->u32Fires == u32Fires, "period %u ran %u times, not %u",
+                  au32Periods[i], pstTest->u32Fires, u32Fires);
+    HostTestCheck(pstTest->u32DeadlineUs == u32Start + u32Fires * au32Periods[i], "period %u last deadline +%u",
+                  au32Periods[i], pstTest->u32DeadlineUs - u32Start);
+
+    /* The microsecond clock itself must not drift from virtual time.  The
+    start was part way through a microsecond, so allow one either way. */
+    s32Drift = (s32)(pstTest->u64FiredTicks - au64StartTicks[i] - (u64)u32Fires * au32Periods[i] * HOST_TICKS_PER_US);
+    HostTestCheck( (s32Drift > -(s32)HOST_TICKS_PER_US) && (s32Drift < (s32)HOST_TICKS_PER_US),
+                   "period %u: last fire %d ticks off in virtual time", au32Periods[i], s32Drift);
+  }
+
+  HostTestCheck(G_u16UsTimerLateMaxUs <= HOST_TEST_US_LATE_MAX, "G_u16UsTimerLateMaxUs is %u", G_u16UsTimerLateMaxUs);
+
+} /* end HostTestUsPeriodic() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestUsNowWrap(void)
+
+@brief UsTimerNow() stays monotonic and in step with virtual time while
+Timer0 wraps and TMR0_ISR has not yet run.
+
+With GIEL masked the wrap sets TMR0IF but the epoch is not moved, as when
+the read in UsTimerNow() lands between the wrap and its ISR.  Time is
+stepped a microsecond at a time across the wrap, then the ISR is let in.
+This is done with Timer0 free-running and again with it loaded for an
+event, which moves the epoch.
+
+*/
+static void HostTestUsNowWrap(void)
+{
+  HostTestUsEventType* pstTest = &HostTest_astUs[0];
+  u32 u32Offset;
+  u32 u32Last;
+  u32 u32Now;
+  u16 u16ToWrap;
+  u8 u8GieSave;
+
+  HostTestUsReset();
+  HostTest_u32LateLimitUs = 16;
+
+  for(u8 u8Pass = 0; u8Pass < 4; u8Pass++)
+  {
+    /* Odd passes wrap at an event's deadline, an odd number of microseconds away */
+    if(u8Pass & 0x01)
+    {
+      pstTest->u32DeadlineUs = UsTimerNow() + 1001 + 2 * u8Pass;
+      UsTimerStartAt(&pstTest->stEvent, pstTest->u32DeadlineUs);
+    }
+
+    u8GieSave = INTCON0bits.GIEL;
+    INTCON0bits.GIEL = 0;
+
+    u16ToWrap = (u16)(0x10000 - (((u16)TMR0H << 8) | TMR0L));
+    if(u16ToWrap > 8)
+    {
+      HostAdvance( (u64)(u16ToWrap - 8) * HOST_TICKS_PER_US );
+    }
+
+    u32Offset = UsTimerNow() - HostTestHostUs();
+    u32Last = UsTimerNow();
+    for(u8 i = 0; i < 32; i++)
+    {
+      HostAdvance(HOST_TICKS_PER_US / 2);
+      u32Now = UsTimerNow();
+      HostTestCheck( (s32)(u32Now - u32Last) >= 0, "pass %u: time went back %u us at step %u",
+                     u8Pass, u32Last - u32Now, i);
+      HostTestCheck( (u32Now - HostTestHostUs() - u32Offset + 1) <= 2, "pass %u: %d us off at step %u, TMR0IF %u",
+                     u8Pass, (s32)(u32Now - HostTestHostUs() - u32Offset), i, PIR3bits.TMR0IF);
+      u32Last = u32Now;
+    }
+
+    HostTestCheck(PIR3bits.TMR0IF, "pass %u: Timer0 did not wrap", u8Pass);
+    INTCON0bits.GIEL = u8GieSave;
+
+    /* TMR0_ISR is taken on the next step and moves the epoch */
+    HostAdvance(HOST_TICKS_PER_US / 2);
+    u32Now = UsTimerNow();
+    HostTestCheck( (s32)(u32Now - u32Last) >= 0, "pass %u: time went back %u us after the ISR", u8Pass, u32Last - u32Now);
+    HostTestCheck( (u32Now - HostTestHostUs() - u32Offset + 1) <= 2, "pass %u: %d us off after the ISR",
+                   u8Pass, (s32)(u32Now - HostTestHostUs() - u32Offset));
+    if(u8Pass & 0x01)
+    {
+      HostTestCheck(pstTest->u32Fires == (u32)((u8Pass + 1) / 2), "pass %u: event ran %u times", u8Pass, pstTest->u32Fires);
+    }
+  }
+
+} /* end HostTestUsNowWrap() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* System time (time_base.c) */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTestTimeBaseUs(void)
+
+@brief TimeBaseUs() never goes backwards and stays within its 8us resolution
+of virtual time, including while the tick interrupt is pending.
+
+Time is first stepped by random amounts with interrupts on, then a
+microsecond at a time across a tick with GIEL masked, so Timer2 has reloaded
+and set TMR2IF but TMR2_ISR has not added the tick.  That pass stops half a
+tick later, before a second tick would be lost.
+
+*/
+static void HostTestTimeBaseUs(void)
+{
+  u64 u64Offset;
+  u64 u64Last;
+  u64 u64Now;
+  s32 s32Behind;
+  u16 u16Pending;
+  u8 u8GieSave;
+
+  /* Both clocks are read part way through a count, so they can differ by up
+  to one count either way */
+  u64Offset = HostNow() / HOST_TICKS_PER_US - TimeBaseUs();
+  u64Last = TimeBaseUs();
+
+  for(u8 u8Pass = 0; u8Pass < 2; u8Pass++)
+  {
+    u8GieSave = INTCON0bits.GIEL;
+    if(u8Pass == 1)
+    {
+      INTCON0bits.GIEL = 0;
+    }
+
+    u16Pending = 0;
+    for(u16 i = 0; (i < 1400) && (u16Pending < 500); i++)
+    {
+      HostAdvance( (u8Pass == 0) ? (1 + HostTestRandom(3 * HOST_TICKS_PER_MS)) : HOST_TICKS_PER_US );
+      if( (u8Pass == 1) && PIR3bits.TMR2IF )
+      {
+        u16Pending++;
+      }
+      u64Now = TimeBaseUs();
+      HostTestCheck(u64Now >= u64Last, "pass %u: time went back %u us at step %u",
+                    u8Pass, (u32)(u64Last - u64Now), i);
+      s32Behind = (s32)(HostNow() / HOST_TICKS_PER_US - u64Offset - u64Now);
+      HostTestCheck( (s32Behind > -(s32)TIME_BASE_US_PER_COUNT) && (s32Behind < (s32)TIME_BASE_US_PER_COUNT),
+                     "pass %u: %d us behind virtual time at step %u, TMR2IF %u", u8Pass, s32Behind, i, PIR3bits.TMR2IF);
+      u64Last = u64Now;
+    }
+
+    if(u8Pass == 1)
+    {
+      HostTestCheck(PIR3bits.TMR2IF, "the tick was not pending");
+      INTCON0bits.GIEL = u8GieSave;
+      HostAdvance(HOST_TICKS_PER_US);
+      u64Now = TimeBaseUs();
+      HostTestCheck(u64Now >= u64Last, "time went back %u us after the tick", (u32)(u64Last - u64Now));
+    }
+  }
+
+} /* end HostTestTimeBaseUs() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
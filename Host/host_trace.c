@@ -0,0 +1,358 @@
+/*!*********************************************************************************************************************
+@file host_trace.c
+@brief Converts the flight recorder trace (trace.c) on an SD card image to Chrome trace-event JSON.
+
+  heart_rate_music_trace [-s sector] card.img > trace.json
+
+-s  first trace sector, default TRACE_SD_SECTOR from configuration.h
+card.img  a dump of the card (dd from a reader, or heart_rate_music_host -s)
+
+Load trace.json in chrome://tracing or ui.perfetto.dev.  Both rings are
+merged by timestamp and shown as tracks of one process:
+
+  main         TRACE_EVENT_MARK
+  low ISRs     SW_ISR, DMA1SCNT_ISR, TMR0_ISR, TMR3_ISR spans
+  sd           a span from each command to its completion
+  audio        song start and stop, buffer fills
+  TMR1_ISR     buffer swaps and underruns
+  heart        beats
+
+Times are microseconds before the freeze, shifted so the oldest event is
+at 0.  The freeze reason goes to stderr and into the JSON's otherData.
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostTrace_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_TRACE_SECTOR_SIZE    512
+#define HOST_TRACE_HEADER_SIZE    16           /* Sector 0 bytes before the high ring */
+#define HOST_TRACE_ENTRIES        (TRACE_LOW_ENTRIES + TRACE_HIGH_ENTRIES)
+
+/* Chrome trace thread ids */
+#define HOST_TRACE_TID_MAIN       1
+#define HOST_TRACE_TID_ISR        2
+#define HOST_TRACE_TID_SD         3
+#define HOST_TRACE_TID_AUDIO      4
+#define HOST_TRACE_TID_TMR1       5
+#define HOST_TRACE_TID_HEART      6
+#define HOST_TRACE_TIDS           7
+
+/*!
+@struct HostTraceEventType
+@brief One entry off the card, with its time relative to the freeze.
+*/
+typedef struct
+{
+  s32 s32Us;                                   /* Negative: before the freeze */
+  u8  u8Event;
+  u8  u8Arg;
+  u16 u16Arg;
+} HostTraceEventType;
+
+static const char* const HostTrace_apcThreads[HOST_TRACE_TIDS] =
+{
+  NULL, "main", "low ISRs", "sd", "audio", "TMR1_ISR", "heart"
+};
+
+/* Indexed by TRACE_ISR_xxx */
+static const char* const HostTrace_apcIsrs[] =
+{
+  "SW_ISR", "DMA1SCNT_ISR", "TMR0_ISR", "TMR3_ISR", "DEFAULT_ISR"
+};
+
+/* Indexed by TRACE_FREEZE_xxx */
+static const char* const HostTrace_apcReasons[] =
+{
+  "not frozen", "request", "underrun", "unhandled interrupt", "stack overflow or underflow reset"
+};
+
+static HostTraceEventType HostTrace_astEvents[HOST_TRACE_ENTRIES];
+static u16 HostTrace_u16Events;
+static u8  HostTrace_au8Open[HOST_TRACE_TIDS];  /* Spans begun and not yet ended on each track */
+static bool HostTrace_bFirstJson;
+
+static u32  HostTraceGet(const u8* pu8Data_, u8 u8Bytes_);
+static void HostTraceAdd(const u8* pu8Entries_, u8 u8Next_, u8 u8Count_, u8 u8Size_, u32 u32FrozenUs_);
+static int  HostTraceCompare(const void* pvA_, const void* pvB_);
+static void HostTraceJson(const char* pcName_, char cPhase_, u8 u8Tid_, s32 s32Ts_, const char* pcArgs_);
+static void HostTraceEvent(const HostTraceEventType* pstEvent_, s32 s32Ts_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn int main(int argc, char* argv[])
+
+@brief Reads the trace sectors from an image and writes the JSON to stdout.
+
+*/
+int main(int argc, char* argv[])
+{
+  const char* pcImage = NULL;
+  u32 u32Sector = TRACE_SD_SECTOR;
+  u8 au8Trace[TRACE_SD_SECTORS * HOST_TRACE_SECTOR_SIZE];
+  u8 u8Reason;
+  u32 u32FrozenUs;
+  s32 s32Oldest;
+  FILE* pFile;
+
+  for(int iOption = 1; iOption < argc; iOption++)
+  {
+    if( (strcmp(argv[iOption], "-s") == 0) && (iOption + 1 < argc) )
+    {
+      u32Sector = (u32)strtoul(argv[++iOption], NULL, 0);
+    }
+    else if( (argv[iOption][0] != '-') && (pcImage == NULL) )
+    {
+      pcImage = argv[iOption];
+    }
+    else
+    {
+      pcImage = NULL;
+      break;
+    }
+  }
+
+  if(pcImage == NULL)
+  {
+    fprintf(stderr, "usage: %s [-s sector] card.img\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  pFile = fopen(pcImage, "rb");
+  if( (pFile == NULL) ||
+      (fseek(pFile, (long)u32Sector * HOST_TRACE_SECTOR_SIZE, SEEK_SET) != 0) ||
+      (fread(au8Trace, 1, sizeof(au8Trace), pFile) != sizeof(au8Trace)) )
+  {
+    fprintf(stderr, "%s: can't read sectors %u-%u of %s\n", argv[0],
+            u32Sector, u32Sector + TRACE_SD_SECTORS - 1, pcImage);
+    return EXIT_FAILURE;
+  }
+  fclose(pFile);
+
+  if( (HostTraceGet(&au8Trace[0], 4) != TRACE_MAGIC) || (au8Trace[4] != TRACE_VERSION) )
+  {
+    fprintf(stderr, "%s: no version %u trace at sector %u\n", argv[0], TRACE_VERSION, u32Sector);
+    return EXIT_FAILURE;
+  }
+
+  u8Reason = au8Trace[5];
+  u32FrozenUs = HostTraceGet(&au8Trace[12], 4);
+  HostTraceAdd(&au8Trace[HOST_TRACE_SECTOR_SIZE], au8Trace[6], au8Trace[7], TRACE_LOW_ENTRIES, u32FrozenUs);
+  HostTraceAdd(&au8Trace[HOST_TRACE_HEADER_SIZE], au8Trace[8], au8Trace[9], TRACE_HIGH_ENTRIES, u32FrozenUs);
+  qsort(HostTrace_astEvents, HostTrace_u16Events, sizeof(HostTraceEventType), HostTraceCompare);
+  s32Oldest = (HostTrace_u16Events != 0) ? HostTrace_astEvents[0].s32Us : 0;
+
+  printf("{\"traceEvents\":[\n");
+  HostTrace_bFirstJson = true;
+  for(u8 u8Tid = 1; u8Tid < HOST_TRACE_TIDS; u8Tid++)
+  {
+    printf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+           HostTrace_bFirstJson ? "" : ",\n", u8Tid, HostTrace_apcThreads[u8Tid]);
+    HostTrace_bFirstJson = false;
+  }
+
+  for(u16 i = 0; i < HostTrace_u16Events; i++)
+  {
+    HostTraceEvent(&HostTrace_astEvents[i], HostTrace_astEvents[i].s32Us - s32Oldest);
+  }
+  HostTraceJson("freeze", 'i', HOST_TRACE_TID_MAIN, -s32Oldest, "\"s\":\"g\"");
+
+  printf("\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"freeze\":\"%s\"}}\n",
+         (u8Reason <= TRACE_FREEZE_STACK) ? HostTrace_apcReasons[u8Reason] : "unknown");
+
+  fprintf(stderr, "%u events over %.3f ms, frozen by %s\n", HostTrace_u16Events, -s32Oldest / 1000.0,
+          (u8Reason <= TRACE_FREEZE_STACK) ? HostTrace_apcReasons[u8Reason] : "unknown");
+
+  return EXIT_SUCCESS;
+
+} /* end main() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostTraceGet(const u8* pu8Data_, u8 u8Bytes_)
+
+@brief Reads a little-endian field of 1 to 4 bytes.
+
+*/
+static u32 HostTraceGet(const u8* pu8Data_, u8 u8Bytes_)
+{
+  u32 u32Value = 0;
+
+  while(u8Bytes_-- != 0)
+  {
+    u32Value = (u32Value << 8) | pu8Data_[u8Bytes_];
+  }
+
+  return u32Value;
+
+} /* end HostTraceGet() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTraceAdd(const u8* pu8Entries_, u8 u8Next_, u8 u8Count_, u8 u8Size_, u32 u32FrozenUs_)
+
+@brief Adds the used entries of one ring, oldest first.
+
+*/
+static void HostTraceAdd(const u8* pu8Entries_, u8 u8Next_, u8 u8Count_, u8 u8Size_, u32 u32FrozenUs_)
+{
+  const u8* pu8Entry;
+  HostTraceEventType* pstEvent;
+
+  if(u8Count_ > u8Size_)
+  {
+    u8Count_ = u8Size_;
+  }
+
+  for(u8 i = 0; i < u8Count_; i++)
+  {
+    pu8Entry = &pu8Entries_[(u8)((u8Next_ - u8Count_ + i) & (u8Size_ - 1)) * sizeof(TraceEntryType)];
+    pstEvent = &HostTrace_astEvents[HostTrace_u16Events++];
+    pstEvent->s32Us   = (s32)(HostTraceGet(&pu8Entry[0], 4) - u32FrozenUs_);
+    pstEvent->u8Event = pu8Entry[4];
+    pstEvent->u8Arg   = pu8Entry[5];
+    pstEvent->u16Arg  = (u16)HostTraceGet(&pu8Entry[6], 2);
+  }
+
+} /* end HostTraceAdd() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static int HostTraceCompare(const void* pvA_, const void* pvB_)
+
+@brief qsort order: by time.
+
+*/
+static int HostTraceCompare(const void* pvA_, const void* pvB_)
+{
+  s32 s32A = ((const HostTraceEventType*)pvA_)->s32Us;
+  s32 s32B = ((const HostTraceEventType*)pvB_)->s32Us;
+
+  return (s32A > s32B) - (s32A < s32B);
+
+} /* end HostTraceCompare() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTraceJson(const char* pcName_, char cPhase_, u8 u8Tid_, s32 s32Ts_, const char* pcArgs_)
+
+@brief Writes one trace event object; pcArgs_ is extra JSON members or NULL.
+
+Span ends with no beginning in the trace are left out.
+
+*/
+static void HostTraceJson(const char* pcName_, char cPhase_, u8 u8Tid_, s32 s32Ts_, const char* pcArgs_)
+{
+  if(cPhase_ == 'B')
+  {
+    HostTrace_au8Open[u8Tid_]++;
+  }
+  else if(cPhase_ == 'E')
+  {
+    if(HostTrace_au8Open[u8Tid_] == 0)
+    {
+      return;
+    }
+    HostTrace_au8Open[u8Tid_]--;
+  }
+
+  printf("%s{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%d%s%s}",
+         HostTrace_bFirstJson ? "" : ",\n", pcName_, cPhase_, u8Tid_, s32Ts_,
+         (pcArgs_ != NULL) ? "," : "", (pcArgs_ != NULL) ? pcArgs_ : "");
+  HostTrace_bFirstJson = false;
+
+} /* end HostTraceJson() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostTraceEvent(const HostTraceEventType* pstEvent_, s32 s32Ts_)
+
+@brief Writes the JSON for one trace entry.
+
+*/
+static void HostTraceEvent(const HostTraceEventType* pstEvent_, s32 s32Ts_)
+{
+  char acName[32];
+  char acArgs[64];
+  const char* pcIsr = (pstEvent_->u8Arg <= TRACE_ISR_DEFAULT) ? HostTrace_apcIsrs[pstEvent_->u8Arg] : "ISR";
+
+  switch(pstEvent_->u8Event)
+  {
+    case TRACE_EVENT_ISR_ENTER:
+      HostTraceJson(pcIsr, 'B', HOST_TRACE_TID_ISR, s32Ts_, NULL);
+      break;
+
+    case TRACE_EVENT_ISR_EXIT:
+      HostTraceJson(pcIsr, 'E', HOST_TRACE_TID_ISR, s32Ts_, NULL);
+      break;
+
+    case TRACE_EVENT_SD_COMMAND:
+      snprintf(acName, sizeof(acName), "CMD%u", pstEvent_->u8Arg);
+      snprintf(acArgs, sizeof(acArgs), "\"args\":{\"address_low\":%u}", pstEvent_->u16Arg);
+      HostTraceJson(acName, 'B', HOST_TRACE_TID_SD, s32Ts_, acArgs);
+      break;
+
+    case TRACE_EVENT_SD_DONE:
+      snprintf(acName, sizeof(acName), "CMD%u", pstEvent_->u8Arg);
+      snprintf(acArgs, sizeof(acArgs), "\"args\":{\"ok\":%u}", pstEvent_->u16Arg);
+      HostTraceJson(acName, 'E', HOST_TRACE_TID_SD, s32Ts_, acArgs);
+      break;
+
+    case TRACE_EVENT_BUFFER_SWAP:
+      snprintf(acName, sizeof(acName), "play buffer %u", pstEvent_->u8Arg);
+      HostTraceJson(acName, 'i', HOST_TRACE_TID_TMR1, s32Ts_, "\"s\":\"t\"");
+      break;
+
+    case TRACE_EVENT_UNDERRUN:
+      snprintf(acName, sizeof(acName), "underrun in buffer %u", pstEvent_->u8Arg);
+      HostTraceJson(acName, 'i', HOST_TRACE_TID_TMR1, s32Ts_, "\"s\":\"p\"");
+      break;
+
+    case TRACE_EVENT_BUFFER_FILLED:
+      snprintf(acName, sizeof(acName), "filled buffer %u", pstEvent_->u8Arg);
+      snprintf(acArgs, sizeof(acArgs), "\"s\":\"t\",\"args\":{\"sector_low\":%u}", pstEvent_->u16Arg);
+      HostTraceJson(acName, 'i', HOST_TRACE_TID_AUDIO, s32Ts_, acArgs);
+      break;
+
+    case TRACE_EVENT_BEAT:
+      snprintf(acArgs, sizeof(acArgs), "\"s\":\"t\",\"args\":{\"timestamp\":%u}", pstEvent_->u16Arg);
+      HostTraceJson("beat", 'i', HOST_TRACE_TID_HEART, s32Ts_, acArgs);
+      break;
+
+    case TRACE_EVENT_SONG_START:
+      snprintf(acArgs, sizeof(acArgs), "\"s\":\"t\",\"args\":{\"sector_low\":%u}", pstEvent_->u16Arg);
+      HostTraceJson("song start", 'i', HOST_TRACE_TID_AUDIO, s32Ts_, acArgs);
+      break;
+
+    case TRACE_EVENT_SONG_STOP:
+      HostTraceJson("song stop", 'i', HOST_TRACE_TID_AUDIO, s32Ts_, "\"s\":\"t\"");
+      break;
+
+    default:
+      snprintf(acName, sizeof(acName), "event 0x%02X", pstEvent_->u8Event);
+      snprintf(acArgs, sizeof(acArgs), "\"s\":\"t\",\"args\":{\"arg\":%u,\"arg16\":%u}",
+               pstEvent_->u8Arg, pstEvent_->u16Arg);
+      HostTraceJson((pstEvent_->u8Event == TRACE_EVENT_MARK) ? "mark" : acName, 'i',
+                    HOST_TRACE_TID_MAIN, s32Ts_, acArgs);
+      break;
+  }
+
+} /* end HostTraceEvent() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
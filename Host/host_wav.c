@@ -0,0 +1,540 @@
+/*!*********************************************************************************************************************
+@file host_wav.c
+@brief Captures DAC1 output on the host and renders it to an 8-bit WAV at the nominal sample rate.
+
+Every DAC write arrives here with its virtual time (HostWavDac is called from
+a DAC listener).  The output is sampled in the middle of each nominal
+sample period, holding the last value written, so a write that is early or
+late by less than half a period still lands in the right sample.  DAC1 is
+8-bit and the firmware writes unsigned samples, which is exactly WAV's
+8-bit PCM format.
+
+The interval between consecutive sample writes is also measured against
+the nominal period.  Only writes made while the sample timer runs count; the
+firmware also sets the DAC to silence at reset, start-up and stop, and those
+writes are rendered but would otherwise show up as dropouts and jitter.
+
+- within half a period of it: a regular sample; its deviation is jitter
+- up to HOST_WAV_PAUSE_TICKS: a dropout; the whole periods missed are counted
+- longer: a pause, where playback was stopped (between songs, say)
+
+HostWavCompare checks the rendered samples against a golden WAV, bit for
+bit or within a tolerance, so changes to the streaming path can be shown
+not to change the sound.  HostWavLoad reads a mono WAV for the tools that
+build card images.
+
+------------------------------------------------------------------------------------------------------------------------
+PUBLIC FUNCTIONS
+- bool HostWavBegin(u32 u32RateHz_)
+- void HostWavDac(u64 u64Time_, u8 u8Value_, bool bSample_)
+- void HostWavEnd(u64 u64Time_)
+- const HostWavStatsType* HostWavStats(void)
+- bool HostWavSave(const char* pcPath_)
+- bool HostWavCompare(const char* pcGolden_, u8 u8Tolerance_, HostWavCompareType* pstResult_)
+- s16* HostWavLoad(const char* pcPath_, u32* pu32Rate_, u32* pu32Samples_)
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "HostWav_<type>" and be declared as static.
+***********************************************************************************************************************/
+#define HOST_WAV_HEADER_SIZE      (u8)44
+#define HOST_WAV_GROW             (u32)(1u << 20)
+
+static u32  HostWav_u32Rate;                              /*!< @brief Nominal sample rate, 0 when not capturing */
+static bool HostWav_bStarted;                             /*!< @brief The first write has set the time origin */
+static u64  HostWav_u64Origin;                            /*!< @brief Virtual time of the first write */
+static u64  HostWav_u64LastWrite;
+static bool HostWav_bLastSample;                          /*!< @brief The last write was a sample write */
+static u8   HostWav_u8Value;                              /*!< @brief DAC output being held */
+
+static u8*  HostWav_pu8Samples;                           /*!< @brief Rendered output */
+static u32  HostWav_u32Samples;
+static u32  HostWav_u32Capacity;
+
+static double HostWav_dJitterSquares;                     /*!< @brief Sum of squared deviations, in ticks */
+static int64_t  HostWav_s64JitterSum;
+static HostWavStatsType HostWav_stStats;
+
+static u64  HostWavPeriodTicks(void);
+static void HostWavRenderTo(u64 u64Time_);
+static void HostWavPut32(u8* pu8Dest_, u32 u32Value_);
+static u32  HostWavGet32(const u8* pu8Source_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostWavBegin(u32 u32RateHz_)
+
+@brief Starts a capture at a nominal rate of u32RateHz_ samples per second.
+
+Requires:
+- 0 < u32RateHz_ <= HOST_TICKS_PER_S / 2
+
+Promises:
+- Returns true and clears any earlier capture, or false if the rate is unusable
+- The first DAC write from then on is the time origin of the WAV
+
+*/
+bool HostWavBegin(u32 u32RateHz_)
+{
+  if( (u32RateHz_ == 0) || (u32RateHz_ > HOST_TICKS_PER_S / 2) )
+  {
+    return false;
+  }
+
+  HostWav_u32Rate = u32RateHz_;
+  HostWav_bStarted = false;
+  HostWav_bLastSample = false;
+  HostWav_u32Samples = 0;
+  HostWav_dJitterSquares = 0.0;
+  HostWav_s64JitterSum = 0;
+  memset(&HostWav_stStats, 0, sizeof(HostWav_stStats));
+  HostWav_stStats.u32Rate = u32RateHz_;
+
+  return true;
+
+} /* end HostWavBegin() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostWavDac(u64 u64Time_, u8 u8Value_, bool bSample_)
+
+@brief Records one DAC write; call it from the DAC listener.
+
+Requires:
+- Writes arrive in time order
+- bSample_ is true for writes made by the sample timer
+
+Promises:
+- Samples due before u64Time_ are rendered with the value held until now
+- If this write and the last one are both sample writes, the interval 
+  between them is classed and measured
+
+*/
+void HostWavDac(u64 u64Time_, u8 u8Value_, bool bSample_)
+{
+  u64 u64Period;
+  u64 u64Interval;
+  int64_t s64Deviation;
+
+  if(HostWav_u32Rate == 0)
+  {
+    return;
+  }
+
+  u64Period = HostWavPeriodTicks();
+
+  HostWav_stStats.u32Writes++;
+
+  if(!HostWav_bStarted)
+  {
+    HostWav_bStarted = true;
+    HostWav_u64Origin = u64Time_;
+    HostWav_u64LastWrite = u64Time_;
+    HostWav_bLastSample = bSample_;
+    HostWav_u8Value = u8Value_;
+    return;
+  }
+
+  HostWavRenderTo(u64Time_);
+
+  /* Silence set outside playback, and the first sample after it, are not timed */
+  if(bSample_ && HostWav_bLastSample)
+  {
+    u64Interval = u64Time_ - HostWav_u64LastWrite;
+    if(u64Interval > HOST_WAV_PAUSE_TICKS)
+    {
+      HostWav_stStats.u32Pauses++;
+    }
+    else if(u64Interval > u64Period + u64Period / 2)
+    {
+      HostWav_stStats.u32Dropouts++;
+      HostWav_stStats.u32MissedSamples += (u32)((u64Interval + u64Period / 2) / u64Period) - 1;
+    }
+    else if(u64Interval >= u64Period / 2)
+    {
+      s64Deviation = (int64_t)u64Interval - (int64_t)u64Period;
+      HostWav_s64JitterSum += s64Deviation;
+      HostWav_dJitterSquares += (double)s64Deviation * (double)s64Deviation;
+      HostWav_stStats.u32Regular++;
+
+      if(llabs(s64Deviation) > (int64_t)HostWav_stStats.u64MaxJitterTicks)
+      {
+        HostWav_stStats.u64MaxJitterTicks = (u64)llabs(s64Deviation);
+      }
+    }
+    else
+    {
+      /* Two writes within the same sample period; only the later one is heard */
+      HostWav_stStats.u32Early++;
+    }
+  }
+
+  HostWav_u64LastWrite = u64Time_;
+  HostWav_bLastSample = bSample_;
+  HostWav_u8Value = u8Value_;
+
+} /* end HostWavDac() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void HostWavEnd(u64 u64Time_)
+
+@brief Ends the capture at virtual time u64Time_ and works out the statistics.
+
+Requires:
+- HostWavBegin called
+
+Promises:
+- Samples up to u64Time_ are rendered and HostWavStats() is final
+
+*/
+void HostWavEnd(u64 u64Time_)
+{
+  if(HostWav_u32Rate == 0)
+  {
+    return;
+  }
+
+  if(HostWav_bStarted)
+  {
+    HostWavRenderTo(u64Time_);
+  }
+
+  HostWav_stStats.u32Samples = HostWav_u32Samples;
+  if(HostWav_stStats.u32Regular != 0)
+  {
+    HostWav_stStats.dMeanPeriodTicks = (double)HostWavPeriodTicks() +
+                                       (double)HostWav_s64JitterSum / HostWav_stStats.u32Regular;
+    HostWav_stStats.dRmsJitterTicks = sqrt(HostWav_dJitterSquares / HostWav_stStats.u32Regular);
+  }
+
+  HostWav_u32Rate = 0;
+
+} /* end HostWavEnd() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn const HostWavStatsType* HostWavStats(void)
+
+@brief Returns the capture statistics; final after HostWavEnd.
+
+*/
+const HostWavStatsType* HostWavStats(void)
+{
+  return &HostWav_stStats;
+
+} /* end HostWavStats() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostWavSave(const char* pcPath_)
+
+@brief Writes the rendered samples to pcPath_ as a mono 8-bit PCM WAV.
+
+*/
+bool HostWavSave(const char* pcPath_)
+{
+  u8 au8Header[HOST_WAV_HEADER_SIZE];
+  u32 u32Rate = HostWav_stStats.u32Rate;
+  FILE* pFile;
+  bool bOk;
+
+  memcpy(&au8Header[0], "RIFF", 4);
+  HostWavPut32(&au8Header[4], 36 + HostWav_u32Samples);
+  memcpy(&au8Header[8], "WAVEfmt ", 8);
+  HostWavPut32(&au8Header[16], 16);
+  HostWavPut32(&au8Header[20], 0x00010001);     /* PCM, 1 channel */
+  HostWavPut32(&au8Header[24], u32Rate);
+  HostWavPut32(&au8Header[28], u32Rate);        /* Bytes per second */
+  HostWavPut32(&au8Header[32], 0x00080001);     /* 1 byte per frame, 8 bits */
+  memcpy(&au8Header[36], "data", 4);
+  HostWavPut32(&au8Header[40], HostWav_u32Samples);
+
+  pFile = fopen(pcPath_, "wb");
+  if(pFile == NULL)
+  {
+    return false;
+  }
+
+  bOk = (fwrite(au8Header, 1, sizeof(au8Header), pFile) == sizeof(au8Header)) &&
+        (fwrite(HostWav_pu8Samples, 1, HostWav_u32Samples, pFile) == HostWav_u32Samples);
+
+  /* RIFF chunks are padded to an even length */
+  if(bOk && (HostWav_u32Samples & 1))
+  {
+    bOk = (fputc(0, pFile) != EOF);
+  }
+
+  return (fclose(pFile) == 0) && bOk;
+
+} /* end HostWavSave() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool HostWavCompare(const char* pcGolden_, u8 u8Tolerance_, HostWavCompareType* pstResult_)
+
+@brief Compares the rendered samples with a golden WAV.
+
+Requires:
+- pcGolden_ is a mono PCM WAV, usually 8-bit as HostWavSave writes
+- HostWavEnd called
+
+Promises:
+- Fills *pstResult_; returns true if the golden file has the same rate and
+  length and no sample differs by more than u8Tolerance_
+- Returns false with pstResult_->bReadable false if the file can't be used
+
+*/
+bool HostWavCompare(const char* pcGolden_, u8 u8Tolerance_, HostWavCompareType* pstResult_)
+{
+  u32 u32Rate;
+  u32 u32Samples;
+  s16* ps16Golden;
+  u8 u8Error;
+
+  memset(pstResult_, 0, sizeof(*pstResult_));
+  pstResult_->u32Samples = HostWav_u32Samples;
+
+  ps16Golden = HostWavLoad(pcGolden_, &u32Rate, &u32Samples);
+  if(ps16Golden == NULL)
+  {
+    return false;
+  }
+
+  pstResult_->bReadable = true;
+  pstResult_->u32GoldenRate = u32Rate;
+  pstResult_->u32GoldenSamples = u32Samples;
+  pstResult_->u32FirstDifference = UINT32_MAX;
+
+  for(u32 i = 0; (i < u32Samples) && (i < HostWav_u32Samples); i++)
+  {
+    u8Error = (u8)abs((int)HostWav_pu8Samples[i] - (((int)ps16Golden[i] >> 8) + 128));
+    if(u8Error != 0)
+    {
+      if(pstResult_->u32Differences++ == 0)
+      {
+        pstResult_->u32FirstDifference = i;
+      }
+      if(u8Error > pstResult_->u8MaxError)
+      {
+        pstResult_->u8MaxError = u8Error;
+      }
+    }
+  }
+  free(ps16Golden);
+
+  return (u32Rate == HostWav_stStats.u32Rate) && (u32Samples == HostWav_u32Samples) &&
+         (pstResult_->u8MaxError <= u8Tolerance_);
+
+} /* end HostWavCompare() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn s16* HostWavLoad(const char* pcPath_, u32* pu32Rate_, u32* pu32Samples_)
+
+@brief Reads a mono 8-bit or 16-bit PCM WAV as signed 16-bit samples.
+
+Requires:
+- NONE
+
+Promises:
+- Returns the samples in a malloc'd buffer the caller frees, with the rate
+  and count in *pu32Rate_ and *pu32Samples_; 8-bit samples are scaled up
+  so their high byte is the original less 128
+- Returns NULL if the file can't be read or isn't mono 8 or 16-bit PCM
+
+*/
+s16* HostWavLoad(const char* pcPath_, u32* pu32Rate_, u32* pu32Samples_)
+{
+  u8 au8Chunk[8];
+  u8 au8Format[16];
+  u32 u32ChunkSize;
+  u8 u8Bits = 0;
+  u8* pu8Data = NULL;
+  s16* ps16Samples = NULL;
+  u32 u32Samples = 0;
+  FILE* pFile;
+
+  pFile = fopen(pcPath_, "rb");
+  if(pFile == NULL)
+  {
+    return NULL;
+  }
+
+  /* RIFF header, then chunks until "data" */
+  if( (fread(au8Chunk, 1, 8, pFile) != 8) || (memcmp(au8Chunk, "RIFF", 4) != 0) ||
+      (fread(au8Chunk, 1, 4, pFile) != 4) || (memcmp(au8Chunk, "WAVE", 4) != 0) )
+  {
+    fclose(pFile);
+    return NULL;
+  }
+
+  while(fread(au8Chunk, 1, 8, pFile) == 8)
+  {
+    u32ChunkSize = HostWavGet32(&au8Chunk[4]);
+
+    if( (memcmp(au8Chunk, "fmt ", 4) == 0) && (u32ChunkSize >= sizeof(au8Format)) &&
+        (fread(au8Format, 1, sizeof(au8Format), pFile) == sizeof(au8Format)) )
+    {
+      /* PCM, 1 channel, 8 or 16 bits */
+      u8Bits = 0;
+      if( (HostWavGet32(&au8Format[0]) == 0x00010001) && ((au8Format[14] == 8) || (au8Format[14] == 16)) )
+      {
+        u8Bits = au8Format[14];
+      }
+      *pu32Rate_ = HostWavGet32(&au8Format[4]);
+      fseek(pFile, (long)((u32ChunkSize - sizeof(au8Format)) + (u32ChunkSize & 1)), SEEK_CUR);
+    }
+    else if( (memcmp(au8Chunk, "data", 4) == 0) && (u8Bits != 0) )
+    {
+      pu8Data = malloc(u32ChunkSize ? u32ChunkSize : 1);
+      if( (pu8Data == NULL) || (fread(pu8Data, 1, u32ChunkSize, pFile) != u32ChunkSize) )
+      {
+        free(pu8Data);
+        pu8Data = NULL;
+      }
+      break;
+    }
+    else
+    {
+      fseek(pFile, (long)(u32ChunkSize + (u32ChunkSize & 1)), SEEK_CUR);
+    }
+  }
+  fclose(pFile);
+
+  if(pu8Data == NULL)
+  {
+    return NULL;
+  }
+
+  u32Samples = u32ChunkSize / (u8Bits / 8);
+  ps16Samples = malloc((u32Samples ? u32Samples : 1) * sizeof(s16));
+  if(ps16Samples != NULL)
+  {
+    for(u32 i = 0; i < u32Samples; i++)
+    {
+      if(u8Bits == 8)
+      {
+        ps16Samples[i] = (s16)(((int)pu8Data[i] - 128) * 256);
+      }
+      else
+      {
+        ps16Samples[i] = (s16)(pu8Data[2 * i] | (pu8Data[2 * i + 1] << 8));
+      }
+    }
+    *pu32Samples_ = u32Samples;
+  }
+  free(pu8Data);
+
+  return ps16Samples;
+
+} /* end HostWavLoad() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u64 HostWavPeriodTicks(void)
+
+@brief Returns the nominal sample period in whole virtual ticks, for classing intervals.
+
+*/
+static u64 HostWavPeriodTicks(void)
+{
+  return HOST_TICKS_PER_S / HostWav_u32Rate;
+
+} /* end HostWavPeriodTicks() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostWavRenderTo(u64 u64Time_)
+
+@brief Renders the held value into every sample whose centre is before u64Time_.
+
+Sample n is centred at origin + (n + 1/2) periods, computed from n each time
+so fractional periods (44.1kHz, say) don't drift.
+
+*/
+static void HostWavRenderTo(u64 u64Time_)
+{
+  u64 u64Centre;
+  u8* pu8Grown;
+
+  for(;;)
+  {
+    u64Centre = HostWav_u64Origin + ((2 * (u64)HostWav_u32Samples + 1) * HOST_TICKS_PER_S) / (2 * HostWav_u32Rate);
+    if(u64Centre >= u64Time_)
+    {
+      return;
+    }
+
+    if(HostWav_u32Samples == HostWav_u32Capacity)
+    {
+      pu8Grown = realloc(HostWav_pu8Samples, HostWav_u32Capacity + HOST_WAV_GROW);
+      if(pu8Grown == NULL)
+      {
+        fprintf(stderr, "host: out of memory for the WAV capture\n");
+        exit(EXIT_FAILURE);
+      }
+      HostWav_pu8Samples = pu8Grown;
+      HostWav_u32Capacity += HOST_WAV_GROW;
+    }
+
+    HostWav_pu8Samples[HostWav_u32Samples++] = HostWav_u8Value;
+  }
+
+} /* end HostWavRenderTo() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void HostWavPut32(u8* pu8Dest_, u32 u32Value_)
+
+@brief Stores a little-endian 32-bit value.
+
+*/
+static void HostWavPut32(u8* pu8Dest_, u32 u32Value_)
+{
+  for(u8 i = 0; i < 4; i++)
+  {
+    pu8Dest_[i] = (u8)(u32Value_ >> (8 * i));
+  }
+
+} /* end HostWavPut32() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 HostWavGet32(const u8* pu8Source_)
+
+@brief Loads a little-endian 32-bit value.
+
+*/
+static u32 HostWavGet32(const u8* pu8Source_)
+{
+  return (u32)pu8Source_[0] | ((u32)pu8Source_[1] << 8) | ((u32)pu8Source_[2] << 16) | ((u32)pu8Source_[3] << 24);
+
+} /* end HostWavGet32() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
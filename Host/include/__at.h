@@ -0,0 +1,7 @@
+/* Host build: registers are placed by the generated host_sfr.s, not __at() */
+#ifndef __AT_H
+#define __AT_H
+
+#define __at(ADDRESS)
+
+#endif /* __AT_H */
@@ -0,0 +1,41 @@
+/*!*********************************************************************************************************************
+@file xc.h                                                                
+@brief Host build stand-in for the XC8 <xc.h>.
+
+Found ahead of SDCard_Interface/xc.h through the Makefile's include order.
+Maps the XC8 keywords and intrinsics the firmware uses onto plain C and the
+host CPU model in host_cpu.c.
+
+**********************************************************************************************************************/
+
+#ifndef _XC_H_
+#define _XC_H_
+
+#include <stdint.h>
+
+/* XC8 types used by pic18f27q43.h.  A 24-bit register is 4 bytes here, so
+   writing one also writes the register after it. */
+#define __bit                     _Bool
+#define __uint24                  uint32_t
+#define __int24                   int32_t
+
+/* ISRs become ordinary functions that host_cpu.c calls */
+#define __interrupt(...)
+
+/* RAM isn't kept over a reset on the host; every run starts from zero */
+#define __persistent
+
+/* Instruction intrinsics.  NOP is where a pending interrupt gets taken. */
+void HostNop(void);
+void HostSleep(void);
+
+#define __nop()                   HostNop()
+#define NOP()                     HostNop()
+#define SLEEP()                   HostSleep()
+#define CLRWDT()                  ((void)0)
+
+
+#endif /* _XC_H_ */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,44 @@
+# Generates host_sfr.s from pic18f27q43.h for the host build.
+#
+# Each register declaration
+#   extern volatile <type> NAME __at(0xADDR);
+# becomes a global symbol at HostSfr + ADDR, so LATA and LATAbits (and
+# every other pair of names for one address) share the same byte, as they
+# do on the part.  Single-bit __bit symbols are skipped; the firmware uses
+# the bitfield structs instead.
+
+function hex(text,    i, value) {
+  value = 0
+  text = toupper(substr(text, 3))
+  for (i = 1; i <= length(text); i++)
+    value = value * 16 + index("0123456789ABCDEF", substr(text, i, 1)) - 1
+  return value
+}
+
+/^extern volatile/ && /__at\(0x/ && !/__bit/ {
+  match($0, /__at\(0x[0-9A-Fa-f]+\)/)
+  address = substr($0, RSTART + 5, RLENGTH - 6)
+  name = $(NF - 1)
+  if (!(name in seen)) {
+    seen[name] = 1
+    names[++count] = name
+    addresses[count] = address
+    value = hex(address)
+    if (value > top) top = value
+  }
+}
+
+END {
+  print "# Generated by sfr.awk from pic18f27q43.h - do not edit"
+  print "\t.bss"
+  print "\t.balign 16"
+  print "\t.globl HostSfr"
+  print "HostSfr:"
+  # 4 spare bytes so a 24-bit register at the top of the map stays inside
+  printf "\t.zero 0x%X\n", top + 5
+  for (i = 1; i <= count; i++) {
+    print "\t.globl " names[i]
+    print "\t.set " names[i] ", HostSfr + " addresses[i]
+  }
+  print "\t.section .note.GNU-stack,\"\",@progbits"
+}
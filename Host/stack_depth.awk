@@ -0,0 +1,132 @@
+# Worst-case hardware return stack depth from an XC8 listing, for the
+# firmware build (see .build-post in the top level Makefile).
+#
+#   awk -v levels=31 -v margin=4 -f stack_depth.awk Heart-Rate-Music.production.lst
+#
+# The listing ends with the compiler's call graph, one tree per root, each
+# call indented two spaces under its caller and function pointer calls
+# already resolved to their targets:
+#
+#  Call Graph Graphs:
+#
+#  _main (ROOT)
+#    _SchedulerRun
+#      _AudioRun
+#
+# A root is main() or an interrupt function; the comment block above each
+# function in the listing says which interrupt level calls it (2 is high
+# priority).  A call or an interrupt takes one level, so the worst case is
+# the deepest path under main, plus one for the low priority vector and the
+# deepest low priority ISR, plus one for the high priority vector and the
+# deepest high priority ISR, which can interrupt it.  Other roots are
+# functions the compiler saw no caller for; they are counted as called
+# straight from main.
+#
+# Prints the three paths and the total, and exits 1 if fewer than margin of
+# the levels are left over, the listing has no call graph, or anything is
+# recursive.  The map file has no call information, so only the listing is
+# read.
+
+BEGIN {
+  if (levels == "") levels = 31
+  if (margin == "") margin = 4
+}
+
+# The call graph, after the listing proper
+/^ Call Graph Graphs:/ {
+  graph = 1
+  graphs++
+  next
+}
+
+graph && (/^ Address spaces:/ || /^[^ ]/) {
+  graph = 0
+}
+
+graph {
+  if (NF == 0) next
+  indent = match($0, /[^ ]/) - 1
+  if ($2 == "(ROOT)") {
+    root = $1
+    base = indent
+    if (!(root in deepest)) {
+      roots[++root_count] = root
+      depth_of[root] = 0
+      deepest[root] = root
+    }
+  }
+  depth = int((indent - base) / 2)
+  path[depth] = $1
+  for (i = 0; i < depth; i++) {
+    if (path[i] == $1) recursive[$1] = 1
+  }
+  if (depth > depth_of[root]) {
+    depth_of[root] = depth
+    deepest[root] = path[0]
+    for (i = 1; i <= depth; i++) deepest[root] = deepest[root] " > " path[i]
+  }
+  next
+}
+
+# Function comment blocks: which interrupt level calls each function
+/;; \*+ function _[A-Za-z0-9_]+ \*+/ {
+  match($0, /function _[A-Za-z0-9_]+/)
+  function_name = substr($0, RSTART + 9, RLENGTH - 9)
+  called_by = 0
+  next
+}
+
+/;; This function is called by:/ {
+  called_by = 1
+  next
+}
+
+called_by && /;;\t\t/ {
+  if (match($0, /Interrupt level [0-9]+/))
+    level[function_name] = substr($0, RSTART + 16, RLENGTH - 16) + 0
+  next
+}
+
+{
+  called_by = 0
+}
+
+END {
+  if (graphs == 0) {
+    print "stack: no call graph in " FILENAME > "/dev/stderr"
+    exit 1
+  }
+
+  main_levels = depth_of["_main"]
+  main_path = deepest["_main"]
+  for (r = 1; r <= root_count; r++) {
+    name = roots[r]
+    if (name == "_main") continue
+    used = 1 + depth_of[name]
+    if (level[name] == 2) {
+      if (used > high_levels) { high_levels = used; high_path = deepest[name] }
+    } else if (level[name] == 1) {
+      if (used > low_levels) { low_levels = used; low_path = deepest[name] }
+    } else {
+      print "stack: no caller seen for " name ", counted as called from _main" > "/dev/stderr"
+      if (used > main_levels) { main_levels = used; main_path = "_main > " deepest[name] }
+    }
+  }
+
+  worst = main_levels + low_levels + high_levels
+  printf "stack: main      %2d  %s\n", main_levels, main_path
+  printf "stack: low ISR   %2d  %s\n", low_levels, low_levels ? "vector > " low_path : "none"
+  printf "stack: high ISR  %2d  %s\n", high_levels, high_levels ? "vector > " high_path : "none"
+  printf "stack: worst case %d of %d levels, %d spare\n", worst, levels, levels - worst
+
+  failed = 0
+  for (name in recursive) {
+    print "stack: " name " is recursive, depth unbounded" > "/dev/stderr"
+    failed = 1
+  }
+  if (levels - worst < margin) {
+    printf "stack: fewer than %d levels spare\n", margin > "/dev/stderr"
+    failed = 1
+  }
+  exit failed
+}
@@ -0,0 +1,288 @@
+/*!*********************************************************************************************************************
+@file adpcm.c
+@brief Table-driven IMA-ADPCM decoder for 4-bit tracks on the card.
+
+IMA-ADPCM stores each sample as a 4-bit code: a sign and a 3-bit magnitude
+in units of a step size that adapts to the signal.  That is 1017 samples
+per 512-byte sector against 512 of 8-bit PCM, so a track needs half the
+card reads and SPI time per second.
+
+Every sector is a self-contained block (see adpcm.h): its header holds the
+first sample and the step index, so decoding can start at any sector.  The
+host image builder (Host/host_image.c) encodes tracks in this format.
+
+The reference decoder works out each difference by shifting and adding the
+step size.  Here Adpcm_au16Diff[][] holds the result for every step index
+and magnitude, made ahead of time with the same shifts, so the output is
+bit-exact with the reference and a sample costs a table read, a 16-bit add
+or subtract with a clamp and an index update.  The predictor is kept in
+offset binary, so the clamp needs no 32-bit arithmetic and its high byte is
+the unsigned 8-bit DAC sample.
+
+audio.c decodes in the main loop, a chunk of samples at a time, into the
+buffers the sample ISR plays; nothing here runs in an interrupt.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- NONE
+
+CONSTANTS
+- ADPCM_BLOCK_SIZE, ADPCM_HEADER_SIZE, ADPCM_BLOCK_SAMPLES
+- ADPCM_STEP_INDEX_MAX
+
+TYPES
+- AdpcmStateType
+
+PUBLIC FUNCTIONS
+- bool AdpcmBlockBegin(AdpcmStateType* pstState_, const u8* pu8Block_)
+- void AdpcmDecode(AdpcmStateType* pstState_, const u8* pu8Block_, u16 u16Sample_, u8* pu8Output_, u16 u16Count_)
+
+PROTECTED FUNCTIONS
+- NONE
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Adpcm"
+***********************************************************************************************************************/
+/* New variables */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Adpcm_<type>" and be declared as static.
+***********************************************************************************************************************/
+/*! @brief Step index change for each code magnitude */
+static const s8 Adpcm_as8IndexStep[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/*! @brief Difference for each step index and code magnitude n:
+(step >> 3) + (n & 4 ? step : 0) + (n & 2 ? step >> 1 : 0) + (n & 1 ? step >> 2 : 0) */
+static const u16 Adpcm_au16Diff[ADPCM_STEP_INDEX_MAX + 1][8] =
+{
+  {    0,     1,     3,     4,     7,     8,    10,    11},   /*  0: step     7 */
+  {    1,     3,     5,     7,     9,    11,    13,    15},   /*  1: step     8 */
+  {    1,     3,     5,     7,    10,    12,    14,    16},   /*  2: step     9 */
+  {    1,     3,     6,     8,    11,    13,    16,    18},   /*  3: step    10 */
+  {    1,     3,     6,     8,    12,    14,    17,    19},   /*  4: step    11 */
+  {    1,     4,     7,    10,    13,    16,    19,    22},   /*  5: step    12 */
+  {    1,     4,     7,    10,    14,    17,    20,    23},   /*  6: step    13 */
+  {    1,     4,     8,    11,    15,    18,    22,    25},   /*  7: step    14 */
+  {    2,     6,    10,    14,    18,    22,    26,    30},   /*  8: step    16 */
+  {    2,     6,    10,    14,    19,    23,    27,    31},   /*  9: step    17 */
+  {    2,     6,    11,    15,    21,    25,    30,    34},   /* 10: step    19 */
+  {    2,     7,    12,    17,    23,    28,    33,    38},   /* 11: step    21 */
+  {    2,     7,    13,    18,    25,    30,    36,    41},   /* 12: step    23 */
+  {    3,     9,    15,    21,    28,    34,    40,    46},   /* 13: step    25 */
+  {    3,    10,    17,    24,    31,    38,    45,    52},   /* 14: step    28 */
+  {    3,    10,    18,    25,    34,    41,    49,    56},   /* 15: step    31 */
+  {    4,    12,    21,    29,    38,    46,    55,    63},   /* 16: step    34 */
+  {    4,    13,    22,    31,    41,    50,    59,    68},   /* 17: step    37 */
+  {    5,    15,    25,    35,    46,    56,    66,    76},   /* 18: step    41 */
+  {    5,    16,    27,    38,    50,    61,    72,    83},   /* 19: step    45 */
+  {    6,    18,    31,    43,    56,    68,    81,    93},   /* 20: step    50 */
+  {    6,    19,    33,    46,    61,    74,    88,   101},   /* 21: step    55 */
+  {    7,    22,    37,    52,    67,    82,    97,   112},   /* 22: step    60 */
+  {    8,    24,    41,    57,    74,    90,   107,   123},   /* 23: step    66 */
+  {    9,    27,    45,    63,    82,   100,   118,   136},   /* 24: step    73 */
+  {   10,    30,    50,    70,    90,   110,   130,   150},   /* 25: step    80 */
+  {   11,    33,    55,    77,    99,   121,   143,   165},   /* 26: step    88 */
+  {   12,    36,    60,    84,   109,   133,   157,   181},   /* 27: step    97 */
+  {   13,    39,    66,    92,   120,   146,   173,   199},   /* 28: step   107 */
+  {   14,    43,    73,   102,   132,   161,   191,   220},   /* 29: step   118 */
+  {   16,    48,    81,   113,   146,   178,   211,   243},   /* 30: step   130 */
+  {   17,    52,    88,   123,   160,   195,   231,   266},   /* 31: step   143 */
+  {   19,    58,    97,   136,   176,   215,   254,   293},   /* 32: step   157 */
+  {   21,    64,   107,   150,   194,   237,   280,   323},   /* 33: step   173 */
+  {   23,    70,   118,   165,   213,   260,   308,   355},   /* 34: step   190 */
+  {   26,    78,   130,   182,   235,   287,   339,   391},   /* 35: step   209 */
+  {   28,    85,   143,   200,   258,   315,   373,   430},   /* 36: step   230 */
+  {   31,    94,   157,   220,   284,   347,   410,   473},   /* 37: step   253 */
+  {   34,   103,   173,   242,   313,   382,   452,   521},   /* 38: step   279 */
+  {   38,   114,   191,   267,   345,   421,   498,   574},   /* 39: step   307 */
+  {   42,   126,   210,   294,   379,   463,   547,   631},   /* 40: step   337 */
+  {   46,   138,   231,   323,   417,   509,   602,   694},   /* 41: step   371 */
+  {   51,   153,   255,   357,   459,   561,   663,   765},   /* 42: step   408 */
+  {   56,   168,   280,   392,   505,   617,   729,   841},   /* 43: step   449 */
+  {   61,   184,   308,   431,   555,   678,   802,   925},   /* 44: step   494 */
+  {   68,   204,   340,   476,   612,   748,   884,  1020},   /* 45: step   544 */
+  {   74,   223,   373,   522,   672,   821,   971,  1120},   /* 46: step   598 */
+  {   82,   246,   411,   575,   740,   904,  1069,  1233},   /* 47: step   658 */
+  {   90,   271,   452,   633,   814,   995,  1176,  1357},   /* 48: step   724 */
+  {   99,   298,   497,   696,   895,  1094,  1293,  1492},   /* 49: step   796 */
+  {  109,   328,   547,   766,   985,  1204,  1423,  1642},   /* 50: step   876 */
+  {  120,   360,   601,   841,  1083,  1323,  1564,  1804},   /* 51: step   963 */
+  {  132,   397,   662,   927,  1192,  1457,  1722,  1987},   /* 52: step  1060 */
+  {  145,   436,   728,  1019,  1311,  1602,  1894,  2185},   /* 53: step  1166 */
+  {  160,   480,   801,  1121,  1442,  1762,  2083,  2403},   /* 54: step  1282 */
+  {  176,   528,   881,  1233,  1587,  1939,  2292,  2644},   /* 55: step  1411 */
+  {  194,   582,   970,  1358,  1746,  2134,  2522,  2910},   /* 56: step  1552 */
+  {  213,   639,  1066,  1492,  1920,  2346,  2773,  3199},   /* 57: step  1707 */
+  {  234,   703,  1173,  1642,  2112,  2581,  3051,  3520},   /* 58: step  1878 */
+  {  258,   774,  1291,  1807,  2324,  2840,  3357,  3873},   /* 59: step  2066 */
+  {  284,   852,  1420,  1988,  2556,  3124,  3692,  4260},   /* 60: step  2272 */
+  {  312,   936,  1561,  2185,  2811,  3435,  4060,  4684},   /* 61: step  2499 */
+  {  343,  1030,  1717,  2404,  3092,  3779,  4466,  5153},   /* 62: step  2749 */
+  {  378,  1134,  1890,  2646,  3402,  4158,  4914,  5670},   /* 63: step  3024 */
+  {  415,  1246,  2078,  2909,  3742,  4573,  5405,  6236},   /* 64: step  3327 */
+  {  457,  1372,  2287,  3202,  4117,  5032,  5947,  6862},   /* 65: step  3660 */
+  {  503,  1509,  2516,  3522,  4529,  5535,  6542,  7548},   /* 66: step  4026 */
+  {  553,  1660,  2767,  3874,  4981,  6088,  7195,  8302},   /* 67: step  4428 */
+  {  608,  1825,  3043,  4260,  5479,  6696,  7914,  9131},   /* 68: step  4871 */
+  {  669,  2008,  3348,  4687,  6027,  7366,  8706, 10045},   /* 69: step  5358 */
+  {  736,  2209,  3683,  5156,  6630,  8103,  9577, 11050},   /* 70: step  5894 */
+  {  810,  2431,  4052,  5673,  7294,  8915, 10536, 12157},   /* 71: step  6484 */
+  {  891,  2674,  4457,  6240,  8023,  9806, 11589, 13372},   /* 72: step  7132 */
+  {  980,  2941,  4902,  6863,  8825, 10786, 12747, 14708},   /* 73: step  7845 */
+  { 1078,  3235,  5393,  7550,  9708, 11865, 14023, 16180},   /* 74: step  8630 */
+  { 1186,  3559,  5932,  8305, 10679, 13052, 15425, 17798},   /* 75: step  9493 */
+  { 1305,  3915,  6526,  9136, 11747, 14357, 16968, 19578},   /* 76: step 10442 */
+  { 1435,  4306,  7178, 10049, 12922, 15793, 18665, 21536},   /* 77: step 11487 */
+  { 1579,  4737,  7896, 11054, 14214, 17372, 20531, 23689},   /* 78: step 12635 */
+  { 1737,  5211,  8686, 12160, 15636, 19110, 22585, 26059},   /* 79: step 13899 */
+  { 1911,  5733,  9555, 13377, 17200, 21022, 24844, 28666},   /* 80: step 15289 */
+  { 2102,  6306, 10511, 14715, 18920, 23124, 27329, 31533},   /* 81: step 16818 */
+  { 2312,  6937, 11562, 16187, 20812, 25437, 30062, 34687},   /* 82: step 18500 */
+  { 2543,  7630, 12718, 17805, 22893, 27980, 33068, 38155},   /* 83: step 20350 */
+  { 2798,  8394, 13990, 19586, 25183, 30779, 36375, 41971},   /* 84: step 22385 */
+  { 3077,  9232, 15388, 21543, 27700, 33855, 40011, 46166},   /* 85: step 24623 */
+  { 3385, 10156, 16928, 23699, 30471, 37242, 44014, 50785},   /* 86: step 27086 */
+  { 3724, 11172, 18621, 26069, 33518, 40966, 48415, 55863},   /* 87: step 29794 */
+  { 4095, 12286, 20478, 28669, 36862, 45053, 53245, 61436}    /* 88: step 32767 */
+};
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool AdpcmBlockBegin(AdpcmStateType* pstState_, const u8* pu8Block_)
+
+@brief Loads the decoder state from a block's header.
+
+Requires:
+- pu8Block_ is a whole ADPCM_BLOCK_SIZE block
+
+Promises:
+- Returns false, leaving *pstState_ alone, if the header can't be an
+  ADPCM block (step index out of range or the reserved byte set)
+- Otherwise *pstState_ is ready to decode sample 0 of the block
+
+*/
+bool AdpcmBlockBegin(AdpcmStateType* pstState_, const u8* pu8Block_)
+{
+  if( (pu8Block_[2] > ADPCM_STEP_INDEX_MAX) || (pu8Block_[3] != 0) )
+  {
+    return false;
+  }
+
+  /* Two's complement to offset binary */
+  pstState_->u16Predictor = (u16)(pu8Block_[0] | ((u16)(pu8Block_[1] ^ 0x80) << 8));
+  pstState_->u8StepIndex = pu8Block_[2];
+
+  return true;
+
+} /* end AdpcmBlockBegin() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void AdpcmDecode(AdpcmStateType* pstState_, const u8* pu8Block_, u16 u16Sample_, u8* pu8Output_, u16 u16Count_)
+
+@brief Decodes u16Count_ samples of a block, from sample u16Sample_, to
+unsigned 8-bit samples.
+
+Sample 0 is the header's; sample n after that is code n - 1.  A block can
+be decoded in any number of calls as long as they follow on.
+
+Requires:
+- *pstState_ from AdpcmBlockBegin on this block, then only this function
+  for samples 0 to u16Sample_ - 1
+- u16Sample_ + u16Count_ <= ADPCM_BLOCK_SAMPLES
+
+Promises:
+- pu8Output_[0 .. u16Count_ - 1] hold the samples
+- *pstState_ is ready for sample u16Sample_ + u16Count_
+
+*/
+void AdpcmDecode(AdpcmStateType* pstState_, const u8* pu8Block_, u16 u16Sample_, u8* pu8Output_, u16 u16Count_)
+{
+  u16 u16Predictor = pstState_->u16Predictor;
+  s8 s8Index = (s8)pstState_->u8StepIndex;
+  const u8* pu8Code;
+  bool bHighNibble;
+  u8 u8Code;
+  u16 u16Diff;
+
+  if(u16Count_ == 0)
+  {
+    return;
+  }
+
+  if(u16Sample_ == 0)
+  {
+    *pu8Output_++ = (u8)(u16Predictor >> 8);
+    u16Sample_++;
+    u16Count_--;
+  }
+
+  pu8Code = &pu8Block_[ADPCM_HEADER_SIZE + ((u16Sample_ - 1) >> 1)];
+  bHighNibble = ((u16Sample_ - 1) & 1) != 0;
+
+  while(u16Count_-- != 0)
+  {
+    if(bHighNibble)
+    {
+      u8Code = *pu8Code++ >> 4;
+    }
+    else
+    {
+      u8Code = *pu8Code & 0x0F;
+    }
+    bHighNibble = !bHighNibble;
+
+    u16Diff = Adpcm_au16Diff[s8Index][u8Code & 0x07];
+    if(u8Code & 0x08)
+    {
+      u16Predictor = (u16Diff > u16Predictor) ? 0 : (u16)(u16Predictor - u16Diff);
+    }
+    else
+    {
+      u16Predictor = (u16Diff > (u16)(0xFFFF - u16Predictor)) ? 0xFFFF : (u16)(u16Predictor + u16Diff);
+    }
+
+    s8Index += Adpcm_as8IndexStep[u8Code & 0x07];
+    if(s8Index < 0)
+    {
+      s8Index = 0;
+    }
+    else if(s8Index > (s8)ADPCM_STEP_INDEX_MAX)
+    {
+      s8Index = (s8)ADPCM_STEP_INDEX_MAX;
+    }
+
+    *pu8Output_++ = (u8)(u16Predictor >> 8);
+  }
+
+  pstState_->u16Predictor = u16Predictor;
+  pstState_->u8StepIndex = (u8)s8Index;
+
+} /* end AdpcmDecode() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
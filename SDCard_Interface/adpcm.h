@@ -0,0 +1,62 @@
+/*!*********************************************************************************************************************
+@file adpcm.h
+@brief Header file for the IMA-ADPCM block decoder
+
+**********************************************************************************************************************/
+
+#ifndef __ADPCM_H
+#define __ADPCM_H
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/* Block: one 512-byte sector.  s16 first sample and u8 step index (little-endian),
+   a 0 byte, then 4-bit codes, low nibble first.  The same layout as a mono
+   IMA-ADPCM WAV with a 512-byte block align. */
+#define ADPCM_BLOCK_SIZE          (u16)512       /*!< @brief One sector */
+#define ADPCM_HEADER_SIZE         (u8)4          /*!< @brief Block bytes before the codes */
+#define ADPCM_BLOCK_SAMPLES       (u16)1017      /*!< @brief The header's sample, then two per byte */
+#define ADPCM_STEP_INDEX_MAX      (u8)88
+
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*!
+@struct AdpcmStateType
+@brief Decoder state between calls within a block.
+*/
+typedef struct
+{
+  u16 u16Predictor;                             /*!< @brief Last sample, offset binary: 0x8000 is 0 */
+  u8  u8StepIndex;                              /*!< @brief 0 to ADPCM_STEP_INDEX_MAX */
+} AdpcmStateType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+bool AdpcmBlockBegin(AdpcmStateType* pstState_, const u8* pu8Block_);
+void AdpcmDecode(AdpcmStateType* pstState_, const u8* pu8Block_, u16 u16Sample_, u8* pu8Output_, u16 u16Count_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+#endif /* __ADPCM_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
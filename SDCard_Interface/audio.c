@@ -0,0 +1,645 @@
+/*!*********************************************************************************************************************
+@file audio.c                                                                
+@brief Streams 8-bit unsigned or IMA-ADPCM samples from consecutive SD sectors to DAC1.
+
+Timer1 is the sample clock and TMR1_ISR is the only high priority interrupt.
+The first thing it does is write G_u8AudioNextSample to DAC1DATL, so the DAC
+updates a fixed number of cycles after each overflow whatever else is 
+pending.  It then calls AudioSampleCallback() to fetch the sample for the 
+next interrupt, so the time spent fetching never shows up as jitter.
+
+The samples come from the two SD ping-pong buffers.  The ISR plays one while
+the other is refilled from the card.  When the ISR moves on from a drained 
+buffer it posts DEFER_WORK_AUDIO_REFILL, and AudioRefillWork() reads the next
+sector in SW_ISR straight away.  If that would interrupt a card transfer 
+already in progress in the main loop it leaves the buffer for AudioRun(), 
+which checks every millisecond.  If the ISR reaches the end of a buffer 
+before the other one is full it repeats the last sample and counts an
+underrun instead of playing stale data.
+
+A track can instead be AUDIO_FORMAT_ADPCM4: 4-bit IMA-ADPCM blocks of
+ADPCM_BLOCK_SAMPLES a sector (adpcm.c), half the card reads of 8-bit PCM.
+The ping-pong buffers and the ISR are the same; the buffers hold decoded
+samples.  Each sector is read into Audio_au8Block and AudioDecode() turns
+it into samples, AUDIO_DECODE_CHUNK at a time from AudioRun(), so the
+main loop stays responsive and SW_ISR never decodes.  A buffer lasts
+AUDIO_BUFFER_SIZE sample periods (64ms at 8kHz), which is many AudioRun
+calls, so the decoder stays ahead of the ISR.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_u8AudioNextSample
+- G_u32AudioUnderruns
+
+CONSTANTS
+- AUDIO_BUFFER_SIZE
+- AUDIO_SILENCE
+- AUDIO_DECODE_CHUNK
+- AUDIO_FORMAT_PCM8, AUDIO_FORMAT_ADPCM4
+
+TYPES
+- NONE
+
+PUBLIC FUNCTIONS
+- bool AudioStart(u32 u32FirstSector_, u32 u32Sectors_, u16 u16SamplePeriodUs_, u8 u8Format_)
+- void AudioStop(void)
+- bool AudioIsPlaying(void)
+- u16 AudioBufferedSamples(void)
+
+PROTECTED FUNCTIONS
+- void AudioInitialize(void)
+- void AudioRun(void)
+- void AudioRefillWork(u8 u8Buffer_, u16 u16Unused_)
+- void AudioSampleCallback(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Audio"
+***********************************************************************************************************************/
+/* New variables */
+volatile u8  G_u8AudioNextSample = AUDIO_SILENCE;         /*!< @brief Written to the DAC by the next TMR1_ISR */
+volatile u32 G_u32AudioUnderruns = 0;                     /*!< @brief Buffer ends reached before the next buffer was filled */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern u8 G_au8SDReadBuffer0[];                           /*!< @brief From sd.c */
+extern u8 G_au8SDReadBuffer1[];                           /*!< @brief From sd.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Audio_<type>" and be declared as static.
+***********************************************************************************************************************/
+static u8* const Audio_apu8Buffers[2] = {G_au8SDReadBuffer0, G_au8SDReadBuffer1};
+
+static volatile bool Audio_abFull[2];                     /*!< @brief Set by AudioFill when filled, cleared by the ISR when drained */
+static volatile u8  Audio_u8Playing;                      /*!< @brief Buffer the ISR is reading (ISR only) */
+static volatile u16 Audio_u16Index;                       /*!< @brief Next sample in the playing buffer (ISR only) */
+static volatile bool Audio_bLastRead;                     /*!< @brief Set by AudioFill once the final sector is in a buffer */
+static volatile bool Audio_bReadFailed;                   /*!< @brief Set by AudioFill; AudioRun stops playback */
+static volatile bool Audio_bFilling;                      /*!< @brief Main loop is in AudioFill; keeps SW_ISR out */
+
+static volatile bool Audio_bActive;                       /*!< @brief true between AudioStart and AudioStop */
+static volatile u8 Audio_u8Format;                        /*!< @brief AUDIO_FORMAT_xxx of the track playing */
+static bool Audio_bDry;                                   /*!< @brief The ISR is repeating a sample for lack of data (ISR only) */
+static u32 Audio_u32NextSector;                           /*!< @brief Next sector to read */
+static u32 Audio_u32SectorsLeft;                          /*!< @brief Sectors not yet read */
+
+/* AUDIO_FORMAT_ADPCM4 only; main loop only */
+static u8 Audio_au8Block[ADPCM_BLOCK_SIZE];               /*!< @brief Sector being decoded */
+static AdpcmStateType Audio_stAdpcm;
+static u16 Audio_u16BlockSample;                          /*!< @brief Next sample of Audio_au8Block to decode */
+static u16 Audio_u16DecodeIndex;                          /*!< @brief Next sample to write in the buffer being decoded into */
+
+static void AudioFill(u8 u8MaxSectors_);
+static void AudioDecode(u8 u8MaxSectors_, u16 u16MaxSamples_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool AudioStart(u32 u32FirstSector_, u32 u32Sectors_, u16 u16SamplePeriodUs_, u8 u8Format_)
+
+@brief Starts playing u32Sectors_ sectors of samples beginning at u32FirstSector_.
+
+Requires:
+- SD card initialized
+- u16SamplePeriodUs_ is the sample period, e.g. 125 for 8kHz
+- u8Format_ is AUDIO_FORMAT_PCM8 or AUDIO_FORMAT_ADPCM4; an ADPCM track
+  can start at any of its sectors
+
+Promises:
+- Clock raised to 64MHz for the duration of playback
+- Both buffers filled before the sample timer starts
+- Returns false, with nothing started, if a read fails or the first
+  ADPCM block is not valid
+
+*/
+bool AudioStart(u32 u32FirstSector_, u32 u32Sectors_, u16 u16SamplePeriodUs_, u8 u8Format_)
+{
+  AudioStop();
+  ClockRequestFull(CLOCK_CLIENT_AUDIO);
+  TRACE_RECORD(TRACE_EVENT_SONG_START, 0, (u16)u32FirstSector_);
+  
+  /* Keep out any refill work still queued from the last playback */
+  Audio_bFilling = true;
+  Audio_u32NextSector = u32FirstSector_;
+  Audio_u32SectorsLeft = u32Sectors_;
+  Audio_abFull[0] = false;
+  Audio_abFull[1] = false;
+  Audio_bLastRead = (u32Sectors_ == 0);
+  Audio_bReadFailed = false;
+  Audio_u8Format = u8Format_;
+  Audio_u16BlockSample = ADPCM_BLOCK_SAMPLES;
+  Audio_u16DecodeIndex = 0;
+  Audio_bActive = true;
+  
+  /* Prime both buffers so playback starts with a full sector in hand.  With
+  buffer 1 nominally playing AudioFill fills buffer 0 first. */
+  Audio_u8Playing = 1;
+  if(u8Format_ == AUDIO_FORMAT_ADPCM4)
+  {
+    Audio_bLastRead = false;
+    AudioDecode(2, 2 * AUDIO_BUFFER_SIZE);
+  }
+  else
+  {
+    AudioFill(2);
+  }
+  Audio_bFilling = false;
+  if(!Audio_abFull[0] || Audio_bReadFailed)
+  {
+    AudioStop();
+    return false;
+  }
+  
+  Audio_u8Playing = 0;
+  G_u8AudioNextSample = Audio_apu8Buffers[0][0];
+  Audio_u16Index = 1;
+  Audio_bDry = false;
+  
+  TimerSetCallback(TIMER_1, AudioSampleCallback);
+  TimerStart(TIMER_1, u16SamplePeriodUs_, TIMER_CONTINUOUS);
+  
+  return true;
+  
+} /* end AudioStart() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void AudioStop(void)
+
+@brief Stops playback.
+
+Requires:
+- NONE
+
+Promises:
+- Sample timer stopped, DAC at mid-scale and the 64MHz request released
+
+*/
+void AudioStop(void)
+{
+  if(Audio_bActive)
+  {
+    TimerStop(TIMER_1);
+    TimerSetCallback(TIMER_1, NULL);
+    Audio_bActive = false;
+    ClockReleaseFull(CLOCK_CLIENT_AUDIO);
+    TRACE_RECORD(TRACE_EVENT_SONG_STOP, 0, 0);
+  }
+  
+  G_u8AudioNextSample = AUDIO_SILENCE;
+  HAL_DAC_WRITE(AUDIO_SILENCE);
+  
+} /* end AudioStop() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool AudioIsPlaying(void)
+
+@brief Reports whether playback is running.
+
+Requires:
+- NONE
+
+Promises:
+- Returns true from a successful AudioStart until AudioStop or the end of
+  the samples
+
+*/
+bool AudioIsPlaying(void)
+{
+  return Audio_bActive;
+  
+} /* end AudioIsPlaying() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u16 AudioBufferedSamples(void)
+
+@brief Returns the samples loaded and not yet played, i.e. how far the
+refill is ahead of the sample ISR.
+
+Requires:
+- NONE
+
+Promises:
+- Returns 0 when not playing, otherwise the rest of the playing buffer
+  plus AUDIO_BUFFER_SIZE if the other buffer is full
+- TMR1_ISR is never held off; if it moves on a buffer during the call the
+  result can be one buffer out, so it is a statistic only
+
+*/
+u16 AudioBufferedSamples(void)
+{
+  u16 u16Index;
+  u16 u16Samples;
+  u8 u8Playing;
+  
+  if(!Audio_bActive)
+  {
+    return 0;
+  }
+  
+  /* The index is two bytes, so read until the ISR leaves it alone */
+  do
+  {
+    u16Index  = Audio_u16Index;
+    u8Playing = Audio_u8Playing;
+  } while(u16Index != Audio_u16Index);
+  
+  u16Samples = AUDIO_BUFFER_SIZE - u16Index;
+  if(Audio_abFull[u8Playing ^ 1])
+  {
+    u16Samples += AUDIO_BUFFER_SIZE;
+  }
+  
+  return u16Samples;
+  
+} /* end AudioBufferedSamples() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void AudioInitialize(void)
+
+@brief Sets up the module with nothing playing.
+
+Should only be called once in main init section.
+
+Requires:
+- NONE
+
+Promises:
+- Not playing, DAC at mid-scale, underrun count cleared
+
+*/
+void AudioInitialize(void)
+{
+  Audio_bActive = false;
+  Audio_bFilling = false;
+  G_u32AudioUnderruns = 0;
+  G_u8AudioNextSample = AUDIO_SILENCE;
+  HAL_DAC_WRITE(AUDIO_SILENCE);
+  
+} /* end AudioInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void AudioRun(void)
+
+@brief Backs up the SW_ISR refill, decodes ADPCM and stops at the end of
+the samples.
+
+Scheduler task; at most one sector (about 0.5ms at 64MHz) per call.  
+Normally AudioRefillWork has already filled the drained buffer and this 
+finds nothing to read.  An ADPCM track is only read and decoded here, at
+most one sector and AUDIO_DECODE_CHUNK samples per call.
+
+Requires:
+- NONE
+
+Promises:
+- If a buffer is empty and sectors remain, the next sector is read into it
+  and it is marked full; for ADPCM the next samples are decoded into it and
+  it is marked full once complete
+- A failed read stops playback
+- When every sector has been played playback stops
+
+*/
+void AudioRun(void)
+{
+  if(!Audio_bActive)
+  {
+    return;
+  }
+  
+  if(Audio_bReadFailed)
+  {
+    AudioStop();
+    return;
+  }
+  
+  /* Both buffers drained with nothing left to read */
+  if(Audio_bLastRead && !Audio_abFull[0] && !Audio_abFull[1])
+  {
+    AudioStop();
+    return;
+  }
+  
+  Audio_bFilling = true;
+  if(Audio_u8Format == AUDIO_FORMAT_ADPCM4)
+  {
+    AudioDecode(1, AUDIO_DECODE_CHUNK);
+  }
+  else
+  {
+    REGION_PROFILE_BEGIN(AUDIO_REFILL);
+    AudioFill(1);
+    REGION_PROFILE_END(AUDIO_REFILL);
+  }
+  Audio_bFilling = false;
+  
+} /* end AudioRun() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void AudioRefillWork(u8 u8Buffer_, u16 u16Unused_)
+
+@brief Deferred work for DEFER_WORK_AUDIO_REFILL: refills the buffer the 
+sample ISR just drained.  Runs in SW_ISR.
+
+One sector per call keeps SW_ISR shorter than a systick period, so TMR2_ISR
+is delayed but never misses a tick.
+
+Requires:
+- Called only through DeferDispatch
+- u8Buffer_ is the drained buffer; AudioFill picks the buffer itself
+
+Promises:
+- If neither the main loop's AudioFill nor another card transfer was 
+  interrupted, the next sector is read into the empty buffer
+- Otherwise, or for an ADPCM track, nothing is done and AudioRun does the
+  read on its next call
+
+*/
+void AudioRefillWork(u8 u8Buffer_, u16 u16Unused_)
+{
+  (void)u8Buffer_;
+  (void)u16Unused_;
+  
+  if(!Audio_bActive || Audio_bFilling || SD_IsBusy() || (Audio_u8Format != AUDIO_FORMAT_PCM8))
+  {
+    return;
+  }
+  
+  /* Only the read is profiled, as in AudioRun, so a skipped call never
+  leaves the region open */
+  REGION_PROFILE_BEGIN(AUDIO_REFILL);
+  AudioFill(1);
+  REGION_PROFILE_END(AUDIO_REFILL);
+  
+} /* end AudioRefillWork() */
+
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void AudioSampleCallback(void)
+
+@brief Fetches the sample for the next TMR1_ISR.  Runs inside TMR1_ISR after
+the DAC has been written.
+
+Requires:
+- Registered as the Timer1 call-back by AudioStart
+
+Promises:
+- G_u8AudioNextSample holds the next sample
+- A drained buffer is marked empty, its refill is deferred to SW_ISR and 
+  playback moves to the other one if it is full; otherwise the last sample repeats and, unless the final sector 
+  has been read, an underrun is counted; the first of a run is traced and, with
+  TRACE_FREEZE_ON_UNDERRUN, freezes the trace
+
+*/
+void AudioSampleCallback(void)
+{
+  if(Audio_u16Index >= AUDIO_BUFFER_SIZE)
+  {
+    if(!Audio_abFull[Audio_u8Playing ^ 1])
+    {
+      /* Running dry after the last sector is the normal end: release the 
+      buffer so AudioRun sees both empty and stops */
+      if(Audio_bLastRead)
+      {
+        Audio_abFull[Audio_u8Playing] = false;
+      }
+      else
+      {
+        G_u32AudioUnderruns++;
+        
+        /* Trace the start of a dry spell, not every repeated sample */
+        if(!Audio_bDry)
+        {
+          Audio_bDry = true;
+          TRACE_RECORD_HIGH(TRACE_EVENT_UNDERRUN, Audio_u8Playing, 0);
+#if TRACE_FREEZE_ON_UNDERRUN
+          TraceFreezeFromHighIsr(TRACE_FREEZE_UNDERRUN);
+#endif
+        }
+      }
+      return;
+    }
+    
+    Audio_abFull[Audio_u8Playing] = false;
+    DeferFromHighIsr(DEFER_WORK_AUDIO_REFILL, Audio_u8Playing, 0);
+    Audio_u8Playing ^= 1;
+    Audio_u16Index = 0;
+    Audio_bDry = false;
+    TRACE_RECORD_HIGH(TRACE_EVENT_BUFFER_SWAP, Audio_u8Playing, 0);
+  }
+  
+  G_u8AudioNextSample = Audio_apu8Buffers[Audio_u8Playing][Audio_u16Index];
+  Audio_u16Index++;
+  
+} /* end AudioSampleCallback() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void AudioFill(u8 u8MaxSectors_)
+
+@brief Reads up to u8MaxSectors_ sectors into the empty buffers.
+
+Runs in the main loop (AudioStart, AudioRun) and in SW_ISR (AudioRefillWork),
+never both at once: main sets Audio_bFilling around its calls and SW_ISR 
+stays out while it is set.
+
+Requires:
+- Audio_bActive
+
+Promises:
+- Empty buffers are filled in playing order, the one after the playing 
+  buffer first, until u8MaxSectors_ have been read or no sectors remain
+- Audio_bLastRead set once the final sector is read
+- A failed read sets Audio_bReadFailed and nothing more is read
+
+*/
+static void AudioFill(u8 u8MaxSectors_)
+{
+  u8 u8Buffer = Audio_u8Playing ^ 1;
+  
+  for(u8 i = 0; i < 2; i++, u8Buffer ^= 1)
+  {
+    if(Audio_abFull[u8Buffer])
+    {
+      continue;
+    }
+    
+    if( (u8MaxSectors_ == 0) || (Audio_u32SectorsLeft == 0) || Audio_bReadFailed )
+    {
+      return;
+    }
+    
+    if(SD_ReadSector(Audio_u32NextSector, Audio_apu8Buffers[u8Buffer]) == false)
+    {
+      Audio_bReadFailed = true;
+      return;
+    }
+    
+    TRACE_RECORD(TRACE_EVENT_BUFFER_FILLED, u8Buffer, (u16)Audio_u32NextSector);
+    u8MaxSectors_--;
+    Audio_u32NextSector++;
+    Audio_u32SectorsLeft--;
+    Audio_abFull[u8Buffer] = true;
+    
+    if(Audio_u32SectorsLeft == 0)
+    {
+      Audio_bLastRead = true;
+    }
+  }
+  
+} /* end AudioFill() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void AudioDecode(u8 u8MaxSectors_, u16 u16MaxSamples_)
+
+@brief Decodes ADPCM samples into the empty buffers.
+
+The ADPCM counterpart of AudioFill, main loop only.  Blocks don't line up
+with buffers: a block fills most of two buffers and a buffer can take
+samples from two blocks, so the place in each is kept between calls.
+
+Requires:
+- Audio_bActive with an AUDIO_FORMAT_ADPCM4 track
+
+Promises:
+- Empty buffers are decoded into in playing order, reading the next sector
+  when a block runs out, until u8MaxSectors_ sectors have been read,
+  u16MaxSamples_ samples decoded or no samples remain
+- A buffer is marked full when complete; at the end of the track the
+  last buffer is completed with its last sample and Audio_bLastRead set
+- A failed read or a sector that is not an ADPCM block sets
+  Audio_bReadFailed and nothing more is decoded
+
+*/
+static void AudioDecode(u8 u8MaxSectors_, u16 u16MaxSamples_)
+{
+  u8 u8Buffer = Audio_u8Playing ^ 1;
+  u8* pu8Buffer;
+  u16 u16Count;
+  
+  for(u8 i = 0; i < 2; i++, u8Buffer ^= 1)
+  {
+    if(Audio_abFull[u8Buffer])
+    {
+      continue;
+    }
+    
+    pu8Buffer = Audio_apu8Buffers[u8Buffer];
+    while(Audio_u16DecodeIndex < AUDIO_BUFFER_SIZE)
+    {
+      if(Audio_bReadFailed || Audio_bLastRead)
+      {
+        return;
+      }
+      
+      /* Block used up: on to the next sector */
+      if(Audio_u16BlockSample >= ADPCM_BLOCK_SAMPLES)
+      {
+        if(Audio_u32SectorsLeft == 0)
+        {
+          /* End of the track: hold the last sample to the end of the buffer */
+          if(Audio_u16DecodeIndex == 0)
+          {
+            Audio_bLastRead = true;
+            return;
+          }
+          
+          for(u16 j = Audio_u16DecodeIndex; j < AUDIO_BUFFER_SIZE; j++)
+          {
+            pu8Buffer[j] = pu8Buffer[Audio_u16DecodeIndex - 1];
+          }
+          break;
+        }
+        
+        if(u8MaxSectors_ == 0)
+        {
+          return;
+        }
+        
+        if( !SD_ReadSector(Audio_u32NextSector, Audio_au8Block) ||
+            !AdpcmBlockBegin(&Audio_stAdpcm, Audio_au8Block) )
+        {
+          Audio_bReadFailed = true;
+          return;
+        }
+        
+        u8MaxSectors_--;
+        Audio_u32NextSector++;
+        Audio_u32SectorsLeft--;
+        Audio_u16BlockSample = 0;
+      }
+      
+      if(u16MaxSamples_ == 0)
+      {
+        return;
+      }
+      
+      /* As far as the first of the buffer end, the block end or the limit */
+      u16Count = AUDIO_BUFFER_SIZE - Audio_u16DecodeIndex;
+      if(u16Count > ADPCM_BLOCK_SAMPLES - Audio_u16BlockSample)
+      {
+        u16Count = ADPCM_BLOCK_SAMPLES - Audio_u16BlockSample;
+      }
+      if(u16Count > u16MaxSamples_)
+      {
+        u16Count = u16MaxSamples_;
+      }
+      
+      REGION_PROFILE_BEGIN(AUDIO_DECODE);
+      AdpcmDecode(&Audio_stAdpcm, Audio_au8Block, Audio_u16BlockSample, &pu8Buffer[Audio_u16DecodeIndex], u16Count);
+      REGION_PROFILE_END(AUDIO_DECODE);
+      
+      Audio_u16BlockSample += u16Count;
+      Audio_u16DecodeIndex += u16Count;
+      u16MaxSamples_ -= u16Count;
+    }
+    
+    TRACE_RECORD(TRACE_EVENT_BUFFER_FILLED, u8Buffer, (u16)(Audio_u32NextSector - 1));
+    Audio_u16DecodeIndex = 0;
+    Audio_abFull[u8Buffer] = true;
+    
+    /* Nothing after this buffer */
+    if( (Audio_u32SectorsLeft == 0) && (Audio_u16BlockSample >= ADPCM_BLOCK_SAMPLES) )
+    {
+      Audio_bLastRead = true;
+    }
+  }
+  
+} /* end AudioDecode() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
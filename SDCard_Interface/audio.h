@@ -0,0 +1,53 @@
+/*!*********************************************************************************************************************
+@file audio.h                                                                
+@brief Header file for SD card audio streaming to DAC1
+
+**********************************************************************************************************************/
+
+#ifndef __AUDIO_H
+#define __AUDIO_H
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+bool AudioStart(u32 u32FirstSector_, u32 u32Sectors_, u16 u16SamplePeriodUs_, u8 u8Format_);
+void AudioStop(void);
+bool AudioIsPlaying(void);
+u16  AudioBufferedSamples(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void AudioInitialize(void);
+void AudioRun(void);
+void AudioRefillWork(u8 u8Buffer_, u16 u16Unused_);
+void AudioSampleCallback(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define AUDIO_BUFFER_SIZE         (u16)512             /*!< @brief One sector of 8-bit unsigned samples */
+#define AUDIO_SILENCE             (u8)0x80             /*!< @brief DAC mid-scale */
+#define AUDIO_DECODE_CHUNK        (u16)128             /*!< @brief Most ADPCM samples AudioRun decodes per call */
+
+/* Track formats for AudioStart */
+#define AUDIO_FORMAT_PCM8         (u8)0                /*!< @brief 8-bit unsigned samples, 512 per sector */
+#define AUDIO_FORMAT_ADPCM4       (u8)1                /*!< @brief IMA-ADPCM blocks, ADPCM_BLOCK_SAMPLES per sector, see adpcm.c */
+
+
+#endif /* __AUDIO_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,294 @@
+/*!*********************************************************************************************************************
+@file clock.c                                                                
+@brief Operating-point manager: runs the HFINTOSC at 64MHz while audio needs
+it and at 16MHz the rest of the time.
+
+Modules that need full speed hold a request bit with ClockRequestFull().  The
+first request switches to 64MHz before it returns, so a caller can start 
+playback straight after.  When the last request is released ClockRun(), a 
+scheduler task, waits CLOCK_DROP_DELAY_MS and then drops to 16MHz, so short
+gaps between songs don't bounce the clock.
+
+Every switch rewrites the prescalers from Clock_astOpPoints[] so the tick
+sizes everything else relies on stay the same:
+- Timer0 1us (microsecond event queue)
+- Timer1/Timer3 0.5us (sample timers)
+- Timer2 8us counts, 1ms systick
+- SPI1 SCK 8MHz
+- UART1 115200 baud
+Timer5 is not rescaled: it counts instruction cycles, so cycle counts taken
+at 16MHz are four times as long in real time.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_u16ClockSwitchUs
+- G_u16ClockSwitches
+
+CONSTANTS
+- CLOCK_CLIENT_AUDIO, CLOCK_CLIENT_SYNTH, CLOCK_CLIENT_DEBUG
+- CLOCK_DROP_DELAY_MS
+
+TYPES
+- ClockOpPointType
+- ClockOpPointSettingsType
+
+PUBLIC FUNCTIONS
+- void ClockRequestFull(u8 u8Client_)
+- void ClockReleaseFull(u8 u8Client_)
+- ClockOpPointType ClockOperatingPoint(void)
+- u8 ClockCyclesPerUs(void)
+
+PROTECTED FUNCTIONS
+- void ClockInitialize(void)
+- void ClockRun(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Clock"
+***********************************************************************************************************************/
+/* New variables */
+u16 G_u16ClockSwitchUs;                                   /*!< @brief Duration of the last switch, measured on Timer0 (+/-2us) */
+u16 G_u16ClockSwitches;                                   /*!< @brief Number of operating point changes */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Clock_<type>" and be declared as static.
+***********************************************************************************************************************/
+static const ClockOpPointSettingsType Clock_astOpPoints[CLOCK_OP_COUNT] =
+{
+  /* OSCFRQ  T0 CKPS      T1/T3 CKPS  T2 CKPS      SPI BAUD  U1BRG */
+  {  0x05,   0x2 /*1:4*/, 0x1 /*1:2*/, 0x5 /*1:32*/,  0,        UART_BRG_16MHZ },  /* CLOCK_OP_16MHZ: Fosc/4 = 4MHz  */
+  {  0x08,   0x4 /*1:16*/,0x3 /*1:8*/, 0x7 /*1:128*/, 3,        UART_BRG_64MHZ },  /* CLOCK_OP_64MHZ: Fosc/4 = 16MHz */
+};
+
+static ClockOpPointType Clock_eOpPoint;                   /*!< @brief Current operating point */
+static u8 Clock_u8Requests;                               /*!< @brief CLOCK_CLIENT_ bits currently asking for 64MHz */
+static u32 Clock_u32ReleasedMs;                           /*!< @brief TimeBaseMs() when the last request was released */
+
+static void ClockSwitch(ClockOpPointType eOpPoint_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void ClockRequestFull(u8 u8Client_)
+
+@brief Asks for the 64MHz operating point.
+
+Requires:
+- u8Client_ is one CLOCK_CLIENT_ bit
+- Main loop context, with no SPI transfer in progress
+
+Promises:
+- The clock is at 64MHz when this returns
+- The request holds until ClockReleaseFull(u8Client_)
+
+*/
+void ClockRequestFull(u8 u8Client_)
+{
+  Clock_u8Requests |= u8Client_;
+  
+  if(Clock_eOpPoint != CLOCK_OP_64MHZ)
+  {
+    ClockSwitch(CLOCK_OP_64MHZ);
+  }
+  
+} /* end ClockRequestFull() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void ClockReleaseFull(u8 u8Client_)
+
+@brief Drops a request made with ClockRequestFull.
+
+Requires:
+- u8Client_ is one CLOCK_CLIENT_ bit
+
+Promises:
+- If no requests are left, ClockRun drops to 16MHz after CLOCK_DROP_DELAY_MS
+
+*/
+void ClockReleaseFull(u8 u8Client_)
+{
+  Clock_u8Requests &= ~u8Client_;
+  
+  if(Clock_u8Requests == 0)
+  {
+    Clock_u32ReleasedMs = TimeBaseMs();
+  }
+  
+} /* end ClockReleaseFull() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn ClockOpPointType ClockOperatingPoint(void)
+
+@brief Returns the current operating point, e.g. for tasks that scale their 
+work or for converting Timer5 cycle counts to time.
+
+Requires:
+- NONE
+
+Promises:
+- Returns CLOCK_OP_16MHZ or CLOCK_OP_64MHZ
+
+*/
+ClockOpPointType ClockOperatingPoint(void)
+{
+  return Clock_eOpPoint;
+  
+} /* end ClockOperatingPoint() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 ClockCyclesPerUs(void)
+
+@brief Returns the instruction cycles (Timer5 counts) per microsecond at the
+current operating point.
+
+Requires:
+- NONE
+
+Promises:
+- Returns Fosc/4 in MHz: 4 at CLOCK_OP_16MHZ, 16 at CLOCK_OP_64MHZ
+
+*/
+u8 ClockCyclesPerUs(void)
+{
+  return (Clock_eOpPoint == CLOCK_OP_64MHZ) ? 16 : 4;
+  
+} /* end ClockCyclesPerUs() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void ClockInitialize(void)
+
+@brief Starts the manager at 64MHz with no requests.
+
+Should only be called once in main init section, after every timer and SPI
+has been set up for 64MHz.
+
+Requires:
+- Running at the reset 64MHz HFINTOSC setting
+
+Promises:
+- Operating point is CLOCK_OP_64MHZ; ClockRun drops it once 
+  CLOCK_DROP_DELAY_MS pass without a request
+
+*/
+void ClockInitialize(void)
+{
+  Clock_eOpPoint = CLOCK_OP_64MHZ;
+  Clock_u8Requests = 0;
+  Clock_u32ReleasedMs = TimeBaseMs();
+  G_u16ClockSwitchUs = 0;
+  G_u16ClockSwitches = 0;
+  
+} /* end ClockInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void ClockRun(void)
+
+@brief Scheduler task that drops to 16MHz when full speed is no longer needed.
+
+Requires:
+- ClockInitialize has been called
+
+Promises:
+- Switches to CLOCK_OP_16MHZ once there have been no requests for 
+  CLOCK_DROP_DELAY_MS and the UART has nothing left to send
+
+*/
+void ClockRun(void)
+{
+  if( (Clock_eOpPoint != CLOCK_OP_16MHZ) && (Clock_u8Requests == 0) &&
+      ((TimeBaseMs() - Clock_u32ReleasedMs) >= CLOCK_DROP_DELAY_MS) && UartIsIdle() )
+  {
+    ClockSwitch(CLOCK_OP_16MHZ);
+  }
+  
+} /* end ClockRun() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void ClockSwitch(ClockOpPointType eOpPoint_)
+
+@brief Changes the HFINTOSC frequency and rescales every clock-derived peripheral.
+
+Interrupts are off for the switch so no ISR sees a timer running at the 
+wrong rate.  The timers keep counting, so at most a few ticks are counted at
+the old prescale.
+
+Requires:
+- No SPI transfer in progress
+
+Promises:
+- OSCFRQ, the Timer0/1/2/3 prescalers, SPI1BAUD and U1BRG set from Clock_astOpPoints[]
+- Returns once the HFINTOSC reports ready
+- G_u16ClockSwitchUs holds the time the switch took
+
+*/
+static void ClockSwitch(ClockOpPointType eOpPoint_)
+{
+  const ClockOpPointSettingsType* pstSettings = &Clock_astOpPoints[eOpPoint_];
+  u32 u32StartUs;
+  u8 u8GieSave = INTCON0bits.GIEH;
+  
+  INTCON0bits.GIEH = 0;
+  u32StartUs = UsTimerNow();
+  
+  OSCFRQ = pstSettings->u8OscFrq;
+  
+  T0CON1bits.CKPS = pstSettings->u8Timer0Ckps;
+  T1CONbits.CKPS  = pstSettings->u8Timer13Ckps;
+  T3CONbits.CKPS  = pstSettings->u8Timer13Ckps;
+  T2CONbits.CKPS  = pstSettings->u8Timer2Ckps;
+  
+  SPI1CON0bits.EN = 0;
+  SPI1BAUD = pstSettings->u8SpiBaud;
+  SPI1CON0bits.EN = 1;
+  
+  U1BRG = pstSettings->u16UartBrg;
+  
+  /* Wait for the HFINTOSC to settle at the new frequency */
+  while(!OSCSTATbits.HFOR);
+  
+  G_u16ClockSwitchUs = (u16)(UsTimerNow() - u32StartUs);
+  G_u16ClockSwitches++;
+  Clock_eOpPoint = eOpPoint_;
+  
+  INTCON0bits.GIEH = u8GieSave;
+  
+} /* end ClockSwitch() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
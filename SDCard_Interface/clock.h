@@ -0,0 +1,75 @@
+/*!*********************************************************************************************************************
+@file clock.h                                                                
+@brief Header file for the operating-point (system clock) manager
+
+**********************************************************************************************************************/
+
+#ifndef __CLOCK_H
+#define __CLOCK_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! 
+@enum ClockOpPointType
+@brief System clock operating points, lowest first.
+*/
+typedef enum {CLOCK_OP_16MHZ = 0, CLOCK_OP_64MHZ = 1, CLOCK_OP_COUNT = 2} ClockOpPointType;
+
+/*! 
+@struct ClockOpPointSettingsType
+@brief Register values that give the same tick sizes at one operating point.
+*/
+typedef struct
+{
+  u8 u8OscFrq;                    /*!< @brief OSCFRQ value for the HFINTOSC */
+  u8 u8Timer0Ckps;                /*!< @brief T0CON1 CKPS so Timer0 ticks at 1us */
+  u8 u8Timer13Ckps;               /*!< @brief T1CON/T3CON CKPS so Timer1/3 tick at 0.5us */
+  u8 u8Timer2Ckps;                /*!< @brief T2CON CKPS so Timer2 counts 8us (1ms systick) */
+  u8 u8SpiBaud;                   /*!< @brief SPI1BAUD for an 8MHz SCK */
+  u16 u16UartBrg;                 /*!< @brief U1BRG for 115200 baud */
+} ClockOpPointSettingsType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void ClockRequestFull(u8 u8Client_);
+void ClockReleaseFull(u8 u8Client_);
+ClockOpPointType ClockOperatingPoint(void);
+u8 ClockCyclesPerUs(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void ClockInitialize(void);
+void ClockRun(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/* u8Client_ bits for ClockRequestFull / ClockReleaseFull */
+#define CLOCK_CLIENT_AUDIO        (u8)0x01             /*!< @brief Streaming samples to the DAC */
+#define CLOCK_CLIENT_SYNTH        (u8)0x02             /*!< @brief Synthesizing samples */
+#define CLOCK_CLIENT_DEBUG        (u8)0x80             /*!< @brief Held to pin the clock at full speed while debugging */
+
+#define CLOCK_DROP_DELAY_MS       (u16)100             /*!< @brief Time with no requests before dropping to 16MHz */
+
+
+#endif /* __CLOCK_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -15,6 +15,43 @@ to match the target hardware.
 /**********************************************************************************************************************
 Runtime switches
 ***********************************************************************************************************************/
+/* Each can be overridden on the compiler command line, e.g. -DISR_PROFILE=1 */
+#ifndef CRC7_BLOCK
+#define CRC7_BLOCK                0                     /* 1 = build CRC7_Block() and its table; SD commands don't need them */
+#endif
+#ifndef SD_CACHE
+#define SD_CACHE                  0                     /* 1 = build the 2KB metadata sector cache, see sd_cache.c */
+#endif
+#ifndef SD_CRC16_VERIFY
+#define SD_CRC16_VERIFY           1                     /* 1 = reject sectors whose data CRC16 doesn't match */
+#endif
+#ifndef CRC16_KERNEL
+#define CRC16_KERNEL              CRC16_KERNEL_TABLE    /* CRC16 kernel, see crc.h */
+#endif
+#ifndef CRC16_BENCHMARK
+#define CRC16_BENCHMARK           0                     /* 1 = time every CRC16 kernel once at start-up */
+#endif
+#ifndef TIMER_MEASURE_DISPATCH
+#define TIMER_MEASURE_DISPATCH    0                     /* 1 = time a timer call-back against a direct call at start-up */
+#endif
+#ifndef ISR_PROFILE
+#define ISR_PROFILE               0                     /* 1 = record latency and run time of the timer ISRs, see isr_profile.c */
+#endif
+#ifndef REGION_PROFILE
+#define REGION_PROFILE            0                     /* 1 = time the marked code regions, dump over the UART, see region_profile.c */
+#endif
+#ifndef STACK_GUARD
+#define STACK_GUARD               1                     /* 1 = track the return stack high-water mark from TMR1_ISR, see stack_guard.c */
+#endif
+#ifndef TRACE
+#define TRACE                     1                     /* 1 = keep the flight recorder trace, see trace.c */
+#endif
+#ifndef TRACE_FREEZE_ON_UNDERRUN
+#define TRACE_FREEZE_ON_UNDERRUN  1                     /* 1 = freeze the trace and write it to the card at the first underrun */
+#endif
+#ifndef TRACE_SD_SECTOR
+#define TRACE_SD_SECTOR           (u32)4088             /* First of the TRACE_SD_SECTORS card sectors reserved for the trace */
+#endif
 
 
 /**********************************************************************************************************************
@@ -88,8 +125,10 @@ Includes
 #include <xc.h>         /* XC8 General Include File */
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <pic18f27q43.h>
 #include "typedefs.h"
+#include "hal.h"
 #include "interrupts.h"
 #include "main.h"
 
@@ -97,11 +136,29 @@ Includes
 #include "encm369_pic18.h"
 
 /* Common driver header files */
+#include "clock.h"
+#include "defer.h"
+#include "event_queue.h"
+#include "isr_profile.h"
+#include "loop_stats.h"
+#include "region_profile.h"
+#include "stack_guard.h"
+#include "telemetry.h"
+#include "time_base.h"
+#include "timer.h"
+#include "timer_wheel.h"
+#include "trace.h"
+#include "uart.h"
+#include "us_timer.h"
 
 /* Common application header files */
+#include "adpcm.h"
+#include "audio.h"
 #include "crc.h"
 #include "music.h"
 #include "sd.h"
+#include "sd_cache.h"
+#include "scheduler.h"
 #include "spi.h"
 #include "user_app.h"
 
@@ -1,48 +1,83 @@
 #ifndef CRC_H
 #define	CRC_H
 
+/* ------------------------------- Constants -------------------------------- */
+
+/* CRC16-CCITT kernels, selected with CRC16_KERNEL in configuration.h */
+#define CRC16_KERNEL_TABLE        1     /* 256-entry table: 512 bytes of flash, one lookup per byte */
+#define CRC16_KERNEL_NIBBLE       2     /* 16-entry table: 32 bytes of flash, two lookups per byte */
+#define CRC16_KERNEL_HW           3     /* Q43 CRC peripheral fed one byte at a time */
+
 /* ---------------------------- Global Variables ---------------------------- */
 
-const u8 CRCTable[256] = {
-    0x00, 0x09, 0x12, 0x1B, 0x24, 0x2D, 0x36, 0x3F, 0x48, 0x41,
-    0x5A, 0x53, 0x6C, 0x65, 0x7E, 0x77, 0x19, 0x10, 0x0B, 0x02,
-    0x3D, 0x34, 0x2F, 0x26, 0x51, 0x58, 0x43, 0x4A, 0x75, 0x7C,
-    0x67, 0x6E, 0x32, 0x3B, 0x20, 0x29, 0x16, 0x1F, 0x04, 0x0D,
-    0x7A, 0x73, 0x68, 0x61, 0x5E, 0x57, 0x4C, 0x45, 0x2B, 0x22,
-    0x39, 0x30, 0x0F, 0x06, 0x1D, 0x14, 0x63, 0x6A, 0x71, 0x78,
-    0x47, 0x4E, 0x55, 0x5C, 0x64, 0x6D, 0x76, 0x7F, 0x40, 0x49,
-    0x52, 0x5B, 0x2C, 0x25, 0x3E, 0x37, 0x08, 0x01, 0x1A, 0x13,
-    0x7D, 0x74, 0x6F, 0x66, 0x59, 0x50, 0x4B, 0x42, 0x35, 0x3C,
-    0x27, 0x2E, 0x11, 0x18, 0x03, 0x0A, 0x56, 0x5F, 0x44, 0x4D,
-    0x72, 0x7B, 0x60, 0x69, 0x1E, 0x17, 0x0C, 0x05, 0x3A, 0x33,
-    0x28, 0x21, 0x4F, 0x46, 0x5D, 0x54, 0x6B, 0x62, 0x79, 0x70,
-    0x07, 0x0E, 0x15, 0x1C, 0x23, 0x2A, 0x31, 0x38, 0x41, 0x48,
-    0x53, 0x5A, 0x65, 0x6C, 0x77, 0x7E, 0x09, 0x00, 0x1B, 0x12,
-    0x2D, 0x24, 0x3F, 0x36, 0x58, 0x51, 0x4A, 0x43, 0x7C, 0x75,
-    0x6E, 0x67, 0x10, 0x19, 0x02, 0x0B, 0x34, 0x3D, 0x26, 0x2F,
-    0x73, 0x7A, 0x61, 0x68, 0x57, 0x5E, 0x45, 0x4C, 0x3B, 0x32,
-    0x29, 0x20, 0x1F, 0x16, 0x0D, 0x04, 0x6A, 0x63, 0x78, 0x71,
-    0x4E, 0x47, 0x5C, 0x55, 0x22, 0x2B, 0x30, 0x39, 0x06, 0x0F,
-    0x14, 0x1D, 0x25, 0x2C, 0x37, 0x3E, 0x01, 0x08, 0x13, 0x1A,
-    0x6D, 0x64, 0x7F, 0x76, 0x49, 0x40, 0x5B, 0x52, 0x3C, 0x35,
-    0x2E, 0x27, 0x18, 0x11, 0x0A, 0x03, 0x74, 0x7D, 0x66, 0x6F,
-    0x50, 0x59, 0x42, 0x4B, 0x17, 0x1E, 0x05, 0x0C, 0x33, 0x3A,
-    0x21, 0x28, 0x5F, 0x56, 0x4D, 0x44, 0x7B, 0x72, 0x69, 0x60,
-    0x0E, 0x07, 0x1C, 0x15, 0x2A, 0x23, 0x38, 0x31, 0x46, 0x4F,
-    0x54, 0x5D, 0x62, 0x6B, 0x70, 0x79
-};
+#if CRC7_BLOCK
+extern const u8 CRCTable[256];
+#endif
+
+extern const u16 CRC16Table[256];
+extern const u16 CRC16NibbleTable[16];
 
 /* -------------------------- Function Prototypes --------------------------- */
+#if CRC7_BLOCK
+u8   CRC7_Block(const u8* pu8Data_, u8 u8Length_);
+#endif
 
+#if CRC16_BENCHMARK
+u16  CRC16_BlockTable(const u8* pu8Data_, u16 u16Length_);
+u16  CRC16_BlockNibble(const u8* pu8Data_, u16 u16Length_);
+u16  CRC16_BlockHw(const u8* pu8Data_, u16 u16Length_);
+#endif
+void CRC16_HwStart(void);
+u16  CRC16_HwResult(void);
+void CRC16_Benchmark(void);
 
 
 /* ------------------ #define based Function Declarations ------------------- */
 
+#if CRC7_BLOCK
+/* Software CRC7 step using the shared table.  CRC holds the 7-bit CRC in bits 6:0.
+ * Only with CRC7_BLOCK: the SD driver sends precomputed or dummy CRCs. */
 #define UPDATE_CRC(CRC, MSG){       \
 CRC = (u8)(CRC << 1);                     \
 CRC = CRC ^ MSG;                    \
 CRC = CRCTable[CRC];                \
 }
+#endif
+
+/* CRC16-CCITT (polynomial 0x1021, seed 0x0000) as used for SD data blocks.
+ * CRC16_START clears the running value, CRC16_UPDATE adds one byte and
+ * CRC16_RESULT gives the final checksum.  With the hardware kernel the running
+ * value lives in CRCACC; CRC is cleared at the start and given the result at
+ * the end, as with the tables. */
+#if CRC16_KERNEL == CRC16_KERNEL_TABLE
+
+#define CRC16_START(CRC)          {CRC = 0x0000;}
+#define CRC16_UPDATE(CRC, MSG){                                     \
+CRC = (u16)(CRC << 8) ^ CRC16Table[(u8)(CRC >> 8) ^ (MSG)];         \
+}
+#define CRC16_RESULT(CRC)         (CRC)
+
+#elif CRC16_KERNEL == CRC16_KERNEL_NIBBLE
+
+#define CRC16_START(CRC)          {CRC = 0x0000;}
+#define CRC16_UPDATE(CRC, MSG){                                     \
+CRC = (u16)(CRC << 4) ^ CRC16NibbleTable[(u8)(CRC >> 12) ^ ((MSG) >> 4)];   \
+CRC = (u16)(CRC << 4) ^ CRC16NibbleTable[(u8)(CRC >> 12) ^ ((MSG) & 0x0F)]; \
+}
+#define CRC16_RESULT(CRC)         (CRC)
+
+#elif CRC16_KERNEL == CRC16_KERNEL_HW
+
+#define CRC16_START(CRC)          {(CRC) = 0x0000; CRC16_HwStart();}
+#define CRC16_UPDATE(CRC, MSG){                                     \
+while(CRCCON0bits.FULL);                                            \
+CRCDATL = (MSG);                                                    \
+}
+#define CRC16_RESULT(CRC)         ((CRC) = CRC16_HwResult())
+
+#else
+#error "CRC16_KERNEL must be CRC16_KERNEL_TABLE, CRC16_KERNEL_NIBBLE or CRC16_KERNEL_HW"
+#endif
 
 /* -------------------------------------------------------------------------- */
 
@@ -0,0 +1,211 @@
+/*!*********************************************************************************************************************
+@file defer.c                                                                
+@brief Deferred work ("bottom halves") run by the low priority SW_ISR.
+
+An ISR that finds work too long for itself, such as refilling the audio 
+buffer it just drained, posts a small work item and sets PIR0bits.SWIF.
+SW_ISR is low priority, so the work runs as soon as the current low priority
+ISR (if any) returns, ahead of the main loop, but the sample ISR can still
+preempt it.  That keeps the heavy part out of TMR1_ISR without waiting up to
+a systick for the scheduler to poll.
+
+Work items are EventType records queued on two single-producer queues so 
+posting is lock-free on both paths:
+- G_stDeferHighQueue is only posted by the high priority ISR, which cannot be
+  interrupted by another poster.
+- G_stDeferLowQueue is posted by low priority ISRs and the main loop.  Low 
+  priority ISRs don't nest, and DeferPost masks GIEL for the few cycles of 
+  the post when called from main, so they act as one producer.
+SW_ISR is the only consumer of both.  It empties the high queue first.
+
+Handlers run to completion in SW_ISR and must not block.  Anything they 
+share with the main loop needs the same care as any other low priority ISR.
+Each dispatch is timed for loop_stats.c, since SW_ISR mostly runs while the
+main loop sleeps.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_stDeferHighQueue
+- G_stDeferLowQueue
+
+CONSTANTS
+- DEFER_WORK_xxx
+- DEFER_HIGH_QUEUE_SIZE
+- DEFER_LOW_QUEUE_SIZE
+
+TYPES
+- DeferHandlerType
+
+PUBLIC FUNCTIONS
+- bool DeferFromHighIsr(u8 u8Work_, u8 u8Param_, u16 u16Data_)
+- bool DeferPost(u8 u8Work_, u8 u8Param_, u16 u16Data_)
+
+PROTECTED FUNCTIONS
+- void DeferInitialize(void)
+- void DeferDispatch(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Defer"
+***********************************************************************************************************************/
+/* New variables */
+EVENT_QUEUE_DEFINE(G_stDeferHighQueue, DEFER_HIGH_QUEUE_SIZE);   /*!< @brief Work from TMR1_ISR */
+EVENT_QUEUE_DEFINE(G_stDeferLowQueue, DEFER_LOW_QUEUE_SIZE);     /*!< @brief Work from low priority ISRs and main */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Defer_<type>" and be declared as static.
+***********************************************************************************************************************/
+/* Indexed by DEFER_WORK_xxx */
+static const DeferHandlerType Defer_apfnHandlers[DEFER_WORK_COUNT] =
+{
+  AudioRefillWork,               /* DEFER_WORK_AUDIO_REFILL */
+};
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool DeferFromHighIsr(u8 u8Work_, u8 u8Param_, u16 u16Data_)
+
+@brief Queues work from the high priority ISR and raises SW_ISR.
+
+Requires:
+- Called only from high priority interrupt context
+- u8Work_ is a DEFER_WORK_xxx code
+
+Promises:
+- The work item is queued and SWIF set so SW_ISR runs it once no low 
+  priority ISR is executing; returns true
+- If the queue is full the item is dropped, the queue's u8Overflows is
+  counted and false is returned
+
+*/
+bool DeferFromHighIsr(u8 u8Work_, u8 u8Param_, u16 u16Data_)
+{
+  bool bQueued = EventQueuePost(&G_stDeferHighQueue, u8Work_, u8Param_, u16Data_);
+  
+  PIR0bits.SWIF = 1;
+  return bQueued;
+  
+} /* end DeferFromHighIsr() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool DeferPost(u8 u8Work_, u8 u8Param_, u16 u16Data_)
+
+@brief Queues work from a low priority ISR or the main loop and raises SW_ISR.
+
+Requires:
+- Not called from high priority interrupt context (use DeferFromHighIsr)
+- u8Work_ is a DEFER_WORK_xxx code
+
+Promises:
+- As DeferFromHighIsr, using the low priority queue
+- GIEL is masked only for the post itself
+
+*/
+bool DeferPost(u8 u8Work_, u8 u8Param_, u16 u16Data_)
+{
+  bool bQueued;
+  u8 u8GieSave = INTCON0bits.GIEL;
+  
+  INTCON0bits.GIEL = 0;
+  bQueued = EventQueuePost(&G_stDeferLowQueue, u8Work_, u8Param_, u16Data_);
+  PIR0bits.SWIF = 1;
+  INTCON0bits.GIEL = u8GieSave;
+  
+  return bQueued;
+  
+} /* end DeferPost() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void DeferInitialize(void)
+
+@brief Enables the software interrupt that runs deferred work.
+
+Should only be called once in main init section, after InterruptSetup.
+
+Requires:
+- SW_ISR is low priority (InterruptSetup clears IPR0)
+
+Promises:
+- SWIF cleared and SWIE set
+
+*/
+void DeferInitialize(void)
+{
+  PIR0bits.SWIF = 0;
+  PIE0bits.SWIE = 1;
+  
+} /* end DeferInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void DeferDispatch(void)
+
+@brief Runs every queued work item.  Called only from SW_ISR.
+
+SWIF is cleared by the caller before this runs, so work posted while a 
+handler is running either gets picked up by the loop here or raises SW_ISR
+again straight after.
+
+Requires:
+- Low priority interrupt context with SWIF already cleared
+
+Promises:
+- Both queues are empty on return, high priority work run first each pass
+- Unknown work codes are discarded
+- The time taken is counted by LoopStatsDeferred
+
+*/
+void DeferDispatch(void)
+{
+  EventType stWork;
+  u32 u32StartUs = UsTimerNow();
+  
+  while( EventQueueGet(&G_stDeferHighQueue, &stWork) ||
+         EventQueueGet(&G_stDeferLowQueue, &stWork) )
+  {
+    if(stWork.u8Event < DEFER_WORK_COUNT)
+    {
+      Defer_apfnHandlers[stWork.u8Event](stWork.u8Param, stWork.u16Data);
+    }
+  }
+  
+  LoopStatsDeferred(u32StartUs);
+  
+} /* end DeferDispatch() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,56 @@
+/*!*********************************************************************************************************************
+@file defer.h                                                                
+@brief Header file for the SW_ISR deferred-work (bottom half) dispatcher
+
+**********************************************************************************************************************/
+
+#ifndef __DEFER_H
+#define __DEFER_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! @brief Work handler; runs in SW_ISR at low priority with the u8Param/u16Data that were posted */
+typedef void (*DeferHandlerType)(u8 u8Param_, u16 u16Data_);
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+bool DeferFromHighIsr(u8 u8Work_, u8 u8Param_, u16 u16Data_);
+bool DeferPost(u8 u8Work_, u8 u8Param_, u16 u16Data_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void DeferInitialize(void);
+void DeferDispatch(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/* Work codes; each indexes Defer_apfnHandlers in defer.c */
+#define DEFER_WORK_AUDIO_REFILL   (u8)0x00   /*!< @brief An audio buffer drained; u8Param = buffer index */
+#define DEFER_WORK_COUNT          (u8)1
+
+#define DEFER_HIGH_QUEUE_SIZE     8          /*!< @brief Slots for work posted by the high priority ISR */
+#define DEFER_LOW_QUEUE_SIZE      8          /*!< @brief Slots for work posted by low priority ISRs and main */
+
+
+#endif /* __DEFER_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -29,7 +29,7 @@ Global variable definitions with scope across entire project.
 All Global variable names shall start with "G_xxBsp"
 ***********************************************************************************************************************/
 /* New variables */
-
+volatile u8 G_u8SystemIdlePercent = 0;         /*!< @brief Share of the last 1000 loops spent in Idle, 0-100 */
 
 
 
@@ -37,6 +37,7 @@ All Global variable names shall start with "G_xxBsp"
 /* Existing variables (defined in other files -- should all contain the "extern" keyword) */
 extern volatile u32 G_u32SystemTime1ms;        /*!< @brief From main.c */
 extern volatile u32 G_u32SystemTime1s;         /*!< @brief From main.c */
+extern volatile u64 G_u64SystemTimeUs;         /*!< @brief From main.c */
 extern volatile u8  G_u8SystemFlags;           /*!< @brief From main.c */
 
 /***********************************************************************************************************************
@@ -60,21 +61,59 @@ Function Definitions
 
 @brief Loads all registers required to set up the processor clocks.
 
+The system starts at 64MHz; clock.c lowers it later when full speed isn't 
+needed.
+
 Requires:
-- NONE
+- CONFIG1 selects HFINTOSC at reset
 
 Promises:
-- EFC is set up with proper flash access wait states based on 48MHz system clock
-- PMC is set up with proper oscillators and clock sources
+- HFINTOSC at 64MHz, ready before returning
 
 */
 void ClockSetup(void)
 {
- 
+  OSCFRQ = 0x08;          // b'00001000' HFINTOSC 64MHz
+  while(!OSCSTATbits.HFOR);
   
 } /* end ClockSetup */
 
 
+/*!---------------------------------------------------------------------------------------------------------------------
+@fn void PowerSetup(void)
+
+@brief Switches off the clocks to every peripheral the firmware doesn't use.
+
+A module disabled in PMDx draws no power and its registers read as 0, so this 
+must run before any module is configured.  Anything that starts using another
+module must clear its bit here.
+
+Requires:
+- Called right after ClockSetup, before the peripherals are set up
+
+Promises:
+- Enabled: CRC, Timer0/1/2/3/5, DAC1, SPI1, UART1, DMA1 and the system clock network
+- Everything else is disabled
+- SLEEP instructions enter Idle mode
+
+*/
+void PowerSetup(void)
+{
+  PMD0 = 0x6B;  // b'01101011' Off: FVR, HLVD, SCAN, CLKR, IOC.  On: SYSC, CRC
+  PMD1 = 0xD0;  // b'11010000' Off: SMT1, TMR6, TMR4.  On: TMR5, TMR3, TMR2, TMR1, TMR0
+  PMD3 = 0xA7;  // b'10100111' Off: ACT, ADC, CM2, CM1, ZCD.  On: DAC1
+  PMD4 = 0x7F;  // b'01111111' Off: CWG3-1, DSM1, NCO3-1
+  PMD5 = 0x77;  // b'01110111' Off: PWM3-1, CCP3-1
+  PMD6 = 0xF5;  // b'11110101' Off: U5-U2, SPI2, I2C1.  On: U1, SPI1
+  PMD7 = 0xFF;  // b'11111111' Off: CLC8-1
+  PMD8 = 0x3E;  // b'00111110' Off: DMA6-2.  On: DMA1
+  
+  /* SLEEP enters Idle (peripherals keep running), no Doze */
+  CPUDOZE = 0x80; // b'10000000'
+  
+} /* end PowerSetup() */
+
+
 /*!---------------------------------------------------------------------------------------------------------------------
 @fn void GpioSetup(void)
 
@@ -85,6 +124,7 @@ Requires:
 
 Promises:
 - PORTA setup for LED output
+- PORTC and PPS set up for SPI1 and UART1
 
 */
 void GpioSetup(void)
@@ -93,20 +133,22 @@ void GpioSetup(void)
   ANSELA = 0x00;
   TRISA  = 0x00;
   
-  /* Setup PORTC for SPI connection */
+  /* Setup PORTC for SPI connection and UART1 */
   ANSELC = 0x00;
-  TRISC  = 0x6B; // b'0110 1011' RC2, RC4, RC7 outputs
-  LATC   = 0x94; // b'1001 0100' Try to set CS, MOSI and SCK high to start
+  TRISC  = 0x2B; // b'0010 1011' RC2, RC4, RC6, RC7 outputs
+  LATC   = 0xD4; // b'1101 0100' Try to set CS, MOSI and SCK high to start; U1TX idles high
   
   RC2PPS = 0x31; // SCK1 to RC2
   RC4PPS = 0x32; // MOSI to RC4
+  RC6PPS = 0x20; // U1TX to RC6
  
   SPI1SCKPPS = 0x12; // b'010 010' SCK1 on RC2
   SPI1SDIPPS = 0x13; // b'010 011' MISO  on RC3
+  U1RXPPS    = 0x15; // b'010 101' U1RX  on RC5
    
   /* Configure DAC1 for Vdd and Vss references, on, and RA2 output. */
   DAC1CON  = 0xA0;
-  DAC1DATL = 0;
+  HAL_DAC_WRITE(0);
  
 } /* end GpioSetup() */
 
@@ -127,6 +169,7 @@ void SysTickSetup(void)
 {
   G_u32SystemTime1ms = 0;      
   G_u32SystemTime1s  = 0;   
+  G_u64SystemTimeUs  = 0;
   
   /* Setup Timer2 for 1ms period 
    * Input clock: Fosc / 4 = 16MHz
@@ -134,7 +177,7 @@ void SysTickSetup(void)
    * 125 x 8us = 1ms so use Timer2 match to 124
    * No postscaler requried */
   
-  T2PR = 125;             // Match register for 1ms period
+  T2PR = 124;             // Match register for 1ms period (counts 0 to 124)
   T2CLKCON = 0x01;        // b'00000001' Fosc/4 input
   PIR3bits.TMR2IF = 0;    // Make sure interrupt flag is clear to start
   T2CON = 0xF0;           // b'11110000' Timer on, 1:128 prescale, 1:1 postscaler
@@ -144,24 +187,104 @@ void SysTickSetup(void)
 } /* end SysTickSetup() */
 
 
+/*!---------------------------------------------------------------------------------------------------------------------
+@fn void CycleCounterSetup(void)
+
+@brief Starts Timer5 as a free-running instruction-cycle counter for benchmarks.
+
+Requires:
+- Timer5 is not used for anything else
+
+Promises:
+- Timer5 counts Fosc/4 with no prescaler, so one count per instruction cycle
+- 16-bit reads are latched (RD16) so CYCLE_COUNT_READ is consistent
+- No interrupt is enabled; the count simply rolls over every 65536 cycles
+
+*/
+void CycleCounterSetup(void)
+{
+  T5CON  = 0x00;          // Stop the timer while configuring
+  T5GCON = 0x00;          // No gate
+  T5CLK  = 0x01;          // Fosc/4 input
+  TMR5H  = 0x00;
+  TMR5L  = 0x00;
+  T5CON  = 0x03;          // b'00000011' 1:1 prescale, synchronized, RD16, on
+  
+} /* end CycleCounterSetup() */
+
+
 
 /*!---------------------------------------------------------------------------------------------------------------------
 @fn void SystemSleep(void)
 
-@brief Puts the system into sleep mode.  
+@brief Idles the core until the next system tick.  
 
+Idle mode stops the CPU clock but keeps the system clock running, so every 
+timer, SPI and the DAC carry on and any enabled interrupt (sample timer, 
+systick, DMA) wakes the core within a couple of instruction cycles.
+Other interrupts that wake it are serviced and the core goes back to Idle
+until TMR2_ISR clears _SYSTEM_SLEEPING.
+
+GIEL is off between testing the flag and SLEEP so a tick that lands in 
+between can't leave the core idling for a whole extra period.  An interrupt
+flag still wakes the core with GIEL off; GIEL is then set so it is serviced
+straight away.  GIEH stays on, so the sample ISR is never held up.
+
+The ticks since the last return and the Timer2 count on entry say how
+long the pass took; the rest of the current tick is idle, or none of it if
+the tick's ISR is already pending.  G_u8SystemIdlePercent is the idle
+share of the time covered by the last 1000 calls; the power saved is that
+share times the difference between the run and Idle supply currents in the
+datasheet.  Time spent in ISRs while idle counts as idle.
 
 Requires:
-- 
- * 
+- Systick running on Timer2
+- Called once per pass of the super loop
+
 Promises:
-- 
+- Returns after the next TMR2_ISR
+- G_u8SystemIdlePercent updated every 1000 calls
 
 */
 void SystemSleep(void)
 {    
+  static u16 u16Calls = 0;
+  static u32 u32IdleCounts = 0;
+  static u32 u32Counts = 0;
+  static u32 u32WakeMs = 0;
+  u16 u16TickCounts = (u16)T2PR + 1;
+  
+  /* TMR2_ISR stays out so the tick count and Timer2 agree */
+  INTCON0bits.GIEL = 0;
+  
+  /* The pass covers every tick since the last return, up to the end of this one */
+  u32Counts += (G_u32SystemTime1ms - u32WakeMs + 1) * u16TickCounts;
+  if(!PIR3bits.TMR2IF)
+  {
+    u32IdleCounts += u16TickCounts - T2TMR;
+  }
+  
+  if(++u16Calls == 1000)
+  {
+    G_u8SystemIdlePercent = (u8)((u32IdleCounts * 100) / u32Counts);
+    u16Calls = 0;
+    u32IdleCounts = 0;
+    u32Counts = 0;
+  }
+  
   G_u8SystemFlags |= _SYSTEM_SLEEPING;
-  while(G_u8SystemFlags & _SYSTEM_SLEEPING);
+  while(G_u8SystemFlags & _SYSTEM_SLEEPING)
+  {
+    SLEEP();
+    NOP();
+    
+    /* Service whatever woke us */
+    INTCON0bits.GIEL = 1;
+    NOP();
+    INTCON0bits.GIEL = 0;
+  }
+  u32WakeMs = G_u32SystemTime1ms;
+  INTCON0bits.GIEL = 1;
   
 } /* end SystemSleep(void) */
 
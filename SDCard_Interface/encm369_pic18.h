@@ -43,6 +43,13 @@ Type Definitions
 #define HEARTBEAT_ON()          (LATA |= 0x80)  /*!< @brief Turns on Heartbeat LED */
 #define HEARTBEAT_OFF()         (LATA &= 0x7F)  /*!< @brief Turns off Heartbeat LED */
 
+/*! @brief Reads the free-running Timer5 instruction-cycle counter into u16 variable U16.
+TMR5L is read first so the RD16 latch gives a consistent TMR5H. */
+#define CYCLE_COUNT_READ(U16){   \
+U16 = TMR5L;                     \
+U16 |= (u16)TMR5H << 8;          \
+}
+
 /***********************************************************************************************************************
 &&&&& Function Declarations
 ***********************************************************************************************************************/
@@ -56,9 +63,11 @@ Type Definitions
 /*! @protectedsection */                                                                                            
 /*--------------------------------------------------------------------------------------------------------------------*/
 void ClockSetup(void);
+void PowerSetup(void);
 void GpioSetup(void);
 
 void SysTickSetup(void);
+void CycleCounterSetup(void);
 void SystemSleep(void);
 
 
@@ -0,0 +1,176 @@
+/*!*********************************************************************************************************************
+@file event_queue.c                                                                
+@brief Lock-free single-producer single-consumer event queues.
+
+ISRs hand events to the main loop by posting to a queue instead of setting
+shared volatile globals.  Multi-byte payloads travel inside the queue slot, 
+which the consumer only reads after the producer has published it by moving
+u8Head, so they can't tear.
+
+A queue must have exactly one producer context and one consumer context, 
+e.g. TMR1_ISR posts and DeferDispatch drains (see defer.c, which owns the
+queues in use).  Two ISRs of different priority need separate queues.  XC8 duplicates these functions when they are
+called from both interrupt and main-line code.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- NONE
+
+CONSTANTS
+- NONE
+
+TYPES
+- EventType
+- EventQueueType
+
+PUBLIC FUNCTIONS
+- bool EventQueuePost(EventQueueType* pstQueue_, u8 u8Event_, u8 u8Param_, u16 u16Data_)
+- bool EventQueueGet(EventQueueType* pstQueue_, EventType* pstEvent_)
+- u8 EventQueueCount(EventQueueType* pstQueue_)
+
+PROTECTED FUNCTIONS
+- NONE
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>EventQueue"
+***********************************************************************************************************************/
+/* New variables */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "EventQueue_<type>" and be declared as static.
+***********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool EventQueuePost(EventQueueType* pstQueue_, u8 u8Event_, u8 u8Param_, u16 u16Data_)
+
+@brief Adds an event to the queue.  Producer side only.
+
+Requires:
+- Called only from the queue's single producer context
+
+Promises:
+- If there is space, the event is written and then published by advancing 
+  u8Head, and true is returned
+- If the queue is full the event is dropped, u8Overflows is incremented and
+  false is returned
+
+*/
+bool EventQueuePost(EventQueueType* pstQueue_, u8 u8Event_, u8 u8Param_, u16 u16Data_)
+{
+  volatile EventType* pstSlot;
+  u8 u8Head = pstQueue_->u8Head;
+  
+  if( (u8)(u8Head - pstQueue_->u8Tail) > pstQueue_->u8Mask )
+  {
+    pstQueue_->u8Overflows++;
+    return false;
+  }
+  
+  /* Fill the slot completely before the consumer can see it */
+  pstSlot = &pstQueue_->pastSlots[u8Head & pstQueue_->u8Mask];
+  pstSlot->u8Event = u8Event_;
+  pstSlot->u8Param = u8Param_;
+  pstSlot->u16Data = u16Data_;
+  
+  pstQueue_->u8Head = u8Head + 1;
+  
+  return true;
+  
+} /* end EventQueuePost() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool EventQueueGet(EventQueueType* pstQueue_, EventType* pstEvent_)
+
+@brief Removes the oldest event from the queue.  Consumer side only.
+
+Requires:
+- Called only from the queue's single consumer context
+- pstEvent_ points to space for one event
+
+Promises:
+- If an event is waiting it is copied to *pstEvent_, its slot is released
+  by advancing u8Tail, and true is returned
+- Otherwise *pstEvent_ is untouched and false is returned
+
+*/
+bool EventQueueGet(EventQueueType* pstQueue_, EventType* pstEvent_)
+{
+  volatile EventType* pstSlot;
+  u8 u8Tail = pstQueue_->u8Tail;
+  
+  if(u8Tail == pstQueue_->u8Head)
+  {
+    return false;
+  }
+  
+  /* Copy out before releasing the slot to the producer */
+  pstSlot = &pstQueue_->pastSlots[u8Tail & pstQueue_->u8Mask];
+  pstEvent_->u8Event = pstSlot->u8Event;
+  pstEvent_->u8Param = pstSlot->u8Param;
+  pstEvent_->u16Data = pstSlot->u16Data;
+  
+  pstQueue_->u8Tail = u8Tail + 1;
+  
+  return true;
+  
+} /* end EventQueueGet() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 EventQueueCount(EventQueueType* pstQueue_)
+
+@brief Returns the number of events waiting.
+
+Requires:
+- NONE
+
+Promises:
+- Returns a snapshot; from the consumer side the real count can only be 
+  higher, from the producer side only lower
+
+*/
+u8 EventQueueCount(EventQueueType* pstQueue_)
+{
+  return (u8)(pstQueue_->u8Head - pstQueue_->u8Tail);
+  
+} /* end EventQueueCount() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,86 @@
+/*!*********************************************************************************************************************
+@file event_queue.h                                                                
+@brief Header file for the lock-free ISR to main loop event queues
+
+**********************************************************************************************************************/
+
+#ifndef __EVENT_QUEUE_H
+#define __EVENT_QUEUE_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! 
+@struct EventType
+@brief One queued event: what happened plus a small payload.
+*/
+typedef struct
+{
+  u8  u8Event;                    /*!< @brief EVENT_xxx code */
+  u8  u8Param;                    /*!< @brief Event-specific 8-bit parameter */
+  u16 u16Data;                    /*!< @brief Event-specific 16-bit payload (e.g. a timestamp or buffer index) */
+} EventType;
+
+/*! 
+@struct EventQueueType
+@brief Single-producer single-consumer ring of EventType.
+
+u8Head is only written by the producer and u8Tail only by the consumer.
+Both are single bytes so each side sees the other's index change 
+atomically on the 8-bit core, and neither side has to disable interrupts.
+The indices run freely and are masked on use, so all 2^n slots are usable.
+Define queues with EVENT_QUEUE_DEFINE.
+*/
+typedef struct
+{
+  volatile EventType* pastSlots;  /*!< @brief Storage for u8Mask + 1 events */
+  u8 u8Mask;                      /*!< @brief Queue size - 1; size is a power of two up to 128 */
+  volatile u8 u8Head;             /*!< @brief Free-running count of events posted */
+  volatile u8 u8Tail;             /*!< @brief Free-running count of events removed */
+  volatile u8 u8Overflows;        /*!< @brief Events dropped because the queue was full (producer side) */
+} EventQueueType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+bool EventQueuePost(EventQueueType* pstQueue_, u8 u8Event_, u8 u8Param_, u16 u16Data_);
+bool EventQueueGet(EventQueueType* pstQueue_, EventType* pstEvent_);
+u8   EventQueueCount(EventQueueType* pstQueue_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+
+/*! @brief Defines queue NAME with SIZE slots of static storage.  SIZE must be a power of two from 2 to 128;
+anything else fails to compile. */
+#define EVENT_QUEUE_DEFINE(NAME, SIZE)                                                          \
+  typedef char NAME##_SizeCheck[ ((((SIZE) & ((SIZE) - 1)) == 0) && ((SIZE) >= 2) && ((SIZE) <= 128)) ? 1 : -1 ]; \
+  static volatile EventType NAME##_astSlots[(SIZE)];                                            \
+  EventQueueType NAME = { NAME##_astSlots, (u8)((SIZE) - 1), 0, 0, 0 }
+
+/* Event codes are defined by the module that owns each queue, from 0x01 */
+#define EVENT_NONE                (u8)0x00   /*!< @brief Never posted */
+
+
+#endif /* __EVENT_QUEUE_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,53 @@
+/*!*********************************************************************************************************************
+@file hal.h                                                                
+@brief Register accesses that have side effects in hardware.
+
+Most of the firmware reads and writes registers directly, and that stays the
+same in the Linux host build (HOST_BUILD, see Host/), where every register is
+a byte of plain memory at its data-sheet address.  Plain memory is enough for
+configuration and status registers but not for an access that makes a 
+peripheral do something.  Those few accesses go through these macros so the
+host build can hand them to its peripheral models.
+
+On the PIC the macros are exactly the register writes they replace.
+
+**********************************************************************************************************************/
+
+#ifndef __HAL_H
+#define __HAL_H
+
+#ifndef HOST_BUILD
+
+/*! @brief Starts an SPI1 exchange of BYTE; wait with SPI1CON2bits.BUSY and read SPI1RXB as before */
+#define HAL_SPI_TX(BYTE)          {SPI1TXB = (BYTE); __nop(); __nop();}
+
+/*! @brief Sets the DAC1 output */
+#define HAL_DAC_WRITE(VALUE)      (DAC1DATL = (VALUE))
+
+/*! @brief Points DMA1 at COUNT bytes from ADDRESS and lets U1TX pace them out; DMA1SCNTIF follows the last byte */
+#define HAL_UART_DMA_START(ADDRESS, COUNT)  {DMASELECT = 0x00; DMAnSSA = (__uint24)(ADDRESS); \
+                                             DMAnSSZ = (COUNT); DMAnCON0bits.SIRQEN = 1;}
+
+/*! @brief True if U1RXB holds a received byte */
+#define HAL_UART_RX_READY()       (U1FIFObits.RXBE == 0)
+
+/*! @brief Pops the oldest received byte */
+#define HAL_UART_READ()           (U1RXB)
+
+#else
+
+#include "host.h"
+
+#define HAL_SPI_TX(BYTE)          HostSpiTransmit(BYTE)
+#define HAL_DAC_WRITE(VALUE)      HostDacWrite(VALUE)
+#define HAL_UART_DMA_START(ADDRESS, COUNT)  HostUartDma((ADDRESS), (COUNT))
+#define HAL_UART_RX_READY()       HostUartRxReady()
+#define HAL_UART_READ()           HostUartRead()
+
+#endif /* HOST_BUILD */
+
+
+#endif /* __HAL_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
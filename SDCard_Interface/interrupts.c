@@ -20,6 +20,10 @@ PROTECTED FUNCTIONS
 
 ISRs
 - SW_ISR
+- TMR0_ISR
+- TMR1_ISR
+- TMR3_ISR
+- TMR2_ISR
 
 ***********************************************************************************************************************/
 
@@ -36,11 +40,13 @@ All Global variable names shall start with "G_xxBsp"
 /* Existing variables (defined in other files -- should all contain the "extern" keyword) */
 extern volatile u32 G_u32SystemTime1ms;        /*!< @brief From main.c */
 extern volatile u32 G_u32SystemTime1s;         /*!< @brief From main.c */
+extern volatile u64 G_u64SystemTimeUs;         /*!< @brief From main.c */
+extern volatile u8  G_u8SystemTimeSequence;    /*!< @brief From main.c */
 extern volatile u8  G_u8SystemFlags;           /*!< @brief From main.c */
 
-extern volatile u8 G_u8UserAppFlags;           /*!< @brief From user_app.c */
-extern volatile u8 G_u8UserAppTimePeriodHi;    /*!< @brief From user_app.c */
-extern volatile u8 G_u8UserAppTimePeriodLo;    /*!< @brief From user_app.c */
+extern volatile TimerType G_astTimers[];       /*!< @brief From timer.c */
+extern volatile u8 G_u8AudioNextSample;        /*!< @brief From audio.c */
+extern volatile u8 G_u8StackGuardHighWater;    /*!< @brief From stack_guard.c */
 
 extern u8 G_au8UserAppsinTable[];              /*!< @brief From user_app.c */
 
@@ -62,12 +68,19 @@ Interrupt Routines
 @brief Loads all registers required to run interrupts.  Individual interrupts
  * are NOT enabled here, but globals are.
 
+Priority scheme: the Timer1 sample ISR is the only high priority source, so 
+nothing but another sample can delay a DAC update.  Every other source (the
+systick, Timer0 events, Timer3, SPI/DMA completion, SW_ISR deferred work) 
+is low priority and is preempted by the sample ISR.  Code that shares data
+with a low priority ISR masks GIEL only; masking GIEH holds up the audio.
+
 Requires:
 - CONFIG bits are correctly set:
  > 
 
 Promises:
 - Vector-table based interrupt system is enabled
+- Every source low priority except TMR1
 - Low and high priority global interrupts are enabled
 
 */
@@ -75,6 +88,27 @@ void InterruptSetup(void)
 {
   /* Interrupt configuration (MVECEN must be SET/ON in CONFIG3) */
   INTCON0bits.IPEN = 1; // 
+  
+  /* Everything low priority (all IPRx bits reset to high) */
+  IPR0  = 0x00;
+  IPR1  = 0x00;
+  IPR2  = 0x00;
+  IPR3  = 0x00;
+  IPR4  = 0x00;
+  IPR5  = 0x00;
+  IPR6  = 0x00;
+  IPR7  = 0x00;
+  IPR8  = 0x00;
+  IPR9  = 0x00;
+  IPR10 = 0x00;
+  IPR11 = 0x00;
+  IPR12 = 0x00;
+  IPR13 = 0x00;
+  IPR14 = 0x00;
+  IPR15 = 0x00;
+  
+  /* ...except the audio sample timer */
+  IPR3bits.TMR1IP = 1;
 
   /* Enable interrupts */  
   INTCON0bits.GIEH = 1; // Enable high priority interrupts
@@ -83,11 +117,29 @@ void InterruptSetup(void)
 } /* end InterruptSetup() */
 
 
-void __interrupt(irq(IRQ_SWINT), high_priority) SW_ISR(void)
+void __interrupt(irq(IRQ_SWINT), low_priority) SW_ISR(void)
 {
+  TRACE_RECORD(TRACE_EVENT_ISR_ENTER, TRACE_ISR_SW, 0);
   PIR0bits.SWIF = 0; // Clear the interrupt flag
   
-} /* end DEFAULT_ISR */
+  /* Run the bottom halves posted with DeferFromHighIsr / DeferPost */
+  DeferDispatch();
+  
+  TRACE_RECORD(TRACE_EVENT_ISR_EXIT, TRACE_ISR_SW, 0);
+  
+} /* end SW_ISR */
+
+
+/* UART1 transmit: DMA1 has sent a block from the ring */
+void __interrupt(irq(IRQ_DMA1SCNT), low_priority) DMA1SCNT_ISR(void)
+{
+  TRACE_RECORD(TRACE_EVENT_ISR_ENTER, TRACE_ISR_DMA1SCNT, 0);
+  PIR2bits.DMA1SCNTIF = 0;
+  UartDmaDone();
+  
+  TRACE_RECORD(TRACE_EVENT_ISR_EXIT, TRACE_ISR_DMA1SCNT, 0);
+  
+} /* end DMA1SCNT_ISR */
 
 
 void __interrupt(irq(default), low_priority) DEFAULT_ISR(void)
@@ -100,63 +152,117 @@ void __interrupt(irq(default), low_priority) DEFAULT_ISR(void)
     
   u32UnhandledCounter++;
   
+  /* Keep what led up to this; the trace survives the reset that gets out of here */
+  TRACE_RECORD(TRACE_EVENT_ISR_ENTER, TRACE_ISR_DEFAULT, 0);
+  TraceFreeze(TRACE_FREEZE_UNHANDLED);
+  
   /* Could disable interrupts here so the code carries on... */
   // INTCON0bits.GIEL = 0; // Enable low priority interrupts
 
 } /* end DEFAULT_ISR */
 
 
-/* User-timer for regular event updates
-   Requires G_u8UserAppTimePeriodHi/Lo and _U8_CONTINUOUS in G_u8UserAppFlags 
+/* Microsecond event queue: Timer0 has wrapped or reached the first deadline */
+void __interrupt(irq(IRQ_TMR0), low_priority) TMR0_ISR(void)
+{
+  ISR_PROFILE_ENTRY(TMR0L);
+  TRACE_RECORD(TRACE_EVENT_ISR_ENTER, TRACE_ISR_TMR0, 0);
+  
+  /* Clears TMR0IF itself, in step with the epoch */
+  UsTimerOverflow();
+  
+  TRACE_RECORD(TRACE_EVENT_ISR_EXIT, TRACE_ISR_TMR0, 0);
+  ISR_PROFILE_EXIT(ISR_PROFILE_TMR0);
+ 
+} /* end TMR0_ISR */
+
+
+/* Audio sample clock and user timer; the only high priority ISR.
+   Requires the reload, mode and call-back in G_astTimers[TIMER_1] (see TimerStart)
 */
 void __interrupt(irq(IRQ_TMR1), high_priority) TMR1_ISR(void)
 {
-  static u8 u8Index = 0;
-
-  /* Reload the timer - do this first to minimize latency */
-  TMR1H = G_u8UserAppTimePeriodHi;
-  TMR1L = G_u8UserAppTimePeriodLo;
+  /* Output the sample fetched last time - first, so the DAC updates a fixed
+   * number of cycles after the overflow */
+  HAL_DAC_WRITE(G_u8AudioNextSample);
   
-  /*********************************************************************
-   Handle the timing event here (usually a call-back function)
-   In this case, we load the next value of the sinusoid.
-   KEEP THIS SHORT!
-  **********************************************************************/
- 
+  ISR_PROFILE_ENTRY(TMR1L);
   
+  /* Reload the timer - do this next to minimize latency */
+  TMR1H = G_astTimers[TIMER_1].u8ReloadHi;
+  TMR1L = G_astTimers[TIMER_1].u8ReloadLo;
   
-  /*********************************************************************
-   End of event handling
-  **********************************************************************/
+  /* Handle the timing event with the registered call-back. KEEP IT SHORT! */
+  G_astTimers[TIMER_1].pfnCallback();
   
   /* Clear the interrupt flag */
   PIR3bits.TMR1IF = 0;
+  
+  /* The only place that may move STKPTR at run time */
+  STACK_GUARD_SAMPLE();
     
   /* Turn off the timer and interrupt if this is one-shot */
-  if( !(G_u8UserAppFlags & _U8_CONTINUOUS) )
+  if(G_astTimers[TIMER_1].eMode == TIMER_ONE_SHOT)
   {
     PIE3bits.TMR1IE = 0;
     T1CONbits.ON = 0;
   }
+  
+  ISR_PROFILE_EXIT(ISR_PROFILE_TMR1);
  
 } /* end TMR1_ISR */
 
 
+/* Second user timer, identical to TMR1_ISR but using G_astTimers[TIMER_3] */
+void __interrupt(irq(IRQ_TMR3), low_priority) TMR3_ISR(void)
+{
+  ISR_PROFILE_ENTRY(TMR3L);
+  TRACE_RECORD(TRACE_EVENT_ISR_ENTER, TRACE_ISR_TMR3, 0);
+  
+  TMR3H = G_astTimers[TIMER_3].u8ReloadHi;
+  TMR3L = G_astTimers[TIMER_3].u8ReloadLo;
+  
+  G_astTimers[TIMER_3].pfnCallback();
+  
+  PIR5bits.TMR3IF = 0;
+    
+  if(G_astTimers[TIMER_3].eMode == TIMER_ONE_SHOT)
+  {
+    PIE5bits.TMR3IE = 0;
+    T3CONbits.ON = 0;
+  }
+  
+  TRACE_RECORD(TRACE_EVENT_ISR_EXIT, TRACE_ISR_TMR3, 0);
+  ISR_PROFILE_EXIT(ISR_PROFILE_TMR3);
+ 
+} /* end TMR3_ISR */
+
+
 /* Manage the system tick functionality using Timer 2 */
-void __interrupt(irq(IRQ_TMR2), high_priority) TMR2_ISR(void)
+void __interrupt(irq(IRQ_TMR2), low_priority) TMR2_ISR(void)
 {
-  /* Clear the interrupt and sleep flags */
-  PIR3bits.TMR2IF = 0;
+  static u16 u16MsToSecond = 1000;
+  ISR_PROFILE_ENTRY(T2TMR);
+  
   G_u8SystemFlags &= ~_SYSTEM_SLEEPING;
   
-  /* Increment the system tick timer variable */
+  /* Clear the interrupt flag and increment the system tick timer variables.
+   * The sequence is odd until they are done; readers in time_base.c wait for
+   * it to be even, so TimeBaseUs() never sees the flag clear without the tick
+   * added. */
+  G_u8SystemTimeSequence++;
+  PIR3bits.TMR2IF = 0;
   G_u32SystemTime1ms++;
+  G_u64SystemTimeUs += TIME_BASE_US_PER_TICK;
   
-#if 0 /* For the sake of speed, don't bother with the 1s timer */
-  if( (G_u32SystemTime1ms % 1000) == 0)
+  /* Count down to the next second instead of a modulo */
+  if(--u16MsToSecond == 0)
   {
+    u16MsToSecond = 1000;
     G_u32SystemTime1s++;
   }
-#endif
+  G_u8SystemTimeSequence++;
+  
+  ISR_PROFILE_EXIT(ISR_PROFILE_TMR2);
  
 } /* end TMR2_ISR */
@@ -0,0 +1,191 @@
+/*!*********************************************************************************************************************
+@file isr_profile.c                                                                
+@brief Entry latency and execution time of the timer interrupts.
+
+Each profiled ISR starts with ISR_PROFILE_ENTRY and ends with 
+ISR_PROFILE_EXIT.  Entry latency comes from the ISR's own timer: right after
+an overflow (or Timer2 match) the timer has counted up from 0 once for every
+tick since the event, so its low byte at entry is the latency in that 
+timer's ticks.  The spread between min and max latency is the jitter.
+Execution time is the Timer5 cycle count between the two macros, so it 
+leaves out the context save and restore.
+
+Set ISR_PROFILE in configuration.h to build it in; with it clear the macros
+are empty and this file only holds an unused reset function.  Compare the 
+TMR1 latency with and without the systick running to see what sharing a
+priority level costs the audio.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_astIsrProfile[]
+
+CONSTANTS
+- ISR_PROFILE_TMR0, ISR_PROFILE_TMR1, ISR_PROFILE_TMR2, ISR_PROFILE_TMR3
+- ISR_PROFILE_VECTORS
+- ISR_PROFILE_BINS
+
+TYPES
+- IsrProfileType
+
+PUBLIC FUNCTIONS
+- void IsrProfileReset(void)
+
+PROTECTED FUNCTIONS
+- void IsrProfileRecord(u8 u8Vector_, u8 u8Latency_, u16 u16StartCycles_)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>IsrProfile"
+***********************************************************************************************************************/
+/* New variables */
+#if ISR_PROFILE
+volatile IsrProfileType G_astIsrProfile[ISR_PROFILE_VECTORS];   /*!< @brief Per-vector results, indexed by ISR_PROFILE_xxx */
+#endif
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "IsrProfile_<type>" and be declared as static.
+***********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void IsrProfileReset(void)
+
+@brief Clears the results of every vector.
+
+Requires:
+- NONE
+
+Promises:
+- Counts and histograms zero; minimums at their highest value so the next
+  interrupt sets them
+
+*/
+void IsrProfileReset(void)
+{
+#if ISR_PROFILE
+  u8 u8GieSave = INTCON0bits.GIEH;
+  
+  INTCON0bits.GIEH = 0;
+  for(u8 i = 0; i < ISR_PROFILE_VECTORS; i++)
+  {
+    G_astIsrProfile[i].u32Count     = 0;
+    G_astIsrProfile[i].u8LatencyMin = 0xFF;
+    G_astIsrProfile[i].u8LatencyMax = 0;
+    G_astIsrProfile[i].u16CyclesMin = 0xFFFF;
+    G_astIsrProfile[i].u16CyclesMax = 0;
+    
+    for(u8 j = 0; j < ISR_PROFILE_BINS; j++)
+    {
+      G_astIsrProfile[i].au32LatencyHistogram[j] = 0;
+    }
+  }
+  INTCON0bits.GIEH = u8GieSave;
+#endif
+  
+} /* end IsrProfileReset() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void IsrProfileRecord(u8 u8Vector_, u8 u8Latency_, u16 u16StartCycles_)
+
+@brief Adds one interrupt to a vector's results.  Only called through 
+ISR_PROFILE_EXIT.
+
+Requires:
+- u8Vector_ is an ISR_PROFILE_xxx index
+- u16StartCycles_ is the Timer5 count taken by ISR_PROFILE_ENTRY
+
+Promises:
+- Count, min/max latency, min/max cycles and the latency histogram updated
+
+*/
+void IsrProfileRecord(u8 u8Vector_, u8 u8Latency_, u16 u16StartCycles_)
+{
+#if ISR_PROFILE
+  volatile IsrProfileType* pstProfile = &G_astIsrProfile[u8Vector_];
+  u16 u16Cycles;
+  u8 u8Bin;
+  
+  CYCLE_COUNT_READ(u16Cycles);
+  u16Cycles -= u16StartCycles_;
+  
+  pstProfile->u32Count++;
+  
+  if(u8Latency_ < pstProfile->u8LatencyMin)
+  {
+    pstProfile->u8LatencyMin = u8Latency_;
+  }
+  if(u8Latency_ > pstProfile->u8LatencyMax)
+  {
+    pstProfile->u8LatencyMax = u8Latency_;
+  }
+  
+  if(u16Cycles < pstProfile->u16CyclesMin)
+  {
+    pstProfile->u16CyclesMin = u16Cycles;
+  }
+  if(u16Cycles > pstProfile->u16CyclesMax)
+  {
+    pstProfile->u16CyclesMax = u16Cycles;
+  }
+  
+  /* 0-3 get their own bin, then one bin per power of two */
+  if(u8Latency_ < 4)
+  {
+    u8Bin = u8Latency_;
+  }
+  else if(u8Latency_ < 8)
+  {
+    u8Bin = 4;
+  }
+  else if(u8Latency_ < 16)
+  {
+    u8Bin = 5;
+  }
+  else if(u8Latency_ < 32)
+  {
+    u8Bin = 6;
+  }
+  else
+  {
+    u8Bin = 7;
+  }
+  pstProfile->au32LatencyHistogram[u8Bin]++;
+#endif
+  
+} /* end IsrProfileRecord() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
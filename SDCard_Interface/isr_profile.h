@@ -0,0 +1,92 @@
+/*!*********************************************************************************************************************
+@file isr_profile.h                                                                
+@brief Header file for the ISR latency and execution time profiler
+
+**********************************************************************************************************************/
+
+#ifndef __ISR_PROFILE_H
+#define __ISR_PROFILE_H
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/* Profiled vectors: index into G_astIsrProfile[] */
+#define ISR_PROFILE_TMR0          (u8)0                  /*!< @brief Latency in 1us Timer0 ticks */
+#define ISR_PROFILE_TMR1          (u8)1                  /*!< @brief Latency in 0.5us Timer1 ticks */
+#define ISR_PROFILE_TMR2          (u8)2                  /*!< @brief Latency in 8us Timer2 counts */
+#define ISR_PROFILE_TMR3          (u8)3                  /*!< @brief Latency in 0.5us Timer3 ticks */
+#define ISR_PROFILE_VECTORS       (u8)4
+
+#define ISR_PROFILE_BINS          (u8)8                  /*!< @brief Latency histogram: 0,1,2,3,4-7,8-15,16-31,32+ ticks */
+
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! 
+@struct IsrProfileType
+@brief Measurements for one interrupt vector.
+*/
+typedef struct
+{
+  u32 u32Count;                                 /*!< @brief Interrupts recorded */
+  u8  u8LatencyMin;                             /*!< @brief Fewest timer ticks from the event to ISR entry */
+  u8  u8LatencyMax;                             /*!< @brief Most timer ticks from the event to ISR entry */
+  u16 u16CyclesMin;                             /*!< @brief Shortest ISR body in instruction cycles */
+  u16 u16CyclesMax;                             /*!< @brief Longest ISR body in instruction cycles */
+  u32 au32LatencyHistogram[ISR_PROFILE_BINS];   /*!< @brief Interrupt counts by entry latency */
+} IsrProfileType;
+
+
+/**********************************************************************************************************************
+Macros
+**********************************************************************************************************************/
+#if ISR_PROFILE
+
+/*! @brief First statement of a profiled ISR.  LATENCY is an expression giving the
+timer ticks since the interrupt event, e.g. TMR1L just after the overflow.
+It is read before anything else so the profiler adds as little as possible. */
+#define ISR_PROFILE_ENTRY(LATENCY)          \
+u8 u8IsrProfileLatency = (u8)(LATENCY);     \
+u16 u16IsrProfileStart;                     \
+CYCLE_COUNT_READ(u16IsrProfileStart)
+
+/*! @brief Last statement of a profiled ISR */
+#define ISR_PROFILE_EXIT(VECTOR)            \
+IsrProfileRecord(VECTOR, u8IsrProfileLatency, u16IsrProfileStart)
+
+#else
+
+#define ISR_PROFILE_ENTRY(LATENCY)
+#define ISR_PROFILE_EXIT(VECTOR)
+
+#endif /* ISR_PROFILE */
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void IsrProfileReset(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void IsrProfileRecord(u8 u8Vector_, u8 u8Latency_, u16 u16StartCycles_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+#endif /* __ISR_PROFILE_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,295 @@
+/*!*********************************************************************************************************************
+@file loop_stats.c                                                                
+@brief Busy and idle time of the super loop.
+
+main() marks the end of the work in each pass (just before SystemSleep) and 
+the start of the next pass (just after it).  The busy time of each pass is
+the time between the two marks, measured on the 1us Timer0 clock from 
+us_timer.c.  This is what HEARTBEAT_OFF/ON show on a scope, but counted:
+the worst pass, a histogram of pass lengths and the passes that overran the
+1ms tick.
+
+Deferred work (defer.c) runs in SW_ISR, which mostly fires while the loop
+is in SystemSleep: an SD sector refill would otherwise count as idle.
+DeferDispatch() times each run with LoopStatsDeferred(); time spent in it
+while the loop was asleep is moved from idle to busy, so the busy share is
+CPU time, and the longest run is kept as its own figure.  A run while the
+loop is busy is already inside that pass's busy time.
+
+The numbers live in G_stLoopStats.  The histogram bins are:
+
+  Bin  Busy time          Bin  Busy time
+  0    < 50us             4    < 750us
+  1    < 100us            5    < 1000us
+  2    < 250us            6    < 2000us
+  3    < 500us            7    2000us or more
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_stLoopStats
+
+CONSTANTS
+- LOOP_STATS_BINS
+- LOOP_STATS_TICK_US
+
+TYPES
+- LoopStatsType
+
+PUBLIC FUNCTIONS
+- void LoopStatsReset(void)
+- u8 LoopStatsBusyPercent(void)
+
+PROTECTED FUNCTIONS
+- void LoopStatsBusyStart(void)
+- void LoopStatsBusyEnd(void)
+- void LoopStatsDeferred(u32 u32StartUs_)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>LoopStats"
+***********************************************************************************************************************/
+/* New variables */
+LoopStatsType G_stLoopStats;                              /*!< @brief Super loop measurements */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "LoopStats_<type>" and be declared as static.
+***********************************************************************************************************************/
+/*! @brief Upper limit of each histogram bin except the last */
+static const u16 LoopStats_au16BinLimitUs[LOOP_STATS_BINS - 1] = {50, 100, 250, 500, 750, 1000, 2000};
+
+static u32 LoopStats_u32BusyStartUs;                      /*!< @brief UsTimerNow() at the start of this pass */
+static u32 LoopStats_u32IdleStartUs;                      /*!< @brief UsTimerNow() when the last pass went idle */
+static bool LoopStats_bStarted;                           /*!< @brief false until the first LoopStatsBusyStart */
+static volatile bool LoopStats_bIdle;                     /*!< @brief Between LoopStatsBusyEnd and LoopStatsBusyStart */
+static volatile u32 LoopStats_u32IdleDeferUs;             /*!< @brief Deferred work time since the loop went idle */
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void LoopStatsReset(void)
+
+@brief Clears every statistic, e.g. before measuring one use case.
+
+Requires:
+- NONE
+
+Promises:
+- G_stLoopStats is all zero; measuring restarts at the next pass
+
+*/
+void LoopStatsReset(void)
+{
+  G_stLoopStats.u32Loops      = 0;
+  G_stLoopStats.u32Overruns   = 0;
+  G_stLoopStats.u32BusyUs     = 0;
+  G_stLoopStats.u32IdleUs     = 0;
+  G_stLoopStats.u32DeferUs    = 0;
+  G_stLoopStats.u16LastBusyUs = 0;
+  G_stLoopStats.u16MaxBusyUs  = 0;
+  G_stLoopStats.u16PeakBusyUs = 0;
+  G_stLoopStats.u16MaxDeferUs = 0;
+  
+  for(u8 i = 0; i < LOOP_STATS_BINS; i++)
+  {
+    G_stLoopStats.au32Histogram[i] = 0;
+  }
+  
+  LoopStats_bStarted = false;
+  
+} /* end LoopStatsReset() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 LoopStatsBusyPercent(void)
+
+@brief Returns the share of time spent busy since the last reset.
+
+Requires:
+- NONE
+
+Promises:
+- Returns 0-100; 0 if nothing has been measured
+
+*/
+u8 LoopStatsBusyPercent(void)
+{
+  u32 u32Total = G_stLoopStats.u32BusyUs + G_stLoopStats.u32IdleUs;
+  
+  if(u32Total < 100)
+  {
+    return 0;
+  }
+  
+  return (u8)(G_stLoopStats.u32BusyUs / (u32Total / 100));
+  
+} /* end LoopStatsBusyPercent() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void LoopStatsBusyStart(void)
+
+@brief Marks the start of a pass; main() calls it right after SystemSleep.
+
+Requires:
+- UsTimerInitialize has been called
+
+Promises:
+- The time since LoopStatsBusyEnd is added to u32IdleUs, less any deferred
+  work run meanwhile, which is added to u32BusyUs instead
+
+*/
+void LoopStatsBusyStart(void)
+{
+  u32 u32DeferUs;
+  u8 u8GieSave = INTCON0bits.GIEL;
+  
+  /* SW_ISR stays out while the time and the deferred work are taken together */
+  INTCON0bits.GIEL = 0;
+  LoopStats_u32BusyStartUs = UsTimerNow();
+  LoopStats_bIdle = false;
+  u32DeferUs = LoopStats_u32IdleDeferUs;
+  LoopStats_u32IdleDeferUs = 0;
+  INTCON0bits.GIEL = u8GieSave;
+  
+  if(LoopStats_bStarted)
+  {
+    G_stLoopStats.u32IdleUs += (LoopStats_u32BusyStartUs - LoopStats_u32IdleStartUs) - u32DeferUs;
+    G_stLoopStats.u32BusyUs += u32DeferUs;
+  }
+  LoopStats_bStarted = true;
+  
+} /* end LoopStatsBusyStart() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void LoopStatsBusyEnd(void)
+
+@brief Marks the end of the work in a pass; main() calls it right before 
+SystemSleep.
+
+Requires:
+- UsTimerInitialize has been called
+
+Promises:
+- The pass is counted in the totals, the worst case, the histogram and, if
+  it was longer than LOOP_STATS_TICK_US, the overruns
+- Does nothing until the first LoopStatsBusyStart
+
+*/
+void LoopStatsBusyEnd(void)
+{
+  u32 u32BusyUs;
+  u8 u8Bin;
+  u8 u8GieSave = INTCON0bits.GIEL;
+  
+  INTCON0bits.GIEL = 0;
+  LoopStats_u32IdleStartUs = UsTimerNow();
+  LoopStats_bIdle = true;
+  INTCON0bits.GIEL = u8GieSave;
+  
+  if(!LoopStats_bStarted)
+  {
+    return;
+  }
+  
+  u32BusyUs = LoopStats_u32IdleStartUs - LoopStats_u32BusyStartUs;
+  if(u32BusyUs > 0xFFFF)
+  {
+    u32BusyUs = 0xFFFF;
+  }
+  
+  G_stLoopStats.u32Loops++;
+  G_stLoopStats.u32BusyUs += u32BusyUs;
+  G_stLoopStats.u16LastBusyUs = (u16)u32BusyUs;
+  
+  if(u32BusyUs > G_stLoopStats.u16MaxBusyUs)
+  {
+    G_stLoopStats.u16MaxBusyUs = (u16)u32BusyUs;
+  }
+  
+  if(u32BusyUs > G_stLoopStats.u16PeakBusyUs)
+  {
+    G_stLoopStats.u16PeakBusyUs = (u16)u32BusyUs;
+  }
+  
+  if(u32BusyUs > LOOP_STATS_TICK_US)
+  {
+    G_stLoopStats.u32Overruns++;
+  }
+  
+  for(u8Bin = 0; u8Bin < (LOOP_STATS_BINS - 1); u8Bin++)
+  {
+    if(u32BusyUs < LoopStats_au16BinLimitUs[u8Bin])
+    {
+      break;
+    }
+  }
+  G_stLoopStats.au32Histogram[u8Bin]++;
+  
+} /* end LoopStatsBusyEnd() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void LoopStatsDeferred(u32 u32StartUs_)
+
+@brief Counts one DeferDispatch run that started at UsTimerNow() u32StartUs_.
+
+Requires:
+- Called only from DeferDispatch in SW_ISR, at the end of its run
+
+Promises:
+- The run is added to u32DeferUs and u16MaxDeferUs
+- If the loop is in SystemSleep the run is kept to be moved from idle to
+  busy time by the next LoopStatsBusyStart
+
+*/
+void LoopStatsDeferred(u32 u32StartUs_)
+{
+  u32 u32DeferUs = UsTimerNow() - u32StartUs_;
+  
+  G_stLoopStats.u32DeferUs += u32DeferUs;
+  if(u32DeferUs > G_stLoopStats.u16MaxDeferUs)
+  {
+    G_stLoopStats.u16MaxDeferUs = (u32DeferUs > 0xFFFF) ? 0xFFFF : (u16)u32DeferUs;
+  }
+  
+  if(LoopStats_bIdle)
+  {
+    LoopStats_u32IdleDeferUs += u32DeferUs;
+  }
+  
+} /* end LoopStatsDeferred() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
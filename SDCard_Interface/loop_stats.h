@@ -0,0 +1,69 @@
+/*!*********************************************************************************************************************
+@file loop_stats.h                                                                
+@brief Header file for super loop utilization statistics
+
+**********************************************************************************************************************/
+
+#ifndef __LOOP_STATS_H
+#define __LOOP_STATS_H
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define LOOP_STATS_BINS           (u8)8                  /*!< @brief Histogram bins, see LoopStats_au16BinLimitUs */
+#define LOOP_STATS_TICK_US        (u16)1000              /*!< @brief Busy time above this is an overrun */
+
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! 
+@struct LoopStatsType
+@brief Everything measured about the super loop.  Kept in one struct so a 
+debugger, the debug channel or the host simulator can read it in one go.
+*/
+typedef struct
+{
+  u32 u32Loops;                           /*!< @brief Passes of the super loop measured */
+  u32 u32Overruns;                        /*!< @brief Passes whose busy time was over LOOP_STATS_TICK_US */
+  u32 u32BusyUs;                          /*!< @brief Total busy time (wraps after ~71 minutes) */
+  u32 u32IdleUs;                          /*!< @brief Total time in SystemSleep less deferred work (wraps after ~71 minutes) */
+  u32 u32DeferUs;                         /*!< @brief Total time in DeferDispatch (wraps after ~71 minutes) */
+  u16 u16LastBusyUs;                      /*!< @brief Busy time of the most recent pass */
+  u16 u16MaxBusyUs;                       /*!< @brief Worst busy time seen (saturates at 0xFFFF) */
+  u16 u16PeakBusyUs;                      /*!< @brief Worst busy time since a reader last cleared it (telemetry.c) */
+  u16 u16MaxDeferUs;                      /*!< @brief Longest DeferDispatch run (saturates at 0xFFFF) */
+  u32 au32Histogram[LOOP_STATS_BINS];     /*!< @brief Pass counts by busy time */
+} LoopStatsType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void LoopStatsReset(void);
+u8   LoopStatsBusyPercent(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void LoopStatsBusyStart(void);
+void LoopStatsBusyEnd(void);
+void LoopStatsDeferred(u32 u32StartUs_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+#endif /* __LOOP_STATS_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
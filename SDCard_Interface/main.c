@@ -12,6 +12,8 @@ All Global variable names shall start with "G_"
 /* New variables */
 volatile u32 G_u32SystemTime1ms = 0;     /*!< @brief Global system time incremented every ms, max 2^32 (~49 days) */
 volatile u32 G_u32SystemTime1s  = 0;     /*!< @brief Global system time incremented every second, max 2^32 (~136 years) */
+volatile u64 G_u64SystemTimeUs  = 0;     /*!< @brief Global system time in us at the last tick; read with TimeBaseUs() */
+volatile u8  G_u8SystemTimeSequence = 0; /*!< @brief Bumped before and after every system time update (see time_base.c) */
 volatile u8  G_u8SystemFlags    = 0;     /*!< @brief Global system flags */
 
 /*--------------------------------------------------------------------------------------------------------------------*/
@@ -34,24 +36,52 @@ Variable names shall start with "Main_" and be declared as static.
 void main(void)
 {
   G_u8SystemFlags |= _SYSTEM_INITIALIZING;
+  StackGuardInitialize();   /* Before anything can interrupt */
 
   /* Low level initialization */
   ClockSetup();
+  PowerSetup();
   GpioSetup();
   InterruptSetup();
 
   SysTickSetup();
+  CycleCounterSetup();
+  UsTimerInitialize();
+  TimerInitialize();
+  TimerWheelInitialize();
+  DeferInitialize();
+  TraceInitialize();
 
   /* Driver initialization */
   SPI_Init();
   SD_Init();
+#if SD_CACHE
+  SDCache_Init();
+#endif
+  UartInitialize();
+  ClockInitialize();
     
   /* Application initialization */
+  AudioInitialize();
+  TelemetryInitialize();
   UserAppInitialize();
+  SchedulerInitialize();
   
   SD_ReadBlock(0x00,0x00,0x00,0x00);      //Ex D TODO: Delete this line.
   __nop();                                //Ex D TODO: Delete this line. 
+  
+#if CRC16_BENCHMARK
+  CRC16_Benchmark();
+#endif
+
+#if TIMER_MEASURE_DISPATCH
+  TimerMeasureDispatch();
+#endif
     
+  LoopStatsReset();
+  IsrProfileReset();
+  RegionProfileReset();
+  
   /* Exit initialization */
   G_u8SystemFlags &= ~_SYSTEM_INITIALIZING;
     
@@ -60,12 +90,14 @@ void main(void)
   {
     /* Drivers */
     
-    /* Applications */
-    UserAppRun();
+    /* Applications: every task in the scheduler table that is due */
+    SchedulerRun();
     
     /* System sleep */
     HEARTBEAT_OFF();
+    LoopStatsBusyEnd();
     SystemSleep();     
+    LoopStatsBusyStart();
     HEARTBEAT_ON();
     
   } /* end while(1) main super loop */
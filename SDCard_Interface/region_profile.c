@@ -0,0 +1,317 @@
+/*!*********************************************************************************************************************
+@file region_profile.c
+@brief Call counts and run times of named code regions, sent as telemetry frames.
+
+A region is marked with REGION_PROFILE_BEGIN(NAME) and REGION_PROFILE_END(NAME)
+around the code to measure.  Each pass adds one call, its Timer5 cycle count
+to the total and, if it is the longest so far, the maximum.  The counts are
+instruction cycles at whatever speed the clock was running.  Audio regions
+always run at 64MHz because playback holds the full clock.
+
+Timer5 wraps every 65536 cycles (4ms at 64MHz), and an SD read waiting on
+the card can take longer, so each pass is also timed with UsTimerNow().  A
+pass too long for Timer5 is costed from its microseconds instead.
+
+The host simulator doesn't charge time for code, so this is where real
+numbers come from.  Set REGION_PROFILE in configuration.h to build it in;
+with it clear the macros are empty, RegionProfileRun is not scheduled and
+this file only holds empty functions.
+
+Send 'p' on the UART (115200 8N1) for a dump, or 'r' to clear the table;
+telemetry.c takes the commands.  The dump is a snapshot taken when it
+starts, sent as one TELEMETRY_TYPE_REGION frame per region, at most one per
+10ms RegionProfileRun call and only when it fits in the UART ring.  The
+payload (little-endian) is:
+
+  Offset  Size  Field
+  0       1     Region index, REGION_PROFILE_xxx
+  1       4     Calls
+  5       8     Total cycles
+  13      4     Maximum cycles
+  17      -     Name, e.g. "sd_read", to the end of the payload
+
+Limits:
+- Passes over 65535 cycles are only as exact as the microsecond clock.
+- Time spent in interrupts that preempt a region counts towards it.
+- Regions may run in the main loop and low priority ISRs but not in
+  TMR1_ISR: the table is updated with GIEL clear.
+
+New regions (beat detection, the sequencer tick) need an index in
+region_profile.h and a name in RegionProfile_apcNames[].
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_astRegionProfile[]
+
+CONSTANTS
+- REGION_PROFILE_SD_READ, REGION_PROFILE_SD_WRITE, REGION_PROFILE_AUDIO_REFILL,
+  REGION_PROFILE_AUDIO_DECODE
+- REGION_PROFILE_REGIONS
+
+TYPES
+- RegionProfileType
+
+PUBLIC FUNCTIONS
+- void RegionProfileReset(void)
+- void RegionProfileDumpRequest(void)
+
+PROTECTED FUNCTIONS
+- void RegionProfileRecord(u8 u8Region_, u16 u16StartCycles_, u32 u32StartUs_)
+- void RegionProfileRun(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>RegionProfile"
+***********************************************************************************************************************/
+/* New variables */
+#if REGION_PROFILE
+volatile RegionProfileType G_astRegionProfile[REGION_PROFILE_REGIONS];   /*!< @brief Per-region results, indexed by REGION_PROFILE_xxx */
+#endif
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "RegionProfile_<type>" and be declared as static.
+***********************************************************************************************************************/
+#if REGION_PROFILE
+static const char* const RegionProfile_apcNames[REGION_PROFILE_REGIONS] =
+{
+  "sd_read",                                              /* REGION_PROFILE_SD_READ */
+  "sd_write",                                             /* REGION_PROFILE_SD_WRITE */
+  "audio_refill",                                         /* REGION_PROFILE_AUDIO_REFILL */
+  "audio_decode",                                         /* REGION_PROFILE_AUDIO_DECODE */
+};
+
+static RegionProfileType RegionProfile_astSnapshot[REGION_PROFILE_REGIONS];  /*!< @brief Table as of the dump request */
+static bool RegionProfile_bDumpRequested;
+static u8 RegionProfile_u8DumpRegion = 0xFF;              /*!< @brief Next region to send; 0xFF when idle */
+
+static void RegionProfileDumpRegion(void);
+#endif
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void RegionProfileReset(void)
+
+@brief Clears the results of every region.
+
+Requires:
+- NONE
+
+Promises:
+- Calls, totals and maximums zero; a dump in progress carries on from its
+  snapshot
+
+*/
+void RegionProfileReset(void)
+{
+#if REGION_PROFILE
+  u8 u8GieSave = INTCON0bits.GIEL;
+
+  INTCON0bits.GIEL = 0;
+  for(u8 i = 0; i < REGION_PROFILE_REGIONS; i++)
+  {
+    G_astRegionProfile[i].u32Calls       = 0;
+    G_astRegionProfile[i].u64TotalCycles = 0;
+    G_astRegionProfile[i].u32MaxCycles   = 0;
+  }
+  INTCON0bits.GIEL = u8GieSave;
+#endif
+
+} /* end RegionProfileReset() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void RegionProfileDumpRequest(void)
+
+@brief Asks for the table to be sent over the UART, as a 'p' from the UART does.
+
+Requires:
+- NONE
+
+Promises:
+- RegionProfileRun starts a dump on its next call unless one is under way
+
+*/
+void RegionProfileDumpRequest(void)
+{
+#if REGION_PROFILE
+  RegionProfile_bDumpRequested = true;
+#endif
+
+} /* end RegionProfileDumpRequest() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void RegionProfileRecord(u8 u8Region_, u16 u16StartCycles_, u32 u32StartUs_)
+
+@brief Adds one pass of a region.  Only called through REGION_PROFILE_END.
+
+Requires:
+- u8Region_ is a REGION_PROFILE_xxx index
+- u16StartCycles_ and u32StartUs_ are the Timer5 count and UsTimerNow() 
+  taken by REGION_PROFILE_BEGIN
+- Not called from TMR1_ISR
+
+Promises:
+- Calls, total and maximum cycles updated; a pass of more than 65535 cycles
+  at the current operating point is counted from its microseconds
+
+*/
+void RegionProfileRecord(u8 u8Region_, u16 u16StartCycles_, u32 u32StartUs_)
+{
+#if REGION_PROFILE
+  volatile RegionProfileType* pstProfile = &G_astRegionProfile[u8Region_];
+  u16 u16Cycles;
+  u32 u32Cycles;
+  u32 u32ElapsedUs;
+  u8 u8CyclesPerUs;
+  u8 u8GieSave;
+
+  CYCLE_COUNT_READ(u16Cycles);
+  u32ElapsedUs = UsTimerNow() - u32StartUs_;
+  u32Cycles = (u16)(u16Cycles - u16StartCycles_);
+
+  /* Timer5 has wrapped; the extra microsecond covers the two clocks not 
+  being read together */
+  u8CyclesPerUs = ClockCyclesPerUs();
+  if( (u32ElapsedUs + 1) * u8CyclesPerUs > 0xFFFF )
+  {
+    u32Cycles = u32ElapsedUs * u8CyclesPerUs;
+  }
+
+  /* The same region can run in main and in SW_ISR */
+  u8GieSave = INTCON0bits.GIEL;
+  INTCON0bits.GIEL = 0;
+
+  pstProfile->u32Calls++;
+  pstProfile->u64TotalCycles += u32Cycles;
+  if(u32Cycles > pstProfile->u32MaxCycles)
+  {
+    pstProfile->u32MaxCycles = u32Cycles;
+  }
+
+  INTCON0bits.GIEL = u8GieSave;
+#endif
+
+} /* end RegionProfileRecord() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void RegionProfileRun(void)
+
+@brief Scheduler task: sends dumps.
+
+Requires:
+- RegionProfileReset has been called
+- In the scheduler table only when REGION_PROFILE is set
+
+Promises:
+- A dump request snapshots the table and starts a dump
+- At most one region frame is queued per call, and only when it fits
+
+*/
+void RegionProfileRun(void)
+{
+#if REGION_PROFILE
+  u8 u8GieSave;
+
+  if(RegionProfile_bDumpRequested && (RegionProfile_u8DumpRegion == 0xFF))
+  {
+    RegionProfile_bDumpRequested = false;
+
+    u8GieSave = INTCON0bits.GIEL;
+    INTCON0bits.GIEL = 0;
+    for(u8 i = 0; i < REGION_PROFILE_REGIONS; i++)
+    {
+      RegionProfile_astSnapshot[i] = G_astRegionProfile[i];
+    }
+    INTCON0bits.GIEL = u8GieSave;
+
+    RegionProfile_u8DumpRegion = 0;
+  }
+
+  if(RegionProfile_u8DumpRegion != 0xFF)
+  {
+    RegionProfileDumpRegion();
+  }
+#endif
+
+} /* end RegionProfileRun() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+#if REGION_PROFILE
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void RegionProfileDumpRegion(void)
+
+@brief Queues the next region's frame if the UART ring has room for it.
+
+Requires:
+- RegionProfile_u8DumpRegion is a REGION_PROFILE_xxx index
+
+Promises:
+- On success RegionProfile_u8DumpRegion moves on, to 0xFF after the last region
+
+*/
+static void RegionProfileDumpRegion(void)
+{
+  u8 au8Payload[TELEMETRY_PAYLOAD_MAX];
+  u8 u8Length;
+  RegionProfileType* pstRegion = &RegionProfile_astSnapshot[RegionProfile_u8DumpRegion];
+  const char* pcName = RegionProfile_apcNames[RegionProfile_u8DumpRegion];
+
+  u8Length = TelemetryPack(au8Payload, 0,        RegionProfile_u8DumpRegion,              1);
+  u8Length = TelemetryPack(au8Payload, u8Length, pstRegion->u32Calls,                     4);
+  u8Length = TelemetryPack(au8Payload, u8Length, (u32)pstRegion->u64TotalCycles,          4);
+  u8Length = TelemetryPack(au8Payload, u8Length, (u32)(pstRegion->u64TotalCycles >> 32),  4);
+  u8Length = TelemetryPack(au8Payload, u8Length, pstRegion->u32MaxCycles,                 4);
+  while( (*pcName != '\0') && (u8Length < TELEMETRY_PAYLOAD_MAX) )
+  {
+    au8Payload[u8Length++] = (u8)*pcName++;
+  }
+
+  if((u8)(u8Length + TELEMETRY_OVERHEAD) > UartFree())
+  {
+    return;
+  }
+
+  TelemetrySend(TELEMETRY_TYPE_REGION, au8Payload, u8Length);
+  if(++RegionProfile_u8DumpRegion >= REGION_PROFILE_REGIONS)
+  {
+    RegionProfile_u8DumpRegion = 0xFF;
+  }
+
+} /* end RegionProfileDumpRegion() */
+#endif /* REGION_PROFILE */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,88 @@
+/*!*********************************************************************************************************************
+@file region_profile.h
+@brief Header file for the named-region cycle profiler
+
+**********************************************************************************************************************/
+
+#ifndef __REGION_PROFILE_H
+#define __REGION_PROFILE_H
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/* Profiled regions: index into G_astRegionProfile[] and RegionProfile_apcNames[] */
+#define REGION_PROFILE_SD_READ        (u8)0          /*!< @brief SD_ReadSector: CMD17, card latency and the 512-byte copy */
+#define REGION_PROFILE_SD_WRITE       (u8)1          /*!< @brief SD_WriteBlock: CMD24 and the data block */
+#define REGION_PROFILE_AUDIO_REFILL   (u8)2          /*!< @brief AudioRun's or AudioRefillWork's AudioFill(1), including calls with nothing to read */
+#define REGION_PROFILE_AUDIO_DECODE   (u8)3          /*!< @brief AudioDecode's AdpcmDecode calls, up to AUDIO_DECODE_CHUNK samples each */
+#define REGION_PROFILE_REGIONS        (u8)4
+
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*!
+@struct RegionProfileType
+@brief Measurements for one region.
+*/
+typedef struct
+{
+  u32 u32Calls;                                 /*!< @brief Times the region has run */
+  u64 u64TotalCycles;                           /*!< @brief Instruction cycles over all calls */
+  u32 u32MaxCycles;                             /*!< @brief Longest single call */
+} RegionProfileType;
+
+
+/**********************************************************************************************************************
+Macros
+**********************************************************************************************************************/
+#if REGION_PROFILE
+
+/*! @brief Starts timing region REGION_PROFILE_<NAME>, e.g. REGION_PROFILE_BEGIN(SD_READ).
+It declares variables, so it goes where a declaration may. */
+#define REGION_PROFILE_BEGIN(NAME)                        \
+u16 u16RegionProfileStart##NAME;                          \
+u32 u32RegionProfileStartUs##NAME = UsTimerNow();         \
+CYCLE_COUNT_READ(u16RegionProfileStart##NAME)
+
+/*! @brief Ends the region started with the same NAME in the same block */
+#define REGION_PROFILE_END(NAME)                          \
+RegionProfileRecord(REGION_PROFILE_##NAME, u16RegionProfileStart##NAME, u32RegionProfileStartUs##NAME)
+
+#else
+
+#define REGION_PROFILE_BEGIN(NAME)
+#define REGION_PROFILE_END(NAME)
+
+#endif /* REGION_PROFILE */
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+void RegionProfileReset(void);
+void RegionProfileDumpRequest(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+void RegionProfileRecord(u8 u8Region_, u16 u16StartCycles_, u32 u32StartUs_);
+void RegionProfileRun(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+#endif /* __REGION_PROFILE_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
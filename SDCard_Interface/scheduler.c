@@ -0,0 +1,269 @@
+/*!*********************************************************************************************************************
+@file scheduler.c                                                                
+@brief Static cooperative scheduler that replaces the single UserAppRun() call
+in the super loop.
+
+Tasks are listed at compile time in Scheduler_astTasks[] with a period, a 
+phase and a priority.  Once per system tick SchedulerRun() runs every task 
+that is due, highest priority first.  Nothing is allocated at run time and 
+there is no preemption: a task runs to completion and must return quickly.
+
+Each run is timed with the Timer5 cycle counter.  That wraps every 65536
+cycles, 4ms at 64MHz but 16ms at 16MHz, so UsTimerNow() times the run as well
+and anything the counter can't hold saturates.  The worst case of every 
+task is kept, so the sum from SchedulerWorstCaseLoopCycles() is a bound on
+the loop time if every task came due on the same tick.  A task that starts a
+whole period or more after its release has missed a deadline; the missed 
+releases are counted and skipped rather than run back to back.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_astSchedulerTaskStats[]
+
+CONSTANTS
+- NONE
+
+TYPES
+- SchedulerTaskType
+- SchedulerTaskStatsType
+
+PUBLIC FUNCTIONS
+- u32 SchedulerWorstCaseLoopCycles(void)
+
+PROTECTED FUNCTIONS
+- void SchedulerInitialize(void)
+- void SchedulerRun(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Task table.  Add new tasks here.
+***********************************************************************************************************************/
+static const SchedulerTaskType Scheduler_astTasks[] =
+{
+  /* pfnTask                  Period  Phase  Priority */
+  {  AudioRun,                1,      0,     0        },
+  {  TimerWheelRun,           1,      0,     1        },
+  {  UserAppRun,              1,      0,     2        },
+  {  ClockRun,                10,     5,     3        },
+  {  TelemetryRun,            250,    3,     4        },
+#if REGION_PROFILE
+  {  RegionProfileRun,        10,     7,     5        },
+#endif
+#if TRACE
+  {  TraceRun,                10,     2,     6        },
+#endif
+};
+
+#define SCHEDULER_TASKS           (u8)(sizeof(Scheduler_astTasks) / sizeof(SchedulerTaskType))
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Scheduler"
+***********************************************************************************************************************/
+/* New variables */
+SchedulerTaskStatsType G_astSchedulerTaskStats[SCHEDULER_TASKS];  /*!< @brief Per-task timing, same order as the task table */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Scheduler_<type>" and be declared as static.
+***********************************************************************************************************************/
+static u8 Scheduler_au8RunOrder[SCHEDULER_TASKS];         /*!< @brief Task table indices sorted by priority */
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u32 SchedulerWorstCaseLoopCycles(void)
+
+@brief Returns the sum of the worst-case run times of all tasks.
+
+This is the longest the super loop can take if every task comes due on the 
+same tick, based on what has been measured so far.
+
+Requires:
+- NONE
+
+Promises:
+- Returns the total in instruction cycles
+
+*/
+u32 SchedulerWorstCaseLoopCycles(void)
+{
+  u32 u32Total = 0;
+  
+  for(u8 i = 0; i < SCHEDULER_TASKS; i++)
+  {
+    u32Total += G_astSchedulerTaskStats[i].u16MaxCycles;
+  }
+  
+  return u32Total;
+  
+} /* end SchedulerWorstCaseLoopCycles() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void SchedulerInitialize(void)
+
+@brief
+Sorts the task table by priority and sets the first release of each task.
+
+Should only be called once in main init section, after the tasks' own
+initialization.
+
+Requires:
+- Systick is running
+
+Promises:
+- Scheduler_au8RunOrder lists the tasks highest priority first (table order
+  breaks ties)
+- Every task's first release is u16PhaseMs ticks from now
+- All statistics are cleared
+
+*/
+void SchedulerInitialize(void)
+{
+  u8 u8Index;
+  u8 j;
+  u32 u32Now = TimeBaseMs();
+  
+  /* Insertion sort: the table is short and this only runs once */
+  for(u8 i = 0; i < SCHEDULER_TASKS; i++)
+  {
+    j = i;
+    while( (j > 0) && 
+           (Scheduler_astTasks[Scheduler_au8RunOrder[j - 1]].u8Priority > Scheduler_astTasks[i].u8Priority) )
+    {
+      Scheduler_au8RunOrder[j] = Scheduler_au8RunOrder[j - 1];
+      j--;
+    }
+    Scheduler_au8RunOrder[j] = i;
+  }
+  
+  for(u8Index = 0; u8Index < SCHEDULER_TASKS; u8Index++)
+  {
+    G_astSchedulerTaskStats[u8Index].u32NextReleaseMs  = u32Now + Scheduler_astTasks[u8Index].u16PhaseMs;
+    G_astSchedulerTaskStats[u8Index].u32Runs           = 0;
+    G_astSchedulerTaskStats[u8Index].u16DeadlineMisses = 0;
+    G_astSchedulerTaskStats[u8Index].u16LastCycles     = 0;
+    G_astSchedulerTaskStats[u8Index].u16MaxCycles      = 0;
+  }
+  
+} /* end SchedulerInitialize() */
+
+  
+/*!----------------------------------------------------------------------------------------------------------------------
+@fn void SchedulerRun(void)
+
+@brief Runs every task that is due, highest priority first.  Called once per
+system loop in place of the individual application Run functions.
+
+Requires:
+- SchedulerInitialize has been called
+
+Promises:
+- Each due task is called once and timed; a run longer than 65535 cycles
+  at the operating point it started in is counted as SCHEDULER_RUN_CYCLES_MAX,
+  and one that changed the operating point is costed from its microseconds
+- Its next release is moved forward one period, or past now if it was late
+  by a full period or more, counting each skipped release as a deadline miss
+
+*/
+void SchedulerRun(void)
+{
+  const SchedulerTaskType* pstTask;
+  SchedulerTaskStatsType* pstStats;
+  u32 u32Now;
+  u32 u32StartUs;
+  u32 u32Cycles;
+  ClockOpPointType eOpPoint;
+  u8 u8CyclesPerUs;
+  u16 u16Start;
+  u16 u16End;
+  u8 u8Task;
+  
+  for(u8 i = 0; i < SCHEDULER_TASKS; i++)
+  {
+    u8Task   = Scheduler_au8RunOrder[i];
+    pstTask  = &Scheduler_astTasks[u8Task];
+    pstStats = &G_astSchedulerTaskStats[u8Task];
+    
+    /* Signed difference so the 49 day roll-over of the tick is harmless */
+    u32Now = TimeBaseMs();
+    if( (s32)(u32Now - pstStats->u32NextReleaseMs) < 0 )
+    {
+      continue;
+    }
+    
+    /* Run and time the task */
+    eOpPoint = ClockOperatingPoint();
+    u8CyclesPerUs = ClockCyclesPerUs();
+    u32StartUs = UsTimerNow();
+    CYCLE_COUNT_READ(u16Start);
+    pstTask->pfnTask();
+    CYCLE_COUNT_READ(u16End);
+    
+    pstStats->u32Runs++;
+    pstStats->u16LastCycles = u16End - u16Start;
+    
+    /* The same run from the microsecond clock; the extra microsecond covers
+    the two clocks not being read together */
+    u32Cycles = (UsTimerNow() - u32StartUs + 1) * u8CyclesPerUs;
+    if(u32Cycles > SCHEDULER_RUN_CYCLES_MAX)
+    {
+      /* The cycle counter has wrapped at least once */
+      pstStats->u16LastCycles = SCHEDULER_RUN_CYCLES_MAX;
+    }
+    else if(eOpPoint != ClockOperatingPoint())
+    {
+      /* The cycle counter ran at two rates */
+      pstStats->u16LastCycles = (u16)u32Cycles;
+    }
+    if(pstStats->u16LastCycles > pstStats->u16MaxCycles)
+    {
+      pstStats->u16MaxCycles = pstStats->u16LastCycles;
+    }
+    
+    /* Schedule the next release and account for any that were missed */
+    pstStats->u32NextReleaseMs += pstTask->u16PeriodMs;
+    while( (s32)(u32Now - pstStats->u32NextReleaseMs) >= 0 )
+    {
+      pstStats->u32NextReleaseMs += pstTask->u16PeriodMs;
+      pstStats->u16DeadlineMisses++;
+    }
+  }
+  
+} /* end SchedulerRun() */
+
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,72 @@
+/*!*********************************************************************************************************************
+@file scheduler.h                                                                
+@brief Header file for the cooperative task scheduler
+
+**********************************************************************************************************************/
+
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! 
+@struct SchedulerTaskType
+@brief One entry of the constant task table in scheduler.c.
+*/
+typedef struct
+{
+  fnCode_type pfnTask;            /*!< @brief Task function; must return quickly (cooperative) */
+  u16 u16PeriodMs;                /*!< @brief Task is released every u16PeriodMs system ticks (minimum 1) */
+  u16 u16PhaseMs;                 /*!< @brief First release is at tick u16PhaseMs, to spread out tasks with equal periods */
+  u8  u8Priority;                 /*!< @brief 0 is the highest; due tasks run in priority order within a tick */
+} SchedulerTaskType;
+
+/*! 
+@struct SchedulerTaskStatsType
+@brief Run-time measurements kept for each task.
+*/
+typedef struct
+{
+  u32 u32NextReleaseMs;           /*!< @brief System time the task is next due */
+  u32 u32Runs;                    /*!< @brief Number of times the task has run */
+  u16 u16DeadlineMisses;          /*!< @brief Releases that were skipped because the task started a full period late */
+  u16 u16LastCycles;              /*!< @brief Instruction cycles used by the most recent run */
+  u16 u16MaxCycles;               /*!< @brief Worst-case instruction cycles of any run (saturates at 0xFFFF) */
+} SchedulerTaskStatsType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+u32 SchedulerWorstCaseLoopCycles(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void SchedulerInitialize(void);
+void SchedulerRun(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define SCHEDULER_RUN_CYCLES_MAX  (u16)0xFFFF          /*!< @brief Run times of 65535 cycles (4ms at 64MHz, 16ms at 16MHz) or more saturate here */
+
+
+#endif /* __SCHEDULER_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -16,6 +16,11 @@ All Global variable names shall start with "G_<type>SD"
 volatile u8 G_u8SDResp8 = 0xFF;
 volatile u8 G_u8SDCurrentRxBuffer = 0;
 
+u16 G_u16SDInitTimeMs = 0;                        /* Time SD_Init took */
+u16 G_u16SDCommandCycles = 0;                     /* Instruction cycles for the last address command */
+u32 G_u32SDCrcErrors = 0;                          /* Sectors rejected by the CRC16 check */
+volatile u16 G_u16SDReadMaxUs = 0;                 /* Longest SD_ReadSector since a reader last cleared it (telemetry.c) */
+
 u8 G_au8SDResp40[5] = {0xFF,0xFF,0xFF,0xFF,0xFF};
 u8 G_au8SDWriteBuffer[512];
 u8 G_au8SDReadBuffer0[512];
@@ -33,6 +38,22 @@ extern volatile u32 G_u32SystemFlags;                     /*!< @brief From main.
 Global variable definitions with scope limited to this local application.
 Variable names shall start with "SD_" and be declared as static.
 ***********************************************************************************************************************/
+/* Complete frames for every command that is always sent with the same argument */
+static const u8 SD_au8FrameCmd0[SD_FRAME_SIZE]   = SD_FRAME(0,  0x00, 0x00, 0x00, 0x00, SD_CMD0_CRC);
+static const u8 SD_au8FrameCmd8[SD_FRAME_SIZE]   = SD_FRAME(8,  0x00, 0x00, 0x01, 0xAA, SD_CMD8_CRC);
+static const u8 SD_au8FrameCmd55[SD_FRAME_SIZE]  = SD_FRAME(55, 0x00, 0x00, 0x00, 0x00, SD_CMD55_CRC);
+static const u8 SD_au8FrameAcmd41[SD_FRAME_SIZE] = SD_FRAME(41, 0x40, 0x00, 0x00, 0x00, SD_ACMD41_CRC);
+static const u8 SD_au8FrameCmd59[SD_FRAME_SIZE]  = SD_FRAME(59, 0x00, 0x00, 0x00, 0x00, SD_CMD59_CRC);
+
+/* 80 clocks with MOSI high to put the card in SPI mode */
+static const u8 SD_au8InitClocks[10] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+/* Set for the whole of each block transfer so deferred work in SW_ISR can tell
+ * it has interrupted one and must not touch the card */
+static volatile bool SD_bBusy = false;
+
+static bool SD_WriteSector(u32 u32Sector_);
+static bool SD_ReadSectorData(u32 u32Sector_, u8* pu8Dest_);
 
 
 //REQUIRES: SPI interface initialized using SPI_Init.
@@ -43,22 +64,17 @@ Variable names shall start with "SD_" and be declared as static.
 //          4a.Send CMD55 with argument 0x00000000 until response ix 0x00
 //          4b.Send Send CMD41 with argument 0x40000000, if response isn't 0x00
 //             go back to step 4a.
+//          5. Send CMD59 with argument 0x00000000 until response is 0x00
+//          Saves the time taken in G_u16SDInitTimeMs.
 void SD_Init(void)
 {
+    u32 u32StartTime = TimeBaseMs();
+    
     //Step 1:
     //Set Chip Select high, and write 0xFF for at least 74 cycles.
     SD_SET_CS_HIGH();
     
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
-    SPI_Write(0xFF);
+    SPI_WriteBlock(SD_au8InitClocks, sizeof(SD_au8InitClocks));
     
     SD_SET_CS_LOW();
 
@@ -67,7 +83,7 @@ void SD_Init(void)
     //Expect 8-bit response 0x01.
     //On any other response, retry CMD0.
     do {
-        SD_SendCommand(0, 0x00, 0x00, 0x00, 0x00);
+        SD_SendFrame(SD_au8FrameCmd0);
         SD_Read8bitResponse();
         asm("NOP");
     } while (SD_Check8bitResponse(0x01) == false);
@@ -77,7 +93,7 @@ void SD_Init(void)
     //Expect 40-bit response 0x01000001AA.
     //On any other response, retry CMD8.
     do {
-        SD_SendCommand(8, 0x00, 0x00, 0x01, 0xAA);
+        SD_SendFrame(SD_au8FrameCmd8);
         SD_Read40bitResponse();
         asm("NOP");
     } while (SD_Check40bitResponse(0x01, 0x00, 0x00, 0x01, 0xAA) == false);
@@ -90,7 +106,7 @@ void SD_Init(void)
     {
       do 
       {
-          SD_SendCommand(55, 0x00, 0x00, 0x00, 0x00);
+          SD_SendFrame(SD_au8FrameCmd55);
           SD_Read8bitResponse();
           asm("NOP");
       } while (SD_Check8bitResponse(0x01) == false);
@@ -100,48 +116,55 @@ void SD_Init(void)
       //Send CMD41 with argument 0x40000000
       //Expect 8-bit response 0x00
       //On any other response, go back to CMD55.
-      SD_SendCommand(41, 0x40, 0x00, 0x00, 0x00);
+      SD_SendFrame(SD_au8FrameAcmd41);
       SD_Read8bitResponse();
       asm("NOP");
     } while (SD_Check8bitResponse(0x00) == false);
+    
+    //Step 5:
+    //Send CMD59 with argument 0x00000000 to make sure command CRC checking is
+    //off, so the address commands on the read/write path can use a dummy CRC.
+    do {
+        SD_SendFrame(SD_au8FrameCmd59);
+        SD_Read8bitResponse();
+    } while (SD_Check8bitResponse(0x00) == false);
+    
+    G_u16SDInitTimeMs = (u16)(TimeBaseMs() - u32StartTime);
 }
 
 //REQUIRES: SPI interface initialized using SPI_Init.
-//          Argument u8CMD6bit is the command code from 0 to 64.
-//          Arguments u8Arg3_, u8Arg2_, u8Arg1_ and u8Arg0_ are the four bytes of the
-//          specific command's argument.
-//PROMISES: Sends a 48-bit command to the SD card over SPI.
-//          Calculates and sends the 7-bit checksum for the command.
-void SD_SendCommand(u8 u8CMD6bit_, u8 u8Arg3_, u8 u8Arg2_, u8 u8Arg1_, u8 u8Arg0_)
+//          pu8Frame_ points to a complete 6-byte command frame, CRC included.
+//PROMISES: Sends the frame to the SD card with one SPI_WriteBlock call.
+void SD_SendFrame(const u8* pu8Frame_)
 {
-    u8 u8ByteToSend = 0xFF;
-    u8 u8Checksum = 0x00;
-    
-    //First byte is 01XXXXXX, where X are the 6 command bits.
-    u8ByteToSend = (u8CMD6bit_ & 0x3F) | 0x40;
-    SPI_Write(u8ByteToSend);
-    UPDATE_CRC(u8Checksum, u8ByteToSend);
-     
-    //Next 4 bytes are the 32 argument bits.
-    u8ByteToSend = u8Arg3_;
-    SPI_Write(u8ByteToSend);
-    UPDATE_CRC(u8Checksum, u8ByteToSend);
-    
-    u8ByteToSend = u8Arg2_;
-    SPI_Write(u8ByteToSend);
-    UPDATE_CRC(u8Checksum, u8ByteToSend);
-    
-    u8ByteToSend = u8Arg1_;
-    SPI_Write(u8ByteToSend);
-    UPDATE_CRC(u8Checksum, u8ByteToSend);
-    
-    u8ByteToSend = u8Arg0_;
-    SPI_Write(u8ByteToSend);
-    UPDATE_CRC(u8Checksum, u8ByteToSend);
-    
-    //Last byte is XXXXXXX1, where X are the 7 Cyclic Redundancy Check bits.
-    u8ByteToSend = (u8)(u8Checksum << 1) | 0x01;
-    SPI_Write(u8ByteToSend);
+    SPI_WriteBlock(pu8Frame_, SD_FRAME_SIZE);
+}
+
+//REQUIRES: SPI interface initialized using SPI_Init.
+//          SD card command CRC checking is off (CMD59 in SD_Init).
+//          u8FrameStart_ is the precomputed first frame byte, e.g. SD_CMD17_START.
+//PROMISES: Sends the command with u32Address_ as its argument and a dummy CRC
+//          with one SPI_WriteBlock call.  Saves the instruction cycles taken in 
+//          G_u16SDCommandCycles.  Traces the command.
+void SD_SendAddressCommand(u8 u8FrameStart_, u32 u32Address_)
+{
+    u8 au8Frame[SD_FRAME_SIZE];
+    u16 u16Start;
+    u16 u16End;
+    
+    TRACE_RECORD(TRACE_EVENT_SD_COMMAND, u8FrameStart_ & 0x3F, (u16)u32Address_);
+    CYCLE_COUNT_READ(u16Start);
+    
+    au8Frame[0] = u8FrameStart_;
+    au8Frame[1] = (u8)(u32Address_ >> 24);
+    au8Frame[2] = (u8)(u32Address_ >> 16);
+    au8Frame[3] = (u8)(u32Address_ >> 8);
+    au8Frame[4] = (u8)u32Address_;
+    au8Frame[5] = SD_DUMMY_CRC;
+    SPI_WriteBlock(au8Frame, SD_FRAME_SIZE);
+    
+    CYCLE_COUNT_READ(u16End);
+    G_u16SDCommandCycles = u16End - u16Start;
 }
 
 //REQUIRES: SPI interface initialized using SPI_Init.
@@ -233,11 +256,36 @@ bool SD_Check40bitResponse(u8 u8Byte4_, u8 u8Byte3_, u8 u8Byte2_, u8 u8Byte1_, u
 //          Global 512-byte array G_au8SDWriteBuffer contains the data to write. 
 //PROMISES: Writes the 512 bytes stored in G_au8SDWriteBuffer to the SD card
 //          at the address given by u8Addr3-0_.
+//          Any cached copy of the sector is dropped so the cache can't go stale.
 //          Returns true if the write was successful, false otherwise.
 bool SD_WriteBlock(u8 u8Addr3_, u8 u8Addr2_, u8 u8Addr1_, u8 u8Addr0_)
+{
+    bool bResult;
+    u32 u32Sector = ((u32)u8Addr3_ << 24) | ((u32)u8Addr2_ << 16) | 
+                    ((u16)u8Addr1_ << 8)  | u8Addr0_;
+    
+    REGION_PROFILE_BEGIN(SD_WRITE);
+    
+#if SD_CACHE
+    SDCache_Invalidate(u32Sector);
+#endif
+    
+    SD_bBusy = true;
+    bResult = SD_WriteSector(u32Sector);
+    SD_bBusy = false;
+    TRACE_RECORD(TRACE_EVENT_SD_DONE, 24, bResult);
+    
+    REGION_PROFILE_END(SD_WRITE);
+    return bResult;
+}
+
+//REQUIRES: Called only by SD_WriteBlock, with SD_bBusy set.
+//PROMISES: Writes G_au8SDWriteBuffer to sector u32Sector_.
+//          Returns true if the write was successful, false otherwise.
+static bool SD_WriteSector(u32 u32Sector_)
 {
     //Send the block write command to the SD card
-    SD_SendCommand(24, u8Addr3_, u8Addr2_, u8Addr1_, u8Addr0_);
+    SD_SendAddressCommand(SD_CMD24_START, u32Sector_);
     
     //If the response is anything but 0x00, we cannot write.
     SD_Read8bitResponse();
@@ -254,10 +302,7 @@ bool SD_WriteBlock(u8 u8Addr3_, u8 u8Addr2_, u8 u8Addr1_, u8 u8Addr0_)
     SPI_Write(0xFE);
     
     //Write the contents of the block write buffer.
-    for(u16 i = 0; i < 512; i++)
-    {
-        SPI_Write(G_au8SDWriteBuffer[i]);
-    }
+    SPI_WriteBlock(G_au8SDWriteBuffer, 512);
     
     //Read the Data Response byte
     SD_Read8bitResponse();
@@ -274,20 +319,99 @@ bool SD_WriteBlock(u8 u8Addr3_, u8 u8Addr2_, u8 u8Addr1_, u8 u8Addr0_)
 
 //REQUIRES: SPI interface initialized using SPI_Init.
 //          SD Card initialized using SD_Init.
-//          Global 512-byte array G_au8SDWriteBuffer contains the data to write. 
 //          G_u8SDCurrentRxBuffer holds the index of the current buffer (so the other buffer will be updated with this read)
 //PROMISES: Reads the 512 bytes stored in the SD card block given by u8Addr3_-0
 //          and saves them to the global array G_au8SDReadBuffer0 or G_au8SDReadBuffer1.
 //          Returns true if the read was successful, false otherwise.
-//          Does NOT verify the checksum of the read data.
+//          This is the audio streaming path and never goes through the sector cache.
 bool SD_ReadBlock(u8 u8Addr3_, u8 u8Addr2_, u8 u8Addr1_, u8 u8Addr0_)
 {
-    u8 u8ReadMessage = 0xFF;
+    u32 u32Sector;
     u8* pu8RxBuffer;
     
+    u32Sector = ((u32)u8Addr3_ << 24) | ((u32)u8Addr2_ << 16) | 
+                ((u16)u8Addr1_ << 8)  | u8Addr0_;
+    
+    /* Set the destination to the correct buffer */
+    if(G_u8SDCurrentRxBuffer == 0)
+    {
+      pu8RxBuffer = &G_au8SDReadBuffer0[0];
+    }
+    else
+    {
+      pu8RxBuffer = &G_au8SDReadBuffer1[0];
+    }
+    
+    if(SD_ReadSector(u32Sector, pu8RxBuffer) == false)
+    {
+      return false;
+    }
+    
+    /* Only flip buffers once the new data is in place */
+    G_u8SDCurrentRxBuffer ^= 1;
+    
+    //Read was a success, so return true.
+    return true;
+}
+
+//REQUIRES: SPI interface initialized using SPI_Init.
+//          SD Card initialized using SD_Init.
+//          pu8Dest_ points to at least 512 bytes of writable memory.
+//PROMISES: Reads the 512 bytes stored in SD card sector u32Sector_ into pu8Dest_.
+//          With SD_CRC16_VERIFY set, checks the block's CRC16 and counts a 
+//          mismatch in G_u32SDCrcErrors.
+//          Returns true if the read was successful (and the CRC matched), false otherwise.
+//          SD_IsBusy() reports true for the duration.
+//          Raises G_u16SDReadMaxUs (saturating) if this read took longer.
+bool SD_ReadSector(u32 u32Sector_, u8* pu8Dest_)
+{
+    bool bResult;
+    u32 u32StartUs;
+    u32 u32ElapsedUs;
+    REGION_PROFILE_BEGIN(SD_READ);
+    
+    u32StartUs = UsTimerNow();
+    SD_bBusy = true;
+    bResult = SD_ReadSectorData(u32Sector_, pu8Dest_);
+    SD_bBusy = false;
+    TRACE_RECORD(TRACE_EVENT_SD_DONE, 17, bResult);
+    
+    u32ElapsedUs = UsTimerNow() - u32StartUs;
+    if(u32ElapsedUs > 0xFFFF)
+    {
+        u32ElapsedUs = 0xFFFF;
+    }
+    if(u32ElapsedUs > G_u16SDReadMaxUs)
+    {
+        G_u16SDReadMaxUs = (u16)u32ElapsedUs;
+    }
+    
+    REGION_PROFILE_END(SD_READ);
+    return bResult;
+}
+
+//REQUIRES: Nothing.
+//PROMISES: Returns true while a block read or write is in progress.  Only 
+//          meaningful to code that can interrupt the main loop, i.e. SW_ISR
+//          deferred work, which must leave the card alone while it is true.
+bool SD_IsBusy(void)
+{
+    return SD_bBusy;
+}
+
+//REQUIRES: Called only by SD_ReadSector, with SD_bBusy set.
+//PROMISES: Does the read for SD_ReadSector.
+static bool SD_ReadSectorData(u32 u32Sector_, u8* pu8Dest_)
+{
+    u8 u8ReadMessage = 0xFF;
+    u16 u16ReceivedCrc;
+#if SD_CRC16_VERIFY
+    u16 u16Crc;
+#endif
+    
     //Send the block read command (CMD17) to the SD card.
     //The 32 bit argument is which 512-byte sector to read.
-    SD_SendCommand(17, u8Addr3_, u8Addr2_, u8Addr1_, u8Addr0_);
+    SD_SendAddressCommand(SD_CMD17_START, u32Sector_);
     
     //Wait for the SD card to respond to the command.
     SD_Read8bitResponse();
@@ -309,31 +433,44 @@ bool SD_ReadBlock(u8 u8Addr3_, u8 u8Addr2_, u8 u8Addr1_, u8 u8Addr0_)
       return false;
     }
     
-    /* Set the destination to the correct buffer */
-    if(G_u8SDCurrentRxBuffer == 0)
-    {
-      pu8RxBuffer = &G_au8SDReadBuffer0[0];
-      G_u8SDCurrentRxBuffer = 1;
-    }
-    else
-    {
-      pu8RxBuffer = &G_au8SDReadBuffer1[0];
-      G_u8SDCurrentRxBuffer = 0;
-    }
-    
-    // Read all 512 bytes into the current read buffer.
+    // Read all 512 bytes into the destination buffer. Each pass starts the
+    // next byte before storing and checking the current one, so that work
+    // is done while the SPI peripheral is shifting. The last pass starts
+    // the first CRC byte.
+#if SD_CRC16_VERIFY
+    CRC16_START(u16Crc);
+#endif
+    SPI_START_READ();
     for(u16 i = 0; i < 512; i++)
     {
-     *(pu8RxBuffer + i) = SPI_Read();
+      SPI_WAIT_READ();
+      u8ReadMessage = SPI_READ_RESULT();
+      SPI_START_READ();
+      
+      *(pu8Dest_ + i) = u8ReadMessage;
+#if SD_CRC16_VERIFY
+      CRC16_UPDATE(u16Crc, u8ReadMessage);
+#endif
     }
     
-    //The next two bytes are the block's 16-bit CRC. We won't worry about it but it needs to be read.
-    SPI_Read();
-    SPI_Read();
+    //The next two bytes are the block's 16-bit CRC, high byte first.
+    SPI_WAIT_READ();
+    u16ReceivedCrc  = (u16)SPI_READ_RESULT() << 8;
+    u16ReceivedCrc |= SPI_Read();
         
     // Final read to close the SD card read session.
     SPI_Read();
     
+#if SD_CRC16_VERIFY
+    if(CRC16_RESULT(u16Crc) != u16ReceivedCrc)
+    {
+      G_u32SDCrcErrors++;
+      return false;
+    }
+#else
+    (void)u16ReceivedCrc;
+#endif
+    
     //Read was a success, so return true.
     return true;
 }
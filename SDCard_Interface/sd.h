@@ -4,16 +4,43 @@
 #include "configuration.h"
 
 
+/* ------------------------------- Constants -------------------------------- */
+
+/* Last frame byte (CRC7 << 1 | end bit) of the commands that are always sent
+ * with the same argument.  These never change, so they are worked out once
+ * here and built into the constant frame tables in sd.c. */
+#define SD_CMD0_CRC               (u8)0x95   /* CMD0,  argument 0x00000000 */
+#define SD_CMD8_CRC               (u8)0x87   /* CMD8,  argument 0x000001AA */
+#define SD_CMD55_CRC              (u8)0x65   /* CMD55, argument 0x00000000 */
+#define SD_ACMD41_CRC             (u8)0x77   /* ACMD41, argument 0x40000000 */
+#define SD_CMD59_CRC              (u8)0x91   /* CMD59, argument 0x00000000 (CRC off) */
+
+/* Once CMD59 has turned CRC checking off, only the end bit of the last byte matters */
+#define SD_DUMMY_CRC              (u8)0xFF
+
+/* First frame byte (01 + 6 command bits) of the commands that take a sector address */
+#define SD_CMD17_START            (u8)(0x40 | 17)   /* READ_SINGLE_BLOCK */
+#define SD_CMD24_START            (u8)(0x40 | 24)   /* WRITE_BLOCK */
+
+#define SD_FRAME_SIZE             (u8)6
+
+/* Initializer for a complete constant command frame */
+#define SD_FRAME(CMD, ARG3, ARG2, ARG1, ARG0, CRC_BYTE) \
+  { (u8)(0x40 | (CMD)), (ARG3), (ARG2), (ARG1), (ARG0), (CRC_BYTE) }
+
 
 /* -------------------------- Function Prototypes --------------------------- */
 void SD_Init(void);
-void SD_SendCommand(u8 u8CMD6bit_, u8 u8Arg3_, u8 u8Arg2_, u8 u8Arg1_, u8 ARG0);
+void SD_SendFrame(const u8* pu8Frame_);
+void SD_SendAddressCommand(u8 u8FrameStart_, u32 u32Address_);
 void SD_Read8bitResponse(void);
 bool SD_Check8bitResponse(u8 Byte);
 void SD_Read40bitResponse(void);
 bool SD_Check40bitResponse(u8 Byte4, u8 Byte3, u8 Byte2, u8 Byte1, u8 Byte0);
 bool SD_WriteBlock(u8 ADDR3, u8 ADDR2, u8 ADDR1, u8 ADDR0);
 bool SD_ReadBlock(u8 ADDR3, u8 ADDR2, u8 ADDR1, u8 ADDR0);
+bool SD_ReadSector(u32 u32Sector_, u8* pu8Dest_);
+bool SD_IsBusy(void);
     
 
 /* ------------------ #define based Function Declarations ------------------- */
@@ -0,0 +1,192 @@
+/*!**********************************************************************************************************************
+@file sd_cache.c
+@brief Small set-associative cache for SD card metadata sectors.
+
+Library index and FAT sectors get read again and again while switching
+songs.  Those reads go through SDCache_Read() so a repeat lookup costs a
+few compares instead of a CMD17 and 512 SPI transfers.  Sectors are placed
+in set (sector & (SDCACHE_SETS - 1)) and the least recently used unpinned
+way is replaced on a miss.
+
+Audio streaming keeps using SD_ReadBlock() and the ping-pong buffers so
+it never pushes metadata out of the cache.
+
+The lines take 2KB of RAM, so none of this is built unless SD_CACHE is 1.
+
+ Author: Ahnaf Naheen
+***********************************************************************************************************************/
+
+#include "configuration.h"
+
+#if SD_CACHE
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>SDCache"
+***********************************************************************************************************************/
+/* New variables */
+u32 G_u32SDCacheHits   = 0;                       /*!< @brief Reads served from the cache */
+u32 G_u32SDCacheMisses = 0;                       /*!< @brief Reads that went to the card */
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "SDCache_" and be declared as static.
+***********************************************************************************************************************/
+static SDCacheLineType SDCache_astLines[SDCACHE_LINES];
+static u8 SDCache_au8Data[SDCACHE_LINES][512];
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Private functions */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+//REQUIRES: Nothing.
+//PROMISES: Returns the index of the line holding u32Sector_, or SDCACHE_LINES
+//          if the sector is not cached.
+static u8 SDCache_Find(u32 u32Sector_)
+{
+    u8 u8Line = (u8)(u32Sector_ & (SDCACHE_SETS - 1)) * SDCACHE_WAYS;
+
+    for(u8 i = 0; i < SDCACHE_WAYS; i++, u8Line++)
+    {
+      if(SDCache_astLines[u8Line].u32Sector == u32Sector_)
+      {
+        return u8Line;
+      }
+    }
+
+    return SDCACHE_LINES;
+}
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Public functions */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+//REQUIRES: Nothing.
+//PROMISES: Marks every line empty and unpinned and clears the hit/miss counters.
+void SDCache_Init(void)
+{
+    for(u8 i = 0; i < SDCACHE_LINES; i++)
+    {
+      SDCache_astLines[i].u32Sector  = SDCACHE_INVALID_SECTOR;
+      SDCache_astLines[i].u8Age      = 0;
+      SDCache_astLines[i].u8PinCount = 0;
+    }
+
+    G_u32SDCacheHits   = 0;
+    G_u32SDCacheMisses = 0;
+}
+
+//REQUIRES: SD Card initialized using SD_Init.
+//          u8Flags_ is 0 or SDCACHE_PIN.
+//PROMISES: Returns a pointer to the 512 bytes of sector u32Sector_, reading the
+//          card only if the sector is not already cached.
+//          With SDCACHE_PIN the line stays resident until a matching SDCache_Unpin.
+//          Returns NULL if the card read fails or every way in the set is pinned.
+//          The data is only valid until the next SDCache_Read of an unpinned sector.
+u8* SDCache_Read(u32 u32Sector_, u8 u8Flags_)
+{
+    u8 u8Line;
+    u8 u8OldestAge;
+    u8 u8Candidate;
+
+    /* Age every line; the one used below is reset.  Saturating rather than
+     * wrapping keeps a line idle for 256+ accesses the oldest. */
+    for(u8 i = 0; i < SDCACHE_LINES; i++)
+    {
+      if(SDCache_astLines[i].u8Age != 0xFF)
+      {
+        SDCache_astLines[i].u8Age++;
+      }
+    }
+
+    u8Line = SDCache_Find(u32Sector_);
+
+    if(u8Line != SDCACHE_LINES)
+    {
+      G_u32SDCacheHits++;
+    }
+    else
+    {
+      G_u32SDCacheMisses++;
+
+      /* Pick an empty way, otherwise the unpinned way that was used longest ago */
+      u8Candidate = (u8)(u32Sector_ & (SDCACHE_SETS - 1)) * SDCACHE_WAYS;
+      u8OldestAge = 0;
+
+      for(u8 i = 0; i < SDCACHE_WAYS; i++, u8Candidate++)
+      {
+        if(SDCache_astLines[u8Candidate].u8PinCount != 0)
+        {
+          continue;
+        }
+
+        if(SDCache_astLines[u8Candidate].u32Sector == SDCACHE_INVALID_SECTOR)
+        {
+          u8Line = u8Candidate;
+          break;
+        }
+
+        if(SDCache_astLines[u8Candidate].u8Age >= u8OldestAge)
+        {
+          u8OldestAge = SDCache_astLines[u8Candidate].u8Age;
+          u8Line = u8Candidate;
+        }
+      }
+
+      if(u8Line == SDCACHE_LINES)
+      {
+        return NULL;
+      }
+
+      /* The line is invalid until the read completes in case it fails */
+      SDCache_astLines[u8Line].u32Sector = SDCACHE_INVALID_SECTOR;
+      if(SD_ReadSector(u32Sector_, &SDCache_au8Data[u8Line][0]) == false)
+      {
+        return NULL;
+      }
+      SDCache_astLines[u8Line].u32Sector = u32Sector_;
+    }
+
+    SDCache_astLines[u8Line].u8Age = 0;
+    if(u8Flags_ & SDCACHE_PIN)
+    {
+      SDCache_astLines[u8Line].u8PinCount++;
+    }
+
+    return &SDCache_au8Data[u8Line][0];
+}
+
+//REQUIRES: u32Sector_ was previously read with SDCACHE_PIN.
+//PROMISES: Drops one pin from the sector so it can be evicted again once
+//          all pins are released.  Does nothing if the sector is not cached.
+void SDCache_Unpin(u32 u32Sector_)
+{
+    u8 u8Line = SDCache_Find(u32Sector_);
+
+    if( (u8Line != SDCACHE_LINES) && (SDCache_astLines[u8Line].u8PinCount != 0) )
+    {
+      SDCache_astLines[u8Line].u8PinCount--;
+    }
+}
+
+//REQUIRES: Nothing.
+//PROMISES: Discards any cached copy of u32Sector_, including pinned copies.
+//          The next SDCache_Read of the sector goes to the card.
+void SDCache_Invalidate(u32 u32Sector_)
+{
+    u8 u8Line = SDCache_Find(u32Sector_);
+
+    if(u8Line != SDCACHE_LINES)
+    {
+      SDCache_astLines[u8Line].u32Sector  = SDCACHE_INVALID_SECTOR;
+      SDCache_astLines[u8Line].u8PinCount = 0;
+    }
+}
+
+#endif /* SD_CACHE */
@@ -0,0 +1,37 @@
+#ifndef SD_CACHE_H
+#define	SD_CACHE_H
+
+/* ------------------------------- Constants -------------------------------- */
+
+/* Cache geometry.  SDCACHE_SETS must be a power of two; each line costs 512 bytes of RAM,
+ * so the cache is only built with SD_CACHE. */
+#define SDCACHE_SETS              (u8)2
+#define SDCACHE_WAYS              (u8)2
+#define SDCACHE_LINES             (u8)(SDCACHE_SETS * SDCACHE_WAYS)
+
+#define SDCACHE_INVALID_SECTOR    (u32)0xFFFFFFFF
+
+/* u8Flags_ for SDCache_Read */
+#define SDCACHE_PIN               (u8)0x01   /* Keep the sector resident until SDCache_Unpin */
+
+
+/* --------------------------------- Types ---------------------------------- */
+
+typedef struct
+{
+  u32 u32Sector;              /* Sector held by this line or SDCACHE_INVALID_SECTOR */
+  u8  u8Age;                  /* Accesses to the cache since this line was used, saturating at 255 */
+  u8  u8PinCount;             /* Line cannot be evicted while non-zero */
+} SDCacheLineType;
+
+
+/* -------------------------- Function Prototypes --------------------------- */
+void SDCache_Init(void);
+u8*  SDCache_Read(u32 u32Sector_, u8 u8Flags_);
+void SDCache_Unpin(u32 u32Sector_);
+void SDCache_Invalidate(u32 u32Sector_);
+
+
+/* -------------------------------------------------------------------------- */
+
+#endif	/* SD_CACHE_H */
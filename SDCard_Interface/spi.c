@@ -60,9 +60,7 @@ void SPI_Init(void)
 void SPI_Write(u8 u8DataByte_)
 {
   /* Queue the byte and wait until sent */
-  SPI1TXB = u8DataByte_;
-  __nop();
-  __nop();
+  HAL_SPI_TX(u8DataByte_);
   while(SPI1CON2bits.BUSY == 1);
   
   /* Read the received dummy byte to clear the buffer */
@@ -75,10 +73,29 @@ void SPI_Write(u8 u8DataByte_)
 u8 SPI_Read(void)
 {
   /* Initiate transfer with dummy write then wait for Rx byte. */
-  SPI1TXB = 0xFF; 
-  __nop();
-  __nop();
+  HAL_SPI_TX(0xFF);
    while(SPI1CON2bits.BUSY == 1);
   
   return SPI1RXB;
 }
+
+// REQUIRES: SPI interface initialized using SPI_Init.
+//           pu8Data_ points to u16Length_ bytes to send.
+// PROMISES: Transmits all u16Length_ bytes on the MOSI line back to back,
+//           discarding the received bytes.  Same as calling SPI_Write for each
+//           byte but without the call overhead between bytes.
+void SPI_WriteBlock(const u8* pu8Data_, u16 u16Length_)
+{
+  u8 u8Dummy;
+  
+  while(u16Length_--)
+  {
+    HAL_SPI_TX(*pu8Data_++);
+    while(SPI1CON2bits.BUSY == 1);
+    
+    /* Read the received dummy byte to clear the buffer */
+    u8Dummy = SPI1RXB;
+  }
+  
+  (void)u8Dummy;
+}
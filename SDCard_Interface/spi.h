@@ -6,9 +6,23 @@
 void SPI_Init(void);
 void SPI_Write(u8 u8DataByte_);
 u8 SPI_Read(void);
+void SPI_WriteBlock(const u8* pu8Data_, u16 u16Length_);
 
 /* ------------------ #define based Function Declarations ------------------- */
 
+//REQUIRES: SPI interface initialized using SPI_Init.
+//          No other transfer in progress.
+//PROMISES: Starts clocking in one byte by transmitting 0xFF, but does not wait.
+//          Use with SPI_WAIT_READ/SPI_READ_RESULT to do other work while the byte shifts.
+#define SPI_START_READ()  HAL_SPI_TX(0xFF)
+
+//REQUIRES: A transfer was started with SPI_START_READ.
+//PROMISES: Waits until the byte has been clocked in.
+#define SPI_WAIT_READ()   while(SPI1CON2bits.BUSY == 1)
+
+//REQUIRES: SPI_WAIT_READ has returned.
+//PROMISES: Evaluates to the byte received on the MISO line.
+#define SPI_READ_RESULT() (SPI1RXB)
 
 /* -------------------------------------------------------------------------- */
 
@@ -0,0 +1,132 @@
+/*!*********************************************************************************************************************
+@file stack_guard.c
+@brief High-water mark of the hardware return stack.
+
+Each call and interrupt pushes a 21-bit return address onto the return
+stack, and with STVREN on the part resets when it overflows.
+Host/stack_depth.awk checks the compiler's call graph against
+STACK_GUARD_LEVELS at build time; this measures what the running firmware
+actually reaches, including call paths through function pointers and
+interrupts nesting that the call graph can only assume.
+
+StackGuardInitialize() paints every level above the current one with
+STACK_GUARD_PAINT in TOSU, which no return address can hold: program memory
+ends at 0x1FFFF.  A level that has ever been used has lost the paint.
+STACK_GUARD_SAMPLE() in TMR1_ISR reads STKPTR and checks the one level
+above the mark so far, so it costs a few cycles per sample and the mark
+catches up one level per sample.  Levels are used bottom up, so the mark is
+the deepest the stack has been since start-up.
+
+Moving STKPTR to look at another level is only safe when nothing can push
+or pop meanwhile: at start-up before interrupts are enabled, and in the
+high priority ISR.  Nowhere else touches STKPTR.
+
+The host build has no return stack and always reports 0.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_u8StackGuardHighWater
+
+CONSTANTS
+- STACK_GUARD_LEVELS
+- STACK_GUARD_PAINT
+
+TYPES
+- NONE
+
+PUBLIC FUNCTIONS
+- u8 StackGuardHighWater(void)
+
+PROTECTED FUNCTIONS
+- void StackGuardInitialize(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>StackGuard"
+***********************************************************************************************************************/
+/* New variables */
+volatile u8 G_u8StackGuardHighWater;                      /*!< @brief Deepest return stack level seen, written by STACK_GUARD_SAMPLE */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "StackGuard_<type>" and be declared as static.
+***********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 StackGuardHighWater(void)
+
+@brief Returns the deepest return stack level used since start-up.
+
+Requires:
+- Any context
+
+Promises:
+- Returns 0 to STACK_GUARD_LEVELS; 0 if STACK_GUARD is off
+
+*/
+u8 StackGuardHighWater(void)
+{
+  return G_u8StackGuardHighWater;
+
+} /* end StackGuardHighWater() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void StackGuardInitialize(void)
+
+@brief Paints the unused return stack levels.
+
+Requires:
+- Called from main() before InterruptSetup(), while nothing can interrupt
+
+Promises:
+- Levels above this call's up to STACK_GUARD_LEVELS hold STACK_GUARD_PAINT in TOSU
+- G_u8StackGuardHighWater is the level of this call
+
+*/
+void StackGuardInitialize(void)
+{
+#if STACK_GUARD
+  u8 u8Level = STKPTR;
+
+  G_u8StackGuardHighWater = u8Level;
+  for(u8 i = (u8)(u8Level + 1); i <= STACK_GUARD_LEVELS; i++)
+  {
+    STKPTR = i;
+    TOSU = STACK_GUARD_PAINT;
+  }
+
+  STKPTR = u8Level;
+#endif
+
+} /* end StackGuardInitialize() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
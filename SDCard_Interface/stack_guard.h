@@ -0,0 +1,73 @@
+/*!*********************************************************************************************************************
+@file stack_guard.h
+@brief Header file for the hardware return stack high-water mark
+
+**********************************************************************************************************************/
+
+#ifndef __STACK_GUARD_H
+#define __STACK_GUARD_H
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define STACK_GUARD_LEVELS        (u8)31         /*!< @brief Return stack levels budgeted; Host/stack_depth.awk checks the same */
+#define STACK_GUARD_PAINT         (u8)0x1F       /*!< @brief TOSU of an unused level: above the top of program memory */
+
+
+/**********************************************************************************************************************
+Macros
+**********************************************************************************************************************/
+#if STACK_GUARD
+
+/*! @brief Moves the high-water mark up by at most one level.  Only in
+TMR1_ISR, which nothing can interrupt while STKPTR points elsewhere. */
+#define STACK_GUARD_SAMPLE(){                                        \
+u8 u8StackGuardLevel = STKPTR;                                       \
+if(u8StackGuardLevel > G_u8StackGuardHighWater)                      \
+{                                                                    \
+  G_u8StackGuardHighWater = u8StackGuardLevel;                       \
+}                                                                    \
+else if(G_u8StackGuardHighWater < STACK_GUARD_LEVELS)                \
+{                                                                    \
+  STKPTR = (u8)(G_u8StackGuardHighWater + 1);                        \
+  if(TOSU != STACK_GUARD_PAINT)                                      \
+  {                                                                  \
+    G_u8StackGuardHighWater++;                                       \
+  }                                                                  \
+  STKPTR = u8StackGuardLevel;                                        \
+}                                                                    \
+}
+
+#else
+
+#define STACK_GUARD_SAMPLE()
+
+#endif /* STACK_GUARD */
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+u8 StackGuardHighWater(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+void StackGuardInitialize(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+#endif /* __STACK_GUARD_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
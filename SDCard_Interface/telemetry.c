@@ -0,0 +1,377 @@
+/*!*********************************************************************************************************************
+@file telemetry.c
+@brief Binary telemetry stream on UART1: runtime stats a few times a second.
+
+Everything the firmware reports goes out as frames:
+
+    SYNC (0xA5)  type  length  payload[length]  sum1  sum2
+
+sum1 and sum2 are a Fletcher-16 checksum (mod 255) over type, length and
+payload.  A reader looks for SYNC and drops the byte if the checksum
+doesn't match, so a frame lost or garbled on the line costs only that
+frame.  A frame is built on the stack and queued with one UartWrite(); the
+DMA sends it.  If the ring is full the frame is dropped and counted in
+G_u32UartDropped, so nothing here ever waits.
+
+Every 250ms TelemetryRun sends a TELEMETRY_TYPE_STATS frame
+(all fields little-endian):
+
+  Offset  Size  Field
+  0       4     TimeBaseMs()
+  4       1     Heart rate in BPM from TelemetrySetBpm(), 0 if unknown
+  5       1     TELEMETRY_FLAG_xxx
+  6       2     AudioBufferedSamples()
+  8       4     G_u32AudioUnderruns
+  12      2     Longest SD_ReadSector in the period, us
+  14      2     Longest main loop pass in the period, us
+  16      1     LoopStatsBusyPercent()
+  17      4     Main loop overruns since LoopStatsReset
+  21      4     G_u32UartDropped
+  25      1     StackGuardHighWater(), return stack levels
+
+At 115200 baud that is 31 bytes, about 2.7ms of the line, four times a
+second.  G_u32AudioUnderruns is counted in TMR1_ISR, which masking GIEL
+doesn't hold off, so it is read until two reads agree.
+
+With every TELEMETRY_LOOP_PERIODS'th stats frame a TELEMETRY_TYPE_LOOP 
+frame carries the main loop pass histogram (loop_stats.c) since 
+LoopStatsReset: LOOP_STATS_BINS pass counts of 4 bytes, shortest bin first.
+That is another 37 bytes once a second.
+
+Other modules send their own frame types with TelemetrySend(), e.g.
+the region profiler.  Host/host_telemetry.c decodes a capture or a live
+serial port.
+
+TelemetryRun also takes single-byte commands from the UART:
+- 'p': dump the region profile (region_profile.c)
+- 'r': clear the region profile
+- 'f': freeze the flight recorder trace and write it to the card (trace.c)
+- 'g': empty the trace and start recording again
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- NONE
+
+CONSTANTS
+- TELEMETRY_SYNC, TELEMETRY_PAYLOAD_MAX, TELEMETRY_OVERHEAD
+- TELEMETRY_TYPE_STATS, TELEMETRY_TYPE_REGION, TELEMETRY_TYPE_LOOP
+- TELEMETRY_STATS_SIZE, TELEMETRY_LOOP_SIZE, TELEMETRY_LOOP_PERIODS
+- TELEMETRY_FLAG_PLAYING, TELEMETRY_FLAG_FULL_CLOCK, TELEMETRY_FLAG_TRACE_FROZEN
+
+TYPES
+- NONE
+
+PUBLIC FUNCTIONS
+- bool TelemetrySend(u8 u8Type_, const u8* pu8Payload_, u8 u8Length_)
+- u8 TelemetryPack(u8* pu8Payload_, u8 u8Length_, u32 u32Value_, u8 u8Bytes_)
+- void TelemetrySetBpm(u8 u8Bpm_)
+
+PROTECTED FUNCTIONS
+- void TelemetryInitialize(void)
+- void TelemetryRun(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Telemetry"
+***********************************************************************************************************************/
+/* New variables */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern volatile u32 G_u32AudioUnderruns;                  /*!< @brief From audio.c */
+extern volatile u16 G_u16SDReadMaxUs;                     /*!< @brief From sd.c */
+extern u32 G_u32UartDropped;                              /*!< @brief From uart.c */
+extern LoopStatsType G_stLoopStats;                       /*!< @brief From loop_stats.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Telemetry_<type>" and be declared as static.
+***********************************************************************************************************************/
+static u8 Telemetry_u8Bpm;                                /*!< @brief Latest heart rate, 0 if unknown */
+static u8 Telemetry_u8Periods;                            /*!< @brief Stats frames since the last loop histogram */
+
+static void TelemetrySendStats(void);
+static void TelemetrySendLoop(void);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool TelemetrySend(u8 u8Type_, const u8* pu8Payload_, u8 u8Length_)
+
+@brief Frames a payload and queues it on the UART.
+
+Requires:
+- Main loop context (UartWrite has one writer)
+- u8Length_ is at most TELEMETRY_PAYLOAD_MAX
+
+Promises:
+- Returns true if the whole frame was queued
+- Returns false if the ring had no room; nothing is queued and
+  G_u32UartDropped counts it.  Callers that would rather wait check
+  UartFree() for u8Length_ + TELEMETRY_OVERHEAD first.
+
+*/
+bool TelemetrySend(u8 u8Type_, const u8* pu8Payload_, u8 u8Length_)
+{
+  u8 au8Frame[TELEMETRY_PAYLOAD_MAX + TELEMETRY_OVERHEAD];
+  u8 u8Sum1 = 0;
+  u8 u8Sum2 = 0;
+  u16 u16Sum;
+  u8 u8Size;
+
+  au8Frame[0] = TELEMETRY_SYNC;
+  au8Frame[1] = u8Type_;
+  au8Frame[2] = u8Length_;
+  for(u8 i = 0; i < u8Length_; i++)
+  {
+    au8Frame[3 + i] = pu8Payload_[i];
+  }
+  u8Size = u8Length_ + 3;
+
+  /* Fletcher-16 from the type on.  Both sums stay below 255, so each
+   * addition is under 510 and one subtraction does for the modulo. */
+  for(u8 i = 1; i < u8Size; i++)
+  {
+    u16Sum = (u16)u8Sum1 + au8Frame[i];
+    u8Sum1 = (u8)((u16Sum >= 255) ? (u16Sum - 255) : u16Sum);
+    u16Sum = (u16)u8Sum2 + u8Sum1;
+    u8Sum2 = (u8)((u16Sum >= 255) ? (u16Sum - 255) : u16Sum);
+  }
+  au8Frame[u8Size++] = u8Sum1;
+  au8Frame[u8Size++] = u8Sum2;
+
+  return UartWrite(au8Frame, u8Size);
+
+} /* end TelemetrySend() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 TelemetryPack(u8* pu8Payload_, u8 u8Length_, u32 u32Value_, u8 u8Bytes_)
+
+@brief Appends the low u8Bytes_ bytes of a value to a payload, little-endian.
+
+Requires:
+- u8Bytes_ is 1 to 4 and there is room for them at pu8Payload_[u8Length_]
+
+Promises:
+- Returns the new payload length
+
+*/
+u8 TelemetryPack(u8* pu8Payload_, u8 u8Length_, u32 u32Value_, u8 u8Bytes_)
+{
+  while(u8Bytes_-- != 0)
+  {
+    pu8Payload_[u8Length_++] = (u8)u32Value_;
+    u32Value_ >>= 8;
+  }
+
+  return u8Length_;
+
+} /* end TelemetryPack() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TelemetrySetBpm(u8 u8Bpm_)
+
+@brief Sets the heart rate reported in the stats frames.
+
+Requires:
+- Main loop context
+
+Promises:
+- The next stats frames carry u8Bpm_ (0 for no reading)
+
+*/
+void TelemetrySetBpm(u8 u8Bpm_)
+{
+  Telemetry_u8Bpm = u8Bpm_;
+
+} /* end TelemetrySetBpm() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TelemetryInitialize(void)
+
+@brief Starts the stream with no heart rate.
+
+Should only be called once in main init section, after UartInitialize.
+
+Requires:
+- NONE
+
+Promises:
+- Heart rate 0; the first period's SD and loop peaks restart from 0
+
+*/
+void TelemetryInitialize(void)
+{
+  Telemetry_u8Bpm = 0;
+  Telemetry_u8Periods = 0;
+  G_u16SDReadMaxUs = 0;
+  G_stLoopStats.u16PeakBusyUs = 0;
+
+} /* end TelemetryInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TelemetryRun(void)
+
+@brief Scheduler task, every 250ms: takes UART commands and
+sends a stats frame.
+
+Requires:
+- TelemetryInitialize has been called
+
+Promises:
+- 'p' requests a region profile dump, 'r' clears the region profile, 'f'
+  freezes the trace and 'g' resumes it; other bytes are ignored
+- One TELEMETRY_TYPE_STATS frame queued, or counted as dropped, and every
+  TELEMETRY_LOOP_PERIODS'th call a TELEMETRY_TYPE_LOOP frame after it
+- The SD read and loop peaks restart for the next period
+
+*/
+void TelemetryRun(void)
+{
+  u8 u8Command;
+
+  while(UartRead(&u8Command))
+  {
+    if(u8Command == 'p')
+    {
+      RegionProfileDumpRequest();
+    }
+    else if(u8Command == 'r')
+    {
+      RegionProfileReset();
+    }
+    else if(u8Command == 'f')
+    {
+      TraceFreeze(TRACE_FREEZE_REQUEST);
+    }
+    else if(u8Command == 'g')
+    {
+      TraceResume();
+    }
+  }
+
+  TelemetrySendStats();
+
+  if(++Telemetry_u8Periods >= TELEMETRY_LOOP_PERIODS)
+  {
+    Telemetry_u8Periods = 0;
+    TelemetrySendLoop();
+  }
+
+} /* end TelemetryRun() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void TelemetrySendStats(void)
+
+@brief Sends one TELEMETRY_TYPE_STATS frame and restarts the period peaks.
+
+*/
+static void TelemetrySendStats(void)
+{
+  u8 au8Payload[TELEMETRY_STATS_SIZE];
+  u8 u8Length;
+  u8 u8Flags = 0;
+  u16 u16SDReadMaxUs;
+  u32 u32Underruns;
+  u8 u8GieSave;
+
+  if(AudioIsPlaying())
+  {
+    u8Flags |= TELEMETRY_FLAG_PLAYING;
+  }
+  if(ClockOperatingPoint() == CLOCK_OP_64MHZ)
+  {
+    u8Flags |= TELEMETRY_FLAG_FULL_CLOCK;
+  }
+  if(TraceIsFrozen())
+  {
+    u8Flags |= TELEMETRY_FLAG_TRACE_FROZEN;
+  }
+
+  /* Reads also happen in SW_ISR */
+  u8GieSave = INTCON0bits.GIEL;
+  INTCON0bits.GIEL = 0;
+  u16SDReadMaxUs = G_u16SDReadMaxUs;
+  G_u16SDReadMaxUs = 0;
+  INTCON0bits.GIEL = u8GieSave;
+
+  /* Counted in TMR1_ISR; two equal reads can't straddle an increment */
+  do
+  {
+    u32Underruns = G_u32AudioUnderruns;
+  } while(u32Underruns != G_u32AudioUnderruns);
+
+  u8Length = TelemetryPack(au8Payload, 0,        TimeBaseMs(),                 4);
+  u8Length = TelemetryPack(au8Payload, u8Length, Telemetry_u8Bpm,              1);
+  u8Length = TelemetryPack(au8Payload, u8Length, u8Flags,                      1);
+  u8Length = TelemetryPack(au8Payload, u8Length, AudioBufferedSamples(),       2);
+  u8Length = TelemetryPack(au8Payload, u8Length, u32Underruns,                 4);
+  u8Length = TelemetryPack(au8Payload, u8Length, u16SDReadMaxUs,               2);
+  u8Length = TelemetryPack(au8Payload, u8Length, G_stLoopStats.u16PeakBusyUs,  2);
+  u8Length = TelemetryPack(au8Payload, u8Length, LoopStatsBusyPercent(),       1);
+  u8Length = TelemetryPack(au8Payload, u8Length, G_stLoopStats.u32Overruns,    4);
+  u8Length = TelemetryPack(au8Payload, u8Length, G_u32UartDropped,             4);
+  u8Length = TelemetryPack(au8Payload, u8Length, StackGuardHighWater(),        1);
+  G_stLoopStats.u16PeakBusyUs = 0;
+
+  TelemetrySend(TELEMETRY_TYPE_STATS, au8Payload, u8Length);
+
+} /* end TelemetrySendStats() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void TelemetrySendLoop(void)
+
+@brief Sends one TELEMETRY_TYPE_LOOP frame with the main loop pass histogram.
+
+The histogram is only written by LoopStatsBusyEnd in the main loop, so it
+is copied as it stands.
+
+*/
+static void TelemetrySendLoop(void)
+{
+  u8 au8Payload[TELEMETRY_LOOP_SIZE];
+  u8 u8Length = 0;
+
+  for(u8 i = 0; i < LOOP_STATS_BINS; i++)
+  {
+    u8Length = TelemetryPack(au8Payload, u8Length, G_stLoopStats.au32Histogram[i], 4);
+  }
+
+  TelemetrySend(TELEMETRY_TYPE_LOOP, au8Payload, u8Length);
+
+} /* end TelemetrySendLoop() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,61 @@
+/*!*********************************************************************************************************************
+@file telemetry.h
+@brief Header file for the binary telemetry stream on UART1
+
+**********************************************************************************************************************/
+
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+bool TelemetrySend(u8 u8Type_, const u8* pu8Payload_, u8 u8Length_);
+u8   TelemetryPack(u8* pu8Payload_, u8 u8Length_, u32 u32Value_, u8 u8Bytes_);
+void TelemetrySetBpm(u8 u8Bpm_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+void TelemetryInitialize(void);
+void TelemetryRun(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/* Frame: SYNC, type, payload length, payload, Fletcher-16 of type, length and payload (sum1 then sum2) */
+#define TELEMETRY_SYNC            (u8)0xA5
+#define TELEMETRY_PAYLOAD_MAX     (u8)32               /*!< @brief Longest payload TelemetrySend takes */
+#define TELEMETRY_OVERHEAD        (u8)5                /*!< @brief Frame bytes around the payload */
+
+/* Frame types.  Payload fields are little-endian. */
+#define TELEMETRY_TYPE_STATS      (u8)0x01             /*!< @brief Periodic runtime stats, TELEMETRY_STATS_SIZE bytes, see telemetry.c */
+#define TELEMETRY_TYPE_REGION     (u8)0x02             /*!< @brief One region profiler entry, see region_profile.c */
+#define TELEMETRY_TYPE_LOOP       (u8)0x03             /*!< @brief Main loop pass histogram, TELEMETRY_LOOP_SIZE bytes, see telemetry.c */
+
+#define TELEMETRY_STATS_SIZE      (u8)26
+#define TELEMETRY_LOOP_SIZE       (u8)(4 * LOOP_STATS_BINS)
+#define TELEMETRY_LOOP_PERIODS    (u8)4                /*!< @brief Stats frames per loop histogram frame */
+
+/* TELEMETRY_TYPE_STATS flags */
+#define TELEMETRY_FLAG_PLAYING    (u8)0x01             /*!< @brief Audio playback running */
+#define TELEMETRY_FLAG_FULL_CLOCK (u8)0x02             /*!< @brief At the 64MHz operating point */
+#define TELEMETRY_FLAG_TRACE_FROZEN (u8)0x04           /*!< @brief Flight recorder frozen, see trace.c */
+
+
+#endif /* __TELEMETRY_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
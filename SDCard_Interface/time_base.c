@@ -0,0 +1,204 @@
+/*!*********************************************************************************************************************
+@file time_base.c                                                                
+@brief Tear-free reads of the system time.
+
+The 8-bit core needs several instructions to read G_u32SystemTime1ms, so TMR2_ISR
+can change it half way through.  TMR2_ISR brackets its updates with two
+increments of G_u8SystemTimeSequence, so the sequence is odd while an update
+is under way.  The readers here wait for an even sequence, copy the time and
+retry if the sequence moved while they were copying.  That keeps interrupts
+on and costs one extra byte compare when there is no tick.
+
+TimeBaseUs() adds the live Timer2 count to the microsecond total at the last
+tick.  Timer2 counts 8us steps, so timestamps are in microseconds with 8us 
+resolution, and they are 64-bit so they never wrap (UsTimerNow() has 1us
+resolution but wraps every 71 minutes).  If the tick interrupt is pending 
+but hasn't run (the caller is an ISR or has interrupts off), the missing
+tick is added so time never goes backwards.
+
+The readers are for the main loop and low priority ISRs, which TMR2_ISR
+either runs before or after.  TMR1_ISR can interrupt TMR2_ISR half way
+through an update and would wait for it forever; it must not call them.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- NONE
+
+CONSTANTS
+- TIME_BASE_US_PER_TICK
+- TIME_BASE_US_PER_COUNT
+
+TYPES
+- NONE
+
+PUBLIC FUNCTIONS
+- u32 TimeBaseMs(void)
+- u32 TimeBaseSeconds(void)
+- u64 TimeBaseUs(void)
+
+PROTECTED FUNCTIONS
+- NONE
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>TimeBase"
+***********************************************************************************************************************/
+/* New variables */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern volatile u32 G_u32SystemTime1ms;                   /*!< @brief From main.c */
+extern volatile u32 G_u32SystemTime1s;                    /*!< @brief From main.c */
+extern volatile u64 G_u64SystemTimeUs;                    /*!< @brief From main.c */
+extern volatile u8  G_u8SystemTimeSequence;               /*!< @brief From main.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "TimeBase_<type>" and be declared as static.
+***********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u32 TimeBaseMs(void)
+
+@brief Returns G_u32SystemTime1ms without risk of a torn read.
+
+Requires:
+- SysTickSetup has been called
+
+Promises:
+- Returns the system time in ms; safe from the main loop and low priority
+  ISRs, not from TMR1_ISR
+
+*/
+u32 TimeBaseMs(void)
+{
+  u8 u8Sequence;
+  u32 u32Ms;
+  
+  do
+  {
+    /* Odd: TMR2_ISR is part way through an update */
+    do
+    {
+      u8Sequence = G_u8SystemTimeSequence;
+    } while(u8Sequence & 0x01);
+    
+    u32Ms = G_u32SystemTime1ms;
+  } while(u8Sequence != G_u8SystemTimeSequence);
+  
+  return u32Ms;
+  
+} /* end TimeBaseMs() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u32 TimeBaseSeconds(void)
+
+@brief Returns G_u32SystemTime1s without risk of a torn read.
+
+Requires:
+- SysTickSetup has been called
+
+Promises:
+- Returns the system time in whole seconds; safe from the main loop and low
+  priority ISRs, not from TMR1_ISR
+
+*/
+u32 TimeBaseSeconds(void)
+{
+  u8 u8Sequence;
+  u32 u32Seconds;
+  
+  do
+  {
+    /* Odd: TMR2_ISR is part way through an update */
+    do
+    {
+      u8Sequence = G_u8SystemTimeSequence;
+    } while(u8Sequence & 0x01);
+    
+    u32Seconds = G_u32SystemTime1s;
+  } while(u8Sequence != G_u8SystemTimeSequence);
+  
+  return u32Seconds;
+  
+} /* end TimeBaseSeconds() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u64 TimeBaseUs(void)
+
+@brief Returns a 64-bit microsecond timestamp.
+
+Requires:
+- SysTickSetup has been called
+
+Promises:
+- Returns microseconds since SysTickSetup with 8us resolution; safe from the
+  main loop and low priority ISRs, not from TMR1_ISR
+- Successive calls never go backwards, even with the tick interrupt pending
+
+*/
+u64 TimeBaseUs(void)
+{
+  u8 u8Sequence;
+  u8 u8Count;
+  u64 u64Us;
+  
+  do
+  {
+    /* Odd: TMR2_ISR is part way through an update */
+    do
+    {
+      u8Sequence = G_u8SystemTimeSequence;
+    } while(u8Sequence & 0x01);
+    
+    u64Us = G_u64SystemTimeUs;
+    u8Count = T2TMR;
+    
+    /* A pending tick has reloaded the count but not advanced u64Us.  The 
+    count read above may be from before or after the reload; only one read 
+    after seeing the flag is known to be from the new period. */
+    if(PIR3bits.TMR2IF)
+    {
+      u8Count = T2TMR;
+      u64Us += TIME_BASE_US_PER_TICK;
+    }
+  } while(u8Sequence != G_u8SystemTimeSequence);
+  
+  return u64Us + (u16)u8Count * TIME_BASE_US_PER_COUNT;
+  
+} /* end TimeBaseUs() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
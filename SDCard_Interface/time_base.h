@@ -0,0 +1,48 @@
+/*!*********************************************************************************************************************
+@file time_base.h                                                                
+@brief Header file for the tear-free system time base
+
+**********************************************************************************************************************/
+
+#ifndef __TIME_BASE_H
+#define __TIME_BASE_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+u32 TimeBaseMs(void);
+u32 TimeBaseSeconds(void);
+u64 TimeBaseUs(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define TIME_BASE_US_PER_TICK     (u16)1000            /*!< @brief Systick period */
+#define TIME_BASE_US_PER_COUNT    (u8)8                /*!< @brief One Timer2 count at every operating point (see clock.c) */
+
+
+#endif /* __TIME_BASE_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,297 @@
+/*!*********************************************************************************************************************
+@file timer.c                                                                
+@brief Interrupt timer service.  Lets any module run a call-back from the 
+Timer1 or Timer3 interrupt without editing interrupts.c.
+
+Both timers count Fosc/4 through a 1:8 prescaler, so one tick is 0.5us and the
+longest period is 32,767us.  The ISRs in interrupts.c reload the timer, call
+the registered call-back through G_astTimers[] and stop the timer again if it
+was started one-shot.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_astTimers[]
+
+CONSTANTS
+- TIMER_MAX_TIME_US
+
+TYPES
+- TimerNumberType
+- TimerModeType
+- TimerType
+
+PUBLIC FUNCTIONS
+- void TimerSetCallback(TimerNumberType eTimer_, fnCode_type pfnCallback_)
+- void TimerStart(TimerNumberType eTimer_, u16 u16TimeXus_, TimerModeType eMode_)
+- void TimerStop(TimerNumberType eTimer_)
+- void TimerDefaultCallback(void)
+
+PROTECTED FUNCTIONS
+- void TimerInitialize(void)
+- void TimerMeasureDispatch(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Timer"
+***********************************************************************************************************************/
+/* New variables */
+volatile TimerType G_astTimers[TIMER_COUNT];              /*!< @brief Per-timer state used by TMR1_ISR and TMR3_ISR */
+
+#if TIMER_MEASURE_DISPATCH
+u16 G_u16TimerDirectCallCycles;                           /*!< @brief Cycles for a direct call of an empty function */
+u16 G_u16TimerCallbackCycles;                             /*!< @brief Cycles for the same call through G_astTimers[] */
+#endif
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Timer_<type>" and be declared as static.
+***********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerSetCallback(TimerNumberType eTimer_, fnCode_type pfnCallback_)
+
+@brief Registers the function the timer's ISR calls on every expiry.
+
+Requires:
+- pfnCallback_ is short enough to run inside a high priority ISR, or NULL
+
+Promises:
+- The timer interrupt is masked while the pointer changes so the ISR never 
+  sees half of it
+- NULL restores TimerDefaultCallback
+
+*/
+void TimerSetCallback(TimerNumberType eTimer_, fnCode_type pfnCallback_)
+{
+  u8 u8GieSave = INTCON0bits.GIEH;
+  
+  if(pfnCallback_ == NULL)
+  {
+    pfnCallback_ = TimerDefaultCallback;
+  }
+  
+  INTCON0bits.GIEH = 0;
+  G_astTimers[eTimer_].pfnCallback = pfnCallback_;
+  INTCON0bits.GIEH = u8GieSave;
+  
+} /* end TimerSetCallback() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerStart(TimerNumberType eTimer_, u16 u16TimeXus_, TimerModeType eMode_)
+
+@brief
+Starts the timer so its call-back runs every u16TimeXus_ microseconds 
+(TIMER_CONTINUOUS) or once after u16TimeXus_ microseconds (TIMER_ONE_SHOT).
+Maximum 32,767us.  Arguments higher than this will be capped back.
+
+Requires:
+- TimerInitialize has been called
+- A call-back is registered with TimerSetCallback
+
+Promises:
+- Timer stopped during configuration
+- Reload value saved in G_astTimers[eTimer_] and preloaded into TMRxH:L
+- TMRxIF cleared, interrupt enabled and timer enabled
+
+*/
+void TimerStart(TimerNumberType eTimer_, u16 u16TimeXus_, TimerModeType eMode_)
+{
+  u16 u16Temp;
+  
+  TimerStop(eTimer_);
+  
+  /* Correct the input parameter if it's too high */
+  if(u16TimeXus_ > TIMER_MAX_TIME_US)
+  {
+    u16TimeXus_ = TIMER_MAX_TIME_US;
+  }
+  
+  /* Double the time so it's in us not 0.5us */
+  u16Temp = 65535 - (u16)(u16TimeXus_ << 1);
+  G_astTimers[eTimer_].u8ReloadHi = (u8)( (u16Temp >> 8) & 0x00FF);
+  G_astTimers[eTimer_].u8ReloadLo = (u8)( u16Temp & 0x00FF);
+  G_astTimers[eTimer_].eMode      = eMode_;
+  
+  if(eTimer_ == TIMER_1)
+  {
+    TMR1H = G_astTimers[TIMER_1].u8ReloadHi;
+    TMR1L = G_astTimers[TIMER_1].u8ReloadLo;
+    PIR3bits.TMR1IF = 0;
+    PIE3bits.TMR1IE = 1;
+    T1CONbits.ON = 1;
+  }
+  else
+  {
+    TMR3H = G_astTimers[TIMER_3].u8ReloadHi;
+    TMR3L = G_astTimers[TIMER_3].u8ReloadLo;
+    PIR5bits.TMR3IF = 0;
+    PIE5bits.TMR3IE = 1;
+    T3CONbits.ON = 1;
+  }
+  
+} /* end TimerStart() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerStop(TimerNumberType eTimer_)
+
+@brief Stops the timer and its interrupt.
+
+Requires:
+- NONE
+
+Promises:
+- Timer off, interrupt disabled; the registered call-back is kept
+
+*/
+void TimerStop(TimerNumberType eTimer_)
+{
+  if(eTimer_ == TIMER_1)
+  {
+    PIE3bits.TMR1IE = 0;
+    T1CONbits.ON = 0;
+  }
+  else
+  {
+    PIE5bits.TMR3IE = 0;
+    T3CONbits.ON = 0;
+  }
+  
+} /* end TimerStop() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerDefaultCallback(void)
+
+@brief Empty call-back used until one is registered, so the ISRs never need to
+check for NULL.
+
+Requires:
+- NONE
+
+Promises:
+- NONE
+
+*/
+void TimerDefaultCallback(void)
+{
+  
+} /* end TimerDefaultCallback() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerInitialize(void)
+
+@brief Sets up Timer1 and Timer3 for 0.5us ticks, stopped, with the default call-back.
+
+Should only be called once in main init section.
+
+Requires:
+- NONE
+
+Promises:
+- Timer1 and Timer3: Fosc/4, 1:8 prescale, synced, 16-bit reads, off
+- Every timer's call-back is TimerDefaultCallback, mode one-shot
+
+*/
+void TimerInitialize(void)
+{
+  /* Timer1 initialization:
+   * 1:8 prescale, synced, RD16, disabled */
+  T1GCON = 0x00;
+  T1CLK  = 0x01;  
+  T1CON  = 0x32;  // b'00110010'
+  
+  /* Timer3 is set up the same way */
+  T3GCON = 0x00;
+  T3CLK  = 0x01;  
+  T3CON  = 0x32;  // b'00110010'
+  
+  for(u8 i = 0; i < TIMER_COUNT; i++)
+  {
+    G_astTimers[i].pfnCallback = TimerDefaultCallback;
+    G_astTimers[i].u8ReloadHi  = 0;
+    G_astTimers[i].u8ReloadLo  = 0;
+    G_astTimers[i].eMode       = TIMER_ONE_SHOT;
+  }
+  
+} /* end TimerInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerMeasureDispatch(void)
+
+@brief Measures what the call-back indirection costs compared to hard-coding 
+the call in the ISR.
+
+Compiles to nothing unless TIMER_MEASURE_DISPATCH is set.
+
+Requires:
+- Cycle counter running (CycleCounterSetup)
+- Timer1 stopped
+
+Promises:
+- G_u16TimerDirectCallCycles holds the cycles for a direct call of 
+  TimerDefaultCallback
+- G_u16TimerCallbackCycles holds the cycles for the same call made the way
+  TMR1_ISR makes it
+- Timer1's call-back is left as TimerDefaultCallback
+
+*/
+void TimerMeasureDispatch(void)
+{
+#if TIMER_MEASURE_DISPATCH
+  u16 u16Start;
+  u16 u16End;
+  
+  G_astTimers[TIMER_1].pfnCallback = TimerDefaultCallback;
+  
+  CYCLE_COUNT_READ(u16Start);
+  TimerDefaultCallback();
+  CYCLE_COUNT_READ(u16End);
+  G_u16TimerDirectCallCycles = u16End - u16Start;
+  
+  CYCLE_COUNT_READ(u16Start);
+  G_astTimers[TIMER_1].pfnCallback();
+  CYCLE_COUNT_READ(u16End);
+  G_u16TimerCallbackCycles = u16End - u16Start;
+#endif
+  
+} /* end TimerMeasureDispatch() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
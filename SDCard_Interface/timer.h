@@ -0,0 +1,76 @@
+/*!*********************************************************************************************************************
+@file timer.h                                                                
+@brief Header file for the interrupt timer service (Timer1 and Timer3)
+
+**********************************************************************************************************************/
+
+#ifndef __TIMER_H
+#define __TIMER_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*! 
+@enum TimerNumberType
+@brief Hardware timers that take call-backs.  Timer0 runs the microsecond event
+queue, Timer2 is the system tick and Timer5 is the cycle counter, so they are 
+not offered here.
+*/
+typedef enum {TIMER_1 = 0, TIMER_3 = 1, TIMER_COUNT = 2} TimerNumberType;
+
+/*! 
+@enum TimerModeType
+@brief Whether the timer stops after its first interrupt or keeps running.
+*/
+typedef enum {TIMER_ONE_SHOT = 0, TIMER_CONTINUOUS = 1} TimerModeType;
+
+/*! 
+@struct TimerType
+@brief State the timer ISR needs for one timer.
+*/
+typedef struct
+{
+  fnCode_type pfnCallback;        /*!< @brief Called from the timer ISR; KEEP IT SHORT */
+  u8 u8ReloadHi;                  /*!< @brief TMRxH value that gives the period */
+  u8 u8ReloadLo;                  /*!< @brief TMRxL value that gives the period */
+  TimerModeType eMode;            /*!< @brief One-shot or continuous */
+} TimerType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void TimerSetCallback(TimerNumberType eTimer_, fnCode_type pfnCallback_);
+void TimerStart(TimerNumberType eTimer_, u16 u16TimeXus_, TimerModeType eMode_);
+void TimerStop(TimerNumberType eTimer_);
+void TimerDefaultCallback(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void TimerInitialize(void);
+void TimerMeasureDispatch(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define TIMER_MAX_TIME_US         (u16)32767           /*!< @brief Longest period: 65535 ticks of 0.5us */
+
+
+#endif /* __TIMER_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,400 @@
+/*!*********************************************************************************************************************
+@file timer_wheel.c                                                                
+@brief Hierarchical software timer wheel driven by the 1ms system tick.
+
+Any number of timers can run at once; each one is a TimerWheelEntryType that
+its owner allocates, so there is no pool to size.  The wheel has 
+TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots.  Level 0 slots are 1ms
+apart, level 1 slots 32ms, level 2 slots 1024ms and level 3 slots 32768ms.
+A timer goes in the lowest level that can reach its expiry time, so starting
+and stopping are a list insert or unlink.
+
+The tick ISR does no wheel work; it only counts milliseconds.  TimerWheelRun()
+is a scheduler task that catches the wheel up to the system time one tick at 
+a time.  Each tick runs the timers in one level 0 slot, and every 32 ticks the
+next slot of the level above is cascaded down into the levels below it.  The
+work per tick does not depend on how many timers are running, only on how 
+many expire or cascade on that tick.
+
+Call-backs run in the main loop, so they may start or stop any timer, 
+including their own.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_u16TimerWheelActive
+- G_u16TimerWheelMaxLagMs
+
+CONSTANTS
+- TIMER_WHEEL_LEVELS, TIMER_WHEEL_BITS, TIMER_WHEEL_SLOTS, TIMER_WHEEL_MASK
+- TIMER_WHEEL_IDLE
+- TIMER_WHEEL_MAX_DELAY_MS
+
+TYPES
+- TimerWheelCallbackType
+- TimerWheelEntryType
+
+PUBLIC FUNCTIONS
+- void TimerWheelSetup(TimerWheelEntryType* pstTimer_, TimerWheelCallbackType pfnCallback_, u16 u16Param_)
+- void TimerWheelStart(TimerWheelEntryType* pstTimer_, u32 u32DelayMs_)
+- void TimerWheelStop(TimerWheelEntryType* pstTimer_)
+- bool TimerWheelIsActive(TimerWheelEntryType* pstTimer_)
+
+PROTECTED FUNCTIONS
+- void TimerWheelInitialize(void)
+- void TimerWheelRun(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>TimerWheel"
+***********************************************************************************************************************/
+/* New variables */
+u16 G_u16TimerWheelActive;                                /*!< @brief Number of timers currently running */
+u16 G_u16TimerWheelMaxLagMs;                              /*!< @brief Most ticks TimerWheelRun() has had to catch up at once */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "TimerWheel_<type>" and be declared as static.
+***********************************************************************************************************************/
+static TimerWheelEntryType* TimerWheel_apstSlots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS]; /*!< @brief List heads, level-major */
+static u32 TimerWheel_u32Now;                             /*!< @brief Last tick the wheel has processed */
+
+static void TimerWheelInsert(TimerWheelEntryType* pstTimer_);
+static void TimerWheelUnlink(TimerWheelEntryType* pstTimer_);
+static void TimerWheelCascade(u8 u8Slot_);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerWheelSetup(TimerWheelEntryType* pstTimer_, TimerWheelCallbackType pfnCallback_, u16 u16Param_)
+
+@brief Prepares a timer before its first use.
+
+Requires:
+- pstTimer_ is not running (or has never been set up)
+
+Promises:
+- The timer is idle and will call pfnCallback_(u16Param_) when it expires
+
+*/
+void TimerWheelSetup(TimerWheelEntryType* pstTimer_, TimerWheelCallbackType pfnCallback_, u16 u16Param_)
+{
+  pstTimer_->pstNext     = NULL;
+  pstTimer_->pstPrev     = NULL;
+  pstTimer_->pfnCallback = pfnCallback_;
+  pstTimer_->u16Param    = u16Param_;
+  pstTimer_->u8Slot      = TIMER_WHEEL_IDLE;
+  
+} /* end TimerWheelSetup() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerWheelStart(TimerWheelEntryType* pstTimer_, u32 u32DelayMs_)
+
+@brief Starts, or restarts, a timer so it expires u32DelayMs_ ms from now.
+
+Requires:
+- pstTimer_ set up with TimerWheelSetup
+- Main loop context only (not from an ISR)
+- TimerWheelRun() has run within the last TIMER_WHEEL_MAX_DELAY_MS
+
+Promises:
+- If the timer was running it is first stopped
+- Delays of 0 are treated as 1ms.  The expiry is capped to 
+  TIMER_WHEEL_MAX_DELAY_MS from the wheel time, so while the wheel lags 
+  the system time the longest delay is shortened by the lag.
+- The call-back runs from TimerWheelRun() on the first run at or after the
+  expiry time
+
+*/
+void TimerWheelStart(TimerWheelEntryType* pstTimer_, u32 u32DelayMs_)
+{
+  u32 u32Now = TimeBaseMs();
+  u32 u32Lag = u32Now - TimerWheel_u32Now;
+  
+  TimerWheelStop(pstTimer_);
+  
+  /* Past the wheel's reach the timer would go in a level 3 slot that is
+  cascaded a revolution early, and only ever back into itself */
+  if(u32DelayMs_ > (TIMER_WHEEL_MAX_DELAY_MS - u32Lag))
+  {
+    u32DelayMs_ = TIMER_WHEEL_MAX_DELAY_MS - u32Lag;
+  }
+  
+  if(u32DelayMs_ == 0)
+  {
+    u32DelayMs_ = 1;
+  }
+  
+  pstTimer_->u32ExpiresMs = u32Now + u32DelayMs_;
+  TimerWheelInsert(pstTimer_);
+  G_u16TimerWheelActive++;
+  
+} /* end TimerWheelStart() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerWheelStop(TimerWheelEntryType* pstTimer_)
+
+@brief Stops a timer so its call-back does not run.
+
+Requires:
+- pstTimer_ set up with TimerWheelSetup
+
+Promises:
+- The timer is idle; stopping an idle timer does nothing
+
+*/
+void TimerWheelStop(TimerWheelEntryType* pstTimer_)
+{
+  if(pstTimer_->u8Slot != TIMER_WHEEL_IDLE)
+  {
+    TimerWheelUnlink(pstTimer_);
+    G_u16TimerWheelActive--;
+  }
+  
+} /* end TimerWheelStop() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool TimerWheelIsActive(TimerWheelEntryType* pstTimer_)
+
+@brief Reports whether a timer is running.
+
+Requires:
+- pstTimer_ set up with TimerWheelSetup
+
+Promises:
+- Returns true from TimerWheelStart until the timer is stopped or its 
+  call-back is about to run
+
+*/
+bool TimerWheelIsActive(TimerWheelEntryType* pstTimer_)
+{
+  return (pstTimer_->u8Slot != TIMER_WHEEL_IDLE);
+  
+} /* end TimerWheelIsActive() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerWheelInitialize(void)
+
+@brief Empties the wheel and syncs it to the system time.
+
+Should only be called once in main init section, before any timer is started.
+
+Requires:
+- Systick is running
+
+Promises:
+- Every slot is empty and the wheel time is the current system time
+
+*/
+void TimerWheelInitialize(void)
+{
+  for(u8 i = 0; i < (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS); i++)
+  {
+    TimerWheel_apstSlots[i] = NULL;
+  }
+  
+  TimerWheel_u32Now = TimeBaseMs();
+  G_u16TimerWheelActive = 0;
+  G_u16TimerWheelMaxLagMs = 0;
+  
+} /* end TimerWheelInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TimerWheelRun(void)
+
+@brief Advances the wheel to the system time and runs every timer that expired.
+
+Runs from the scheduler every tick.  If the loop fell behind, the missed 
+ticks are processed in order so timers still fire in expiry order.
+
+Requires:
+- TimerWheelInitialize has been called
+
+Promises:
+- Every timer whose expiry time is at or before TimeBaseMs() has been 
+  made idle and its call-back run
+- G_u16TimerWheelMaxLagMs updated
+
+*/
+void TimerWheelRun(void)
+{
+  u32 u32Target = TimeBaseMs();
+  u32 u32Lag = u32Target - TimerWheel_u32Now;
+  u8 u8Index;
+  TimerWheelEntryType* pstTimer;
+  
+  if(u32Lag > G_u16TimerWheelMaxLagMs)
+  {
+    G_u16TimerWheelMaxLagMs = (u32Lag > 0xFFFF) ? 0xFFFF : (u16)u32Lag;
+  }
+  
+  while(TimerWheel_u32Now != u32Target)
+  {
+    TimerWheel_u32Now++;
+    
+    /* Every 32 ticks pull the next slot of each higher level down.  A level is
+    only cascaded when the level below it has wrapped. */
+    if( (TimerWheel_u32Now & TIMER_WHEEL_MASK) == 0 )
+    {
+      for(u8 u8Level = 1; u8Level < TIMER_WHEEL_LEVELS; u8Level++)
+      {
+        u8Index = (u8)(TimerWheel_u32Now >> (u8Level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+        TimerWheelCascade( (u8)(u8Level * TIMER_WHEEL_SLOTS) + u8Index );
+        
+        if(u8Index != 0)
+        {
+          break;
+        }
+      }
+    }
+    
+    /* Run the level 0 slot for this tick.  A call-back can't add to this slot
+    because every new timer is at least 1 tick in the future. */
+    u8Index = (u8)TimerWheel_u32Now & TIMER_WHEEL_MASK;
+    while(TimerWheel_apstSlots[u8Index] != NULL)
+    {
+      pstTimer = TimerWheel_apstSlots[u8Index];
+      TimerWheelUnlink(pstTimer);
+      G_u16TimerWheelActive--;
+      pstTimer->pfnCallback(pstTimer->u16Param);
+    }
+  }
+  
+} /* end TimerWheelRun() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void TimerWheelInsert(TimerWheelEntryType* pstTimer_)
+
+@brief Puts a timer at the head of the slot that matches its expiry time.
+
+Requires:
+- pstTimer_ is idle and u32ExpiresMs is within TIMER_WHEEL_MAX_DELAY_MS of 
+  TimerWheel_u32Now
+
+Promises:
+- The timer is in the lowest level whose span reaches u32ExpiresMs
+
+*/
+static void TimerWheelInsert(TimerWheelEntryType* pstTimer_)
+{
+  u32 u32Delta = pstTimer_->u32ExpiresMs - TimerWheel_u32Now;
+  u8 u8Level = 0;
+  u8 u8Slot;
+  
+  while( (u8Level < (TIMER_WHEEL_LEVELS - 1)) && 
+         (u32Delta >= (1UL << ((u8Level + 1) * TIMER_WHEEL_BITS))) )
+  {
+    u8Level++;
+  }
+  
+  u8Slot = (u8)(u8Level * TIMER_WHEEL_SLOTS) + 
+           ((u8)(pstTimer_->u32ExpiresMs >> (u8Level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK);
+  
+  pstTimer_->u8Slot  = u8Slot;
+  pstTimer_->pstPrev = NULL;
+  pstTimer_->pstNext = TimerWheel_apstSlots[u8Slot];
+  if(pstTimer_->pstNext != NULL)
+  {
+    pstTimer_->pstNext->pstPrev = pstTimer_;
+  }
+  TimerWheel_apstSlots[u8Slot] = pstTimer_;
+  
+} /* end TimerWheelInsert() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void TimerWheelUnlink(TimerWheelEntryType* pstTimer_)
+
+@brief Takes a timer out of its slot.
+
+Requires:
+- pstTimer_ is in a slot
+
+Promises:
+- The timer is idle; the active count is left to the caller
+
+*/
+static void TimerWheelUnlink(TimerWheelEntryType* pstTimer_)
+{
+  if(pstTimer_->pstPrev != NULL)
+  {
+    pstTimer_->pstPrev->pstNext = pstTimer_->pstNext;
+  }
+  else
+  {
+    TimerWheel_apstSlots[pstTimer_->u8Slot] = pstTimer_->pstNext;
+  }
+  
+  if(pstTimer_->pstNext != NULL)
+  {
+    pstTimer_->pstNext->pstPrev = pstTimer_->pstPrev;
+  }
+  
+  pstTimer_->pstNext = NULL;
+  pstTimer_->pstPrev = NULL;
+  pstTimer_->u8Slot  = TIMER_WHEEL_IDLE;
+  
+} /* end TimerWheelUnlink() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void TimerWheelCascade(u8 u8Slot_)
+
+@brief Moves every timer in a higher-level slot down to the level that now fits it.
+
+Requires:
+- u8Slot_ is a level 1 or higher slot that has just come due
+
+Promises:
+- The slot is empty and its timers are re-inserted relative to TimerWheel_u32Now
+
+*/
+static void TimerWheelCascade(u8 u8Slot_)
+{
+  TimerWheelEntryType* pstTimer;
+  
+  while(TimerWheel_apstSlots[u8Slot_] != NULL)
+  {
+    pstTimer = TimerWheel_apstSlots[u8Slot_];
+    TimerWheelUnlink(pstTimer);
+    TimerWheelInsert(pstTimer);
+  }
+  
+} /* end TimerWheelCascade() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
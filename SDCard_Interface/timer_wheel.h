@@ -0,0 +1,77 @@
+/*!*********************************************************************************************************************
+@file timer_wheel.h                                                                
+@brief Header file for the hierarchical software timer wheel
+
+**********************************************************************************************************************/
+
+#ifndef __TIMER_WHEEL_H
+#define __TIMER_WHEEL_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+struct TimerWheelEntry;
+
+/*! @brief Expiry call-back; receives the u16Param that was given to TimerWheelSetup */
+typedef void (*TimerWheelCallbackType)(u16 u16Param_);
+
+/*! 
+@struct TimerWheelEntryType
+@brief One software timer.  The owner allocates it (usually static) and only
+touches it through the TimerWheel functions.
+*/
+typedef struct TimerWheelEntry
+{
+  struct TimerWheelEntry* pstNext;    /*!< @brief Next timer in the same slot */
+  struct TimerWheelEntry* pstPrev;    /*!< @brief Previous timer in the same slot, NULL if first */
+  u32 u32ExpiresMs;                   /*!< @brief System time the timer fires */
+  TimerWheelCallbackType pfnCallback; /*!< @brief Called from TimerWheelRun() in the main loop */
+  u16 u16Param;                       /*!< @brief Passed to pfnCallback */
+  u8  u8Slot;                         /*!< @brief Wheel slot holding the timer, or TIMER_WHEEL_IDLE */
+} TimerWheelEntryType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void TimerWheelSetup(TimerWheelEntryType* pstTimer_, TimerWheelCallbackType pfnCallback_, u16 u16Param_);
+void TimerWheelStart(TimerWheelEntryType* pstTimer_, u32 u32DelayMs_);
+void TimerWheelStop(TimerWheelEntryType* pstTimer_);
+bool TimerWheelIsActive(TimerWheelEntryType* pstTimer_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void TimerWheelInitialize(void);
+void TimerWheelRun(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define TIMER_WHEEL_LEVELS        (u8)4                  /*!< @brief Number of wheels */
+#define TIMER_WHEEL_BITS          (u8)5                  /*!< @brief log2 of the slots per wheel */
+#define TIMER_WHEEL_SLOTS         (u8)(1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK          (u8)(TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_IDLE          (u8)0xFF               /*!< @brief u8Slot of a timer that is not running */
+
+/*! @brief Longest delay: 2^20 - 1 ms (about 17 minutes).  Longer delays are capped. */
+#define TIMER_WHEEL_MAX_DELAY_MS  (u32)((1UL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS)) - 1)
+
+
+#endif /* __TIMER_WHEEL_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,501 @@
+/*!*********************************************************************************************************************
+@file trace.c
+@brief Flight recorder: the last few hundred timestamped events, kept in RAM
+and written to the SD card when something goes wrong.
+
+Code marks what it is doing with TRACE_RECORD (main loop and low priority
+ISRs) or TRACE_RECORD_HIGH (TMR1_ISR): ISR entry and exit, SD commands and
+their completion, buffer swaps, fills and underruns, beats, song starts and
+stops.  Each event is a TraceEntryType stamped with UsTimerNow(), or
+UsTimerNowFromHighIsr() in TMR1_ISR.  The
+rings overwrite their oldest entries, so at any moment they hold the lead-up
+to now: about a second of a song at 8kHz.
+
+As in defer.c there are two single-producer rings so TMR1_ISR never waits:
+- Trace_astHigh is only written by TMR1_ISR, which nothing interrupts.
+- Trace_astLow is written by low priority ISRs, which don't nest, and by the
+  main loop with GIEL masked for the few cycles of the record.
+Host/host_trace.c merges them by timestamp.
+
+The trace freezes, and stops recording, on:
+- TraceFreeze() from code, or 'f' on the UART (telemetry.c)
+- The first underrun, with TRACE_FREEZE_ON_UNDERRUN
+- DEFAULT_ISR.  That usually locks the part up in the ISR, but the rings are
+  __persistent: after a reset the frozen trace is still there.
+- A reset by a stack overflow or underflow (PCON0), freezing what was
+  recorded before it
+TraceRun then writes it, a sector per call, to the TRACE_SD_SECTORS sectors
+from TRACE_SD_SECTOR, and it stays frozen until TraceResume() or 'g' on the
+UART.  Card images must leave those sectors free.
+
+Sector layout, little-endian:
+
+  Sector 0:  0  u32 TRACE_MAGIC       10  u16 0
+             4  u8  TRACE_VERSION     12  u32 UsTimerNow() at the freeze
+             5  u8  TRACE_FREEZE_xxx  16  Trace_astHigh, 8 bytes each
+             6  u8  next low entry
+             7  u8  low entries used
+             8  u8  next high entry
+             9  u8  high entries used
+  Sectors 1-2: Trace_astLow, 8 bytes each
+
+Host/host_trace.c turns a card image into Chrome trace-event JSON.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- NONE
+
+CONSTANTS
+- TRACE_LOW_ENTRIES, TRACE_HIGH_ENTRIES
+- TRACE_MAGIC, TRACE_VERSION, TRACE_SD_SECTORS
+- TRACE_EVENT_xxx, TRACE_ISR_xxx, TRACE_FREEZE_xxx
+
+TYPES
+- TraceEntryType
+
+PUBLIC FUNCTIONS
+- void TraceRecord(u8 u8Event_, u8 u8Arg_, u16 u16Arg_)
+- void TraceFromHighIsr(u8 u8Event_, u8 u8Arg_, u16 u16Arg_)
+- void TraceFreeze(u8 u8Reason_)
+- void TraceFreezeFromHighIsr(u8 u8Reason_)
+- void TraceResume(void)
+- bool TraceIsFrozen(void)
+
+PROTECTED FUNCTIONS
+- void TraceInitialize(void)
+- void TraceRun(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Trace"
+***********************************************************************************************************************/
+/* New variables */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+extern u8 G_au8SDWriteBuffer[512];                        /*!< @brief From sd.c */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Trace_<type>" and be declared as static.
+***********************************************************************************************************************/
+#if TRACE
+/* Not cleared at start-up, so a trace frozen before a reset can still be flushed */
+static __persistent TraceEntryType Trace_astLow[TRACE_LOW_ENTRIES];
+static __persistent TraceEntryType Trace_astHigh[TRACE_HIGH_ENTRIES];
+static __persistent u32 Trace_u32Magic;                   /*!< @brief TRACE_MAGIC once the rings have been set up */
+static __persistent u32 Trace_u32FrozenUs;                /*!< @brief UsTimerNow() at the freeze */
+static __persistent volatile u8 Trace_u8Reason;           /*!< @brief TRACE_FREEZE_xxx; recording stops unless NONE */
+static __persistent volatile bool Trace_bFlushed;         /*!< @brief The frozen trace is on the card */
+static __persistent u8 Trace_u8LowNext;                   /*!< @brief Next entry to write in Trace_astLow */
+static __persistent u8 Trace_u8LowCount;                  /*!< @brief Entries used, up to TRACE_LOW_ENTRIES */
+static __persistent u8 Trace_u8HighNext;
+static __persistent u8 Trace_u8HighCount;
+
+static u8 Trace_u8FlushSector;                            /*!< @brief Next of the TRACE_SD_SECTORS to write */
+
+static void TraceFreezeAt(u8 u8Reason_, u32 u32TimeUs_);
+static u16 TracePutEntries(u16 u16Offset_, const TraceEntryType* pstEntries_, u8 u8Count_);
+static u16 TracePut(u16 u16Offset_, u32 u32Value_, u8 u8Bytes_);
+#endif
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TraceRecord(u8 u8Event_, u8 u8Arg_, u16 u16Arg_)
+
+@brief Adds an event to the low ring.  Normally called through TRACE_RECORD.
+
+Requires:
+- Main loop or low priority ISR context (TMR1_ISR uses TraceFromHighIsr)
+- u8Event_ is a TRACE_EVENT_xxx code
+
+Promises:
+- Unless the trace is frozen, the event is stored with the time in place of
+  the oldest one
+- GIEL is masked only for the store
+
+*/
+void TraceRecord(u8 u8Event_, u8 u8Arg_, u16 u16Arg_)
+{
+#if TRACE
+  TraceEntryType* pstEntry;
+  u8 u8GieSave;
+
+  if(Trace_u8Reason != TRACE_FREEZE_NONE)
+  {
+    return;
+  }
+
+  u8GieSave = INTCON0bits.GIEL;
+  INTCON0bits.GIEL = 0;
+
+  pstEntry = &Trace_astLow[Trace_u8LowNext];
+  Trace_u8LowNext = (Trace_u8LowNext + 1) & (TRACE_LOW_ENTRIES - 1);
+  if(Trace_u8LowCount < TRACE_LOW_ENTRIES)
+  {
+    Trace_u8LowCount++;
+  }
+
+  pstEntry->u32TimeUs = UsTimerNow();
+  pstEntry->u8Event   = u8Event_;
+  pstEntry->u8Arg     = u8Arg_;
+  pstEntry->u16Arg    = u16Arg_;
+
+  INTCON0bits.GIEL = u8GieSave;
+#endif
+
+} /* end TraceRecord() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TraceFromHighIsr(u8 u8Event_, u8 u8Arg_, u16 u16Arg_)
+
+@brief Adds an event to the high ring.  Normally called through TRACE_RECORD_HIGH.
+
+Requires:
+- Called only from high priority interrupt context
+
+Promises:
+- As TraceRecord, without touching GIEH or GIEL; the time comes from 
+  UsTimerNowFromHighIsr(), so it may be a few microseconds early if Timer0
+  was being re-armed
+
+*/
+void TraceFromHighIsr(u8 u8Event_, u8 u8Arg_, u16 u16Arg_)
+{
+#if TRACE
+  TraceEntryType* pstEntry;
+
+  if(Trace_u8Reason != TRACE_FREEZE_NONE)
+  {
+    return;
+  }
+
+  pstEntry = &Trace_astHigh[Trace_u8HighNext];
+  Trace_u8HighNext = (Trace_u8HighNext + 1) & (TRACE_HIGH_ENTRIES - 1);
+  if(Trace_u8HighCount < TRACE_HIGH_ENTRIES)
+  {
+    Trace_u8HighCount++;
+  }
+
+  pstEntry->u32TimeUs = UsTimerNowFromHighIsr();
+  pstEntry->u8Event   = u8Event_;
+  pstEntry->u8Arg     = u8Arg_;
+  pstEntry->u16Arg    = u16Arg_;
+#endif
+
+} /* end TraceFromHighIsr() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TraceFreeze(u8 u8Reason_)
+
+@brief Stops recording so TraceRun can write the trace to the card.
+
+Requires:
+- Main loop or low priority ISR context (TMR1_ISR uses TraceFreezeFromHighIsr)
+- u8Reason_ is a TRACE_FREEZE_xxx code other than NONE
+
+Promises:
+- If not already frozen, recording stops, the time and reason are kept
+  and a flush is started; a trace already frozen keeps its first reason
+
+*/
+void TraceFreeze(u8 u8Reason_)
+{
+#if TRACE
+  TraceFreezeAt(u8Reason_, UsTimerNow());
+#endif
+
+} /* end TraceFreeze() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TraceFreezeFromHighIsr(u8 u8Reason_)
+
+@brief Stops recording from TMR1_ISR.
+
+Requires:
+- Called only from high priority interrupt context
+- u8Reason_ is a TRACE_FREEZE_xxx code other than NONE
+
+Promises:
+- As TraceFreeze, timed with UsTimerNowFromHighIsr()
+
+*/
+void TraceFreezeFromHighIsr(u8 u8Reason_)
+{
+#if TRACE
+  TraceFreezeAt(u8Reason_, UsTimerNowFromHighIsr());
+#endif
+
+} /* end TraceFreezeFromHighIsr() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TraceResume(void)
+
+@brief Empties the rings and starts recording again, as 'g' on the UART does.
+
+Requires:
+- Main loop context
+
+Promises:
+- Both rings empty, not frozen; the copy on the card is left as it is
+
+*/
+void TraceResume(void)
+{
+#if TRACE
+  u8 u8GieSave = INTCON0bits.GIEL;
+
+  INTCON0bits.GIEL = 0;
+  Trace_u8LowNext = 0;
+  Trace_u8LowCount = 0;
+  Trace_u8HighNext = 0;
+  Trace_u8HighCount = 0;
+  Trace_u32Magic = TRACE_MAGIC;
+  Trace_bFlushed = false;
+  Trace_u8Reason = TRACE_FREEZE_NONE;
+  INTCON0bits.GIEL = u8GieSave;
+#endif
+
+} /* end TraceResume() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool TraceIsFrozen(void)
+
+@brief Reports whether the trace is frozen (and so being or been written to the card).
+
+Requires:
+- NONE
+
+Promises:
+- Returns true from a freeze until TraceResume; always false without TRACE
+
+*/
+bool TraceIsFrozen(void)
+{
+#if TRACE
+  return (Trace_u8Reason != TRACE_FREEZE_NONE);
+#else
+  return false;
+#endif
+
+} /* end TraceIsFrozen() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TraceInitialize(void)
+
+@brief Keeps a trace that the last reset interrupted, or starts a new one.
+
+Should only be called once in main init section, after UsTimerInitialize
+and before anything that records.
+
+Requires:
+- UsTimerInitialize has been called
+
+Promises:
+- A trace frozen but not yet flushed before the reset stays frozen
+- After a stack overflow or underflow reset, the trace recorded before it
+  is frozen with TRACE_FREEZE_STACK
+- Otherwise the rings are emptied and recording starts
+- PCON0 STKOVF and STKUNF cleared
+
+*/
+void TraceInitialize(void)
+{
+#if TRACE
+  bool bStackReset = PCON0bits.STKOVF || PCON0bits.STKUNF;
+
+  PCON0bits.STKOVF = 0;
+  PCON0bits.STKUNF = 0;
+  Trace_u8FlushSector = 0;
+
+  if(Trace_u32Magic == TRACE_MAGIC)
+  {
+    Trace_u8LowNext  &= (TRACE_LOW_ENTRIES - 1);
+    Trace_u8HighNext &= (TRACE_HIGH_ENTRIES - 1);
+
+    if( (Trace_u8Reason != TRACE_FREEZE_NONE) && !Trace_bFlushed )
+    {
+      return;
+    }
+
+    if(bStackReset)
+    {
+      /* The time base restarted, so call the newest entry the freeze */
+      Trace_u32FrozenUs = Trace_astLow[(Trace_u8LowNext - 1) & (TRACE_LOW_ENTRIES - 1)].u32TimeUs;
+      Trace_bFlushed = false;
+      Trace_u8Reason = TRACE_FREEZE_STACK;
+      return;
+    }
+  }
+
+  TraceResume();
+#endif
+
+} /* end TraceInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void TraceRun(void)
+
+@brief Scheduler task: writes a frozen trace to the card, a sector per call.
+
+Requires:
+- TraceInitialize has been called
+- In the scheduler table only when TRACE is set
+
+Promises:
+- While frozen and not yet flushed, the next of the TRACE_SD_SECTORS
+  sectors from TRACE_SD_SECTOR is built in G_au8SDWriteBuffer and written;
+  a failed write is tried again on the next call
+- Once all are written the trace stays frozen until TraceResume
+
+*/
+void TraceRun(void)
+{
+#if TRACE
+  u32 u32Sector;
+  u16 u16Offset;
+
+  if( (Trace_u8Reason == TRACE_FREEZE_NONE) || Trace_bFlushed )
+  {
+    return;
+  }
+
+  if(Trace_u8FlushSector == 0)
+  {
+    u16Offset = TracePut(0,         Trace_u32Magic,    4);
+    u16Offset = TracePut(u16Offset, TRACE_VERSION,     1);
+    u16Offset = TracePut(u16Offset, Trace_u8Reason,    1);
+    u16Offset = TracePut(u16Offset, Trace_u8LowNext,   1);
+    u16Offset = TracePut(u16Offset, Trace_u8LowCount,  1);
+    u16Offset = TracePut(u16Offset, Trace_u8HighNext,  1);
+    u16Offset = TracePut(u16Offset, Trace_u8HighCount, 1);
+    u16Offset = TracePut(u16Offset, 0,                 2);
+    u16Offset = TracePut(u16Offset, Trace_u32FrozenUs, 4);
+    u16Offset = TracePutEntries(u16Offset, Trace_astHigh, TRACE_HIGH_ENTRIES);
+  }
+  else
+  {
+    u16Offset = TracePutEntries(0, &Trace_astLow[(u8)(Trace_u8FlushSector - 1) * (TRACE_LOW_ENTRIES / 2)],
+                                TRACE_LOW_ENTRIES / 2);
+  }
+
+  while(u16Offset < sizeof(G_au8SDWriteBuffer))
+  {
+    G_au8SDWriteBuffer[u16Offset++] = 0;
+  }
+
+  u32Sector = TRACE_SD_SECTOR + Trace_u8FlushSector;
+  if(SD_WriteBlock((u8)(u32Sector >> 24), (u8)(u32Sector >> 16), (u8)(u32Sector >> 8), (u8)u32Sector))
+  {
+    if(++Trace_u8FlushSector == TRACE_SD_SECTORS)
+    {
+      Trace_bFlushed = true;
+    }
+  }
+#endif
+
+} /* end TraceRun() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+#if TRACE
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void TraceFreezeAt(u8 u8Reason_, u32 u32TimeUs_)
+
+@brief Freezes the trace for TraceFreeze and TraceFreezeFromHighIsr.
+
+Promises:
+- If not already frozen, recording stops, u32TimeUs_ and the reason are kept
+  and a flush is started
+
+*/
+static void TraceFreezeAt(u8 u8Reason_, u32 u32TimeUs_)
+{
+  if(Trace_u8Reason != TRACE_FREEZE_NONE)
+  {
+    return;
+  }
+
+  Trace_u32FrozenUs = u32TimeUs_;
+  Trace_bFlushed = false;
+  Trace_u8FlushSector = 0;
+  Trace_u8Reason = u8Reason_;
+
+} /* end TraceFreezeAt() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u16 TracePutEntries(u16 u16Offset_, const TraceEntryType* pstEntries_, u8 u8Count_)
+
+@brief Copies entries into G_au8SDWriteBuffer at u16Offset_; returns the offset after them.
+
+*/
+static u16 TracePutEntries(u16 u16Offset_, const TraceEntryType* pstEntries_, u8 u8Count_)
+{
+  for(u8 i = 0; i < u8Count_; i++)
+  {
+    u16Offset_ = TracePut(u16Offset_, pstEntries_[i].u32TimeUs, 4);
+    u16Offset_ = TracePut(u16Offset_, pstEntries_[i].u8Event,   1);
+    u16Offset_ = TracePut(u16Offset_, pstEntries_[i].u8Arg,     1);
+    u16Offset_ = TracePut(u16Offset_, pstEntries_[i].u16Arg,    2);
+  }
+
+  return u16Offset_;
+
+} /* end TracePutEntries() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u16 TracePut(u16 u16Offset_, u32 u32Value_, u8 u8Bytes_)
+
+@brief Writes the low u8Bytes_ bytes of a value into G_au8SDWriteBuffer, little-endian; returns the offset after them.
+
+*/
+static u16 TracePut(u16 u16Offset_, u32 u32Value_, u8 u8Bytes_)
+{
+  while(u8Bytes_-- != 0)
+  {
+    G_au8SDWriteBuffer[u16Offset_++] = (u8)u32Value_;
+    u32Value_ >>= 8;
+  }
+
+  return u16Offset_;
+
+} /* end TracePut() */
+#endif /* TRACE */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,116 @@
+/*!*********************************************************************************************************************
+@file trace.h
+@brief Header file for the flight recorder trace buffer
+
+**********************************************************************************************************************/
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define TRACE_LOW_ENTRIES         (u8)128        /*!< @brief Main loop and low priority ISR ring; a power of two */
+#define TRACE_HIGH_ENTRIES        (u8)16         /*!< @brief TMR1_ISR ring; a power of two */
+
+#define TRACE_MAGIC               (u32)0x52544648  /*!< @brief "HFTR" little-endian: rings hold a valid trace */
+#define TRACE_VERSION             (u8)1          /*!< @brief Bump if the entry or sector layout changes */
+#define TRACE_SD_SECTORS          (u8)3          /*!< @brief Header and high ring, then the low ring */
+
+/* Events: u8Event of TraceEntryType.  u8Arg and u16Arg as listed. */
+#define TRACE_EVENT_ISR_ENTER     (u8)0x01       /*!< @brief u8Arg = TRACE_ISR_xxx */
+#define TRACE_EVENT_ISR_EXIT      (u8)0x02       /*!< @brief u8Arg = TRACE_ISR_xxx */
+#define TRACE_EVENT_SD_COMMAND    (u8)0x03       /*!< @brief u8Arg = command index, u16Arg = low 16 bits of the address */
+#define TRACE_EVENT_SD_DONE       (u8)0x04       /*!< @brief u8Arg = command index, u16Arg = 1 success, 0 failure */
+#define TRACE_EVENT_BUFFER_SWAP   (u8)0x05       /*!< @brief TMR1_ISR moved on; u8Arg = buffer now playing */
+#define TRACE_EVENT_UNDERRUN      (u8)0x06       /*!< @brief TMR1_ISR ran dry; u8Arg = buffer it is repeating */
+#define TRACE_EVENT_BUFFER_FILLED (u8)0x07       /*!< @brief u8Arg = buffer, u16Arg = low 16 bits of the sector */
+#define TRACE_EVENT_BEAT          (u8)0x08       /*!< @brief Heart beat detected; u16Arg = beat timestamp */
+#define TRACE_EVENT_SONG_START    (u8)0x09       /*!< @brief AudioStart; u16Arg = low 16 bits of the first sector */
+#define TRACE_EVENT_SONG_STOP     (u8)0x0A       /*!< @brief AudioStop while playing */
+#define TRACE_EVENT_MARK          (u8)0x0B       /*!< @brief Anything else worth a marker; arguments are the caller's */
+
+/* TRACE_EVENT_ISR_xxx sources.  TMR1_ISR (every sample) and TMR2_ISR (every
+   1ms) would fill the rings in milliseconds, so they are not traced. */
+#define TRACE_ISR_SW              (u8)0
+#define TRACE_ISR_DMA1SCNT        (u8)1
+#define TRACE_ISR_TMR0            (u8)2
+#define TRACE_ISR_TMR3            (u8)3
+#define TRACE_ISR_DEFAULT         (u8)4
+
+/* Why the trace was frozen */
+#define TRACE_FREEZE_NONE         (u8)0
+#define TRACE_FREEZE_REQUEST      (u8)1          /*!< @brief TraceFreeze from code or 'f' on the UART */
+#define TRACE_FREEZE_UNDERRUN     (u8)2          /*!< @brief First underrun, with TRACE_FREEZE_ON_UNDERRUN */
+#define TRACE_FREEZE_UNHANDLED    (u8)3          /*!< @brief DEFAULT_ISR ran */
+#define TRACE_FREEZE_STACK        (u8)4          /*!< @brief Reset by a stack overflow or underflow */
+
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+/*!
+@struct TraceEntryType
+@brief One event.  8 bytes, stored and flushed little-endian in this order.
+*/
+typedef struct
+{
+  u32 u32TimeUs;                                /*!< @brief UsTimerNow() when recorded */
+  u8  u8Event;                                  /*!< @brief TRACE_EVENT_xxx */
+  u8  u8Arg;
+  u16 u16Arg;
+} TraceEntryType;
+
+
+/**********************************************************************************************************************
+Macros
+**********************************************************************************************************************/
+#if TRACE
+
+/*! @brief Records an event from the main loop or a low priority ISR */
+#define TRACE_RECORD(EVENT, ARG, ARG16)           TraceRecord((EVENT), (ARG), (ARG16))
+
+/*! @brief Records an event from TMR1_ISR */
+#define TRACE_RECORD_HIGH(EVENT, ARG, ARG16)      TraceFromHighIsr((EVENT), (ARG), (ARG16))
+
+#else
+
+#define TRACE_RECORD(EVENT, ARG, ARG16)
+#define TRACE_RECORD_HIGH(EVENT, ARG, ARG16)
+
+#endif /* TRACE */
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+void TraceRecord(u8 u8Event_, u8 u8Arg_, u16 u16Arg_);
+void TraceFromHighIsr(u8 u8Event_, u8 u8Arg_, u16 u16Arg_);
+void TraceFreeze(u8 u8Reason_);
+void TraceFreezeFromHighIsr(u8 u8Reason_);
+void TraceResume(void);
+bool TraceIsFrozen(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+void TraceInitialize(void);
+void TraceRun(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+#endif /* __TRACE_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,326 @@
+/*!*********************************************************************************************************************
+@file uart.c
+@brief UART1 driver: 115200 8N1, transmit by DMA from a ring buffer.
+
+UartWrite() copies a message into a 256-byte ring and returns; DMA1, paced
+by U1TX, moves the bytes to U1TXB with no CPU involvement.  The DMA sends
+one contiguous block at a time: from the oldest byte up to the newest, or
+up to the end of the ring if the data wraps.  DMA1SCNT_ISR fires once the
+block has gone and UartDmaDone() starts the next one.  So the CPU cost of a
+message is its copy into the ring plus one short low priority interrupt per
+block.
+
+A message that doesn't fit in the free space is dropped whole and counted
+in G_u32UartDropped, so writers never wait for the line.
+
+Receive is polled with UartRead(); nothing in the firmware receives much.
+
+U1TX is on RC6 and U1RX on RC5 (GpioSetup).  U1BRG is rescaled with the
+other clock-derived peripherals on an operating point change (clock.c), and
+ClockRun doesn't drop to 16MHz until the UART is idle.  A switch up to
+64MHz can still land mid-byte and garble that byte.
+
+DMA1 is the only DMA channel in use.  The system arbiter gives it priority
+over the main loop but below the ISRs.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_u32UartDropped
+
+CONSTANTS
+- UART_BRG_16MHZ, UART_BRG_64MHZ
+- UART_RING_SIZE
+
+TYPES
+- NONE
+
+PUBLIC FUNCTIONS
+- bool UartWrite(const u8* pu8Data_, u8 u8Length_)
+- u8 UartFree(void)
+- bool UartIsIdle(void)
+- bool UartRead(u8* pu8Byte_)
+
+PROTECTED FUNCTIONS
+- void UartInitialize(void)
+- void UartDmaDone(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>Uart"
+***********************************************************************************************************************/
+/* New variables */
+u32 G_u32UartDropped;                                     /*!< @brief Messages refused by UartWrite for lack of room */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "Uart_<type>" and be declared as static.
+***********************************************************************************************************************/
+static u8 Uart_au8Ring[UART_RING_SIZE];
+static volatile u8  Uart_u8Head;                          /*!< @brief Next free byte; written by UartWrite only */
+static volatile u8  Uart_u8Tail;                          /*!< @brief Oldest unsent byte; moved on as DMA blocks finish */
+static volatile u16 Uart_u16Sending;                      /*!< @brief Bytes in the DMA block under way, 0 when idle */
+
+static void UartStartDma(void);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool UartWrite(const u8* pu8Data_, u8 u8Length_)
+
+@brief Queues a message for transmission.
+
+Requires:
+- Main loop context (one writer)
+- u8Length_ is at most UART_RING_SIZE - 1
+
+Promises:
+- If there is room, the whole message is queued, the DMA is started if it
+  was idle and true is returned
+- Otherwise nothing is queued, G_u32UartDropped is incremented and false
+  is returned
+
+*/
+bool UartWrite(const u8* pu8Data_, u8 u8Length_)
+{
+  u8 u8Head = Uart_u8Head;
+  u8 u8GieSave;
+
+  if(u8Length_ > UartFree())
+  {
+    G_u32UartDropped++;
+    return false;
+  }
+
+  for(u8 i = 0; i < u8Length_; i++)
+  {
+    Uart_au8Ring[u8Head++] = pu8Data_[i];
+  }
+  Uart_u8Head = u8Head;
+
+  u8GieSave = INTCON0bits.GIEL;
+  INTCON0bits.GIEL = 0;
+  if(Uart_u16Sending == 0)
+  {
+    UartStartDma();
+  }
+  INTCON0bits.GIEL = u8GieSave;
+
+  return true;
+
+} /* end UartWrite() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u8 UartFree(void)
+
+@brief Returns the bytes UartWrite can take right now.
+
+Requires:
+- NONE
+
+Promises:
+- Returns 0 to UART_RING_SIZE - 1; only grows until the next UartWrite
+
+*/
+u8 UartFree(void)
+{
+  return (u8)(Uart_u8Tail - Uart_u8Head - 1);
+
+} /* end UartFree() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool UartIsIdle(void)
+
+@brief Reports whether everything queued has left the pin.
+
+Requires:
+- NONE
+
+Promises:
+- Returns true if the ring is empty and the transmit shift register is
+  empty, so the baud rate can be changed without garbling a byte
+
+*/
+bool UartIsIdle(void)
+{
+  return (Uart_u16Sending == 0) && U1ERRIRbits.TXMTIF;
+
+} /* end UartIsIdle() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn bool UartRead(u8* pu8Byte_)
+
+@brief Takes one received byte, if there is one.
+
+Requires:
+- Main loop context
+
+Promises:
+- Returns true with the oldest received byte in *pu8Byte_, or false if
+  nothing has been received
+- A receive FIFO overflow is cleared; the bytes that didn't fit are lost
+
+*/
+bool UartRead(u8* pu8Byte_)
+{
+  if(U1ERRIRbits.RXFOIF)
+  {
+    U1ERRIRbits.RXFOIF = 0;
+  }
+
+  if(!HAL_UART_RX_READY())
+  {
+    return false;
+  }
+
+  *pu8Byte_ = HAL_UART_READ();
+  return true;
+
+} /* end UartRead() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UartInitialize(void)
+
+@brief Sets up UART1 and DMA1 with nothing to send.
+
+Should only be called once in main init section, after GpioSetup and
+before ClockInitialize, while the clock is at 64MHz.
+
+Requires:
+- U1MD and DMA1MD cleared in PowerSetup; pins assigned in GpioSetup
+
+Promises:
+- UART1 on at 115200 8N1, transmit and receive enabled
+- DMA1 moves bytes from the ring to U1TXB, one per U1TX request, and sets
+  DMA1SCNTIF (low priority, enabled) at the end of each block
+- System arbiter: ISRs, then DMA1, then the main loop; priorities locked
+- Ring empty, G_u32UartDropped cleared
+
+*/
+void UartInitialize(void)
+{
+  u8 u8GieSave = INTCON0bits.GIEH;
+
+  Uart_u8Head = 0;
+  Uart_u8Tail = 0;
+  Uart_u16Sending = 0;
+  G_u32UartDropped = 0;
+
+  U1CON0 = 0xB0;          // b'10110000' BRGS high speed, TX and RX on, asynchronous 8-bit
+  U1CON2 = 0x00;          // Normal polarity, 1 stop bit, no flow control
+  U1BRG  = UART_BRG_64MHZ;
+  U1CON1 = 0x80;          // b'10000000' Serial port on
+
+  /* DMA1: ring (data space, incrementing) to U1TXB (fixed), triggered by U1TX */
+  DMASELECT = 0x00;
+  DMAnCON0  = 0x00;
+  DMAnCON1  = 0x03;       // b'00000011' DMODE fixed, SMR data space, SMODE increment, SSTP: stop at end of block
+  DMAnDSA   = (u16)(size_t)&U1TXB;
+  DMAnDSZ   = 1;
+  DMAnSIRQ  = IRQ_U1TX;
+  DMAnAIRQ  = 0x00;
+  DMAnCON0  = 0x80;       // b'10000000' Enabled, waiting for a block (SIRQEN clear)
+
+  /* DMA has priority over the main loop but not over an ISR.  The DMA won't
+   * run until the priorities are locked, which can only be done once. */
+  INTCON0bits.GIEH = 0;
+  ISRPR  = 0;
+  DMA1PR = 1;
+  MAINPR = 2;
+  PRLOCK = 0x55;
+  PRLOCK = 0xAA;
+  PRLOCKbits.PRLOCKED = 1;
+  INTCON0bits.GIEH = u8GieSave;
+
+  PIR2bits.DMA1SCNTIF = 0;
+  PIE2bits.DMA1SCNTIE = 1;
+
+} /* end UartInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UartDmaDone(void)
+
+@brief Called from DMA1SCNT_ISR when a block has been sent.
+
+Requires:
+- DMA1SCNTIF has been cleared
+
+Promises:
+- The sent block is released from the ring
+- The next block, if any, is started
+
+*/
+void UartDmaDone(void)
+{
+  Uart_u8Tail += (u8)Uart_u16Sending;
+  UartStartDma();
+
+} /* end UartDmaDone() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void UartStartDma(void)
+
+@brief Hands the DMA the next contiguous block of the ring.
+
+Requires:
+- No block under way
+- DMA1SCNT_ISR can't run: called from it or with GIEL clear
+
+Promises:
+- Uart_u16Sending is the length of the block started, or 0 if the ring is
+  empty
+
+*/
+static void UartStartDma(void)
+{
+  u8 u8Head = Uart_u8Head;
+  u8 u8Tail = Uart_u8Tail;
+
+  if(u8Head == u8Tail)
+  {
+    Uart_u16Sending = 0;
+    return;
+  }
+
+  /* Up to the newest byte, or the end of the ring if the data wraps */
+  Uart_u16Sending = (u8Head > u8Tail) ? (u16)(u8Head - u8Tail) : (UART_RING_SIZE - u8Tail);
+  HAL_UART_DMA_START(&Uart_au8Ring[u8Tail], Uart_u16Sending);
+
+} /* end UartStartDma() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File */
+/*--------------------------------------------------------------------------------------------------------------------*/
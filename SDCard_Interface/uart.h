@@ -0,0 +1,49 @@
+/*!*********************************************************************************************************************
+@file uart.h
+@brief Header file for the UART1 driver (DMA transmit from a ring buffer)
+
+**********************************************************************************************************************/
+
+#ifndef __UART_H
+#define __UART_H
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+bool UartWrite(const u8* pu8Data_, u8 u8Length_);
+u8   UartFree(void);
+bool UartIsIdle(void);
+bool UartRead(u8* pu8Byte_);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+void UartInitialize(void);
+void UartDmaDone(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+/* 115200 baud with BRGS = 1: Fosc / (4 * (U1BRG + 1)).  Clock_astOpPoints[] loads the one for each operating point. */
+#define UART_BRG_16MHZ            (u16)34              /*!< @brief 114286 baud, -0.8% */
+#define UART_BRG_64MHZ            (u16)138             /*!< @brief 115108 baud, -0.1% */
+
+#define UART_RING_SIZE            (u16)256             /*!< @brief Must be 256: the u8 indices wrap by themselves */
+
+
+#endif /* __UART_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,483 @@
+/*!*********************************************************************************************************************
+@file us_timer.c                                                                
+@brief Queue of microsecond one-shot events driven by Timer0.
+
+TMR0_ISR is low priority, so the functions here only mask GIEL and the audio
+sample ISR can still run while the queue is being changed.  That ISR reads the
+time with UsTimerNowFromHighIsr(), so it must never see the epoch and TMR0 
+half-updated or re-latch TMR0H under a read: changes to the epoch and TMR0 are
+bracketed by a sequence count, odd while they are under way, and low priority
+reads of TMR0 are retried if a high priority read came in between.
+
+This replaces the single-shot TimeXus() and its TMR0IF polling.  Timer0 runs
+all the time at 1us per tick in 16-bit mode.  Time is kept as an epoch (the 
+UsTimerNow() value when TMR0 read 0) plus the live TMR0 count, so UsTimerNow()
+is a 32-bit microsecond clock that wraps every 71 minutes.
+
+Pending events are kept in a list sorted by absolute deadline.  When the first
+deadline is less than one Timer0 period away, TMR0 is loaded so it overflows 
+exactly at that deadline, and the epoch is moved to match.  The new count is 
+computed from a fresh read of TMR0, plus US_TIMER_REARM_TICKS for the time 
+the read-modify-write takes, so ISR latency doesn't accumulate.  With no event
+that close Timer0 just wraps every 65.536ms and the ISR moves the epoch on.
+
+Because deadlines are absolute, a periodic event that re-arms itself with
+UsTimerStartAt(pstEvent, pstEvent->u32DeadlineUs + period) does not drift.
+
+------------------------------------------------------------------------------------------------------------------------
+GLOBALS
+- G_u16UsTimerLateMaxUs
+
+CONSTANTS
+- US_TIMER_MAX_DELAY_US
+- US_TIMER_REARM_TICKS
+
+TYPES
+- UsTimerCallbackType
+- UsTimerEventType
+
+PUBLIC FUNCTIONS
+- void UsTimerSetup(UsTimerEventType* pstEvent_, UsTimerCallbackType pfnCallback_, u16 u16Param_)
+- void UsTimerStart(UsTimerEventType* pstEvent_, u32 u32DelayUs_)
+- void UsTimerStartAt(UsTimerEventType* pstEvent_, u32 u32DeadlineUs_)
+- void UsTimerStop(UsTimerEventType* pstEvent_)
+- u32 UsTimerNow(void)
+- u32 UsTimerNowFromHighIsr(void)
+
+PROTECTED FUNCTIONS
+- void UsTimerInitialize(void)
+- void UsTimerOverflow(void)
+
+
+**********************************************************************************************************************/
+
+#include "configuration.h"
+
+/***********************************************************************************************************************
+Global variable definitions with scope across entire project.
+All Global variable names shall start with "G_<type>UsTimer"
+***********************************************************************************************************************/
+/* New variables */
+volatile u16 G_u16UsTimerLateMaxUs;                       /*!< @brief Worst lateness of any call-back seen so far */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* Existing variables (defined in other files -- should all contain the "extern" keyword) */
+
+
+/***********************************************************************************************************************
+Global variable definitions with scope limited to this local application.
+Variable names shall start with "UsTimer_<type>" and be declared as static.
+***********************************************************************************************************************/
+static UsTimerEventType* volatile UsTimer_pstHead;        /*!< @brief Earliest pending event */
+static volatile u32 UsTimer_u32Epoch;                     /*!< @brief UsTimerNow() value when TMR0 was 0 */
+static bool UsTimer_bServicing;                           /*!< @brief true while UsTimerService() is running call-backs */
+static volatile u8 UsTimer_u8Sequence;                    /*!< @brief Odd while the epoch and TMR0 are being changed */
+static volatile u32 UsTimer_u32Frozen;                    /*!< @brief The time as the current change started */
+static volatile u8 UsTimer_u8HighReads;                   /*!< @brief Counts TMR0 reads by UsTimerNowFromHighIsr() */
+
+static u32  UsTimerRead(void);
+static void UsTimerService(void);
+
+
+/**********************************************************************************************************************
+Function Definitions
+**********************************************************************************************************************/
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UsTimerSetup(UsTimerEventType* pstEvent_, UsTimerCallbackType pfnCallback_, u16 u16Param_)
+
+@brief Prepares an event before its first use.
+
+Requires:
+- pstEvent_ is not queued (or has never been set up)
+
+Promises:
+- The event is idle and will call pfnCallback_(u16Param_) from TMR0_ISR 
+  when it comes due
+
+*/
+void UsTimerSetup(UsTimerEventType* pstEvent_, UsTimerCallbackType pfnCallback_, u16 u16Param_)
+{
+  pstEvent_->pstNext     = NULL;
+  pstEvent_->pfnCallback = pfnCallback_;
+  pstEvent_->u16Param    = u16Param_;
+  pstEvent_->bQueued     = false;
+  
+} /* end UsTimerSetup() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UsTimerStart(UsTimerEventType* pstEvent_, u32 u32DelayUs_)
+
+@brief Queues an event u32DelayUs_ microseconds from now.
+
+Requires:
+- pstEvent_ set up with UsTimerSetup
+
+Promises:
+- Same as UsTimerStartAt(pstEvent_, UsTimerNow() + u32DelayUs_), with the
+  delay capped at US_TIMER_MAX_DELAY_US
+
+*/
+void UsTimerStart(UsTimerEventType* pstEvent_, u32 u32DelayUs_)
+{
+  if(u32DelayUs_ > US_TIMER_MAX_DELAY_US)
+  {
+    u32DelayUs_ = US_TIMER_MAX_DELAY_US;
+  }
+  
+  UsTimerStartAt(pstEvent_, UsTimerNow() + u32DelayUs_);
+  
+} /* end UsTimerStart() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UsTimerStartAt(UsTimerEventType* pstEvent_, u32 u32DeadlineUs_)
+
+@brief Queues an event for an absolute UsTimerNow() time.
+
+May be called from the event's own call-back to make a periodic event.
+
+Requires:
+- pstEvent_ set up with UsTimerSetup
+- u32DeadlineUs_ is less than US_TIMER_MAX_DELAY_US ahead of now
+
+Promises:
+- If the event was queued it is first removed
+- The event is inserted in deadline order after any event with the same 
+  deadline, and Timer0 re-armed if it is now first
+- A deadline that has already passed runs the call-back immediately
+
+*/
+void UsTimerStartAt(UsTimerEventType* pstEvent_, u32 u32DeadlineUs_)
+{
+  UsTimerEventType* volatile* ppstLink;
+  u8 u8GieSave = INTCON0bits.GIEL;
+  
+  INTCON0bits.GIEL = 0;
+  
+  UsTimerStop(pstEvent_);
+  pstEvent_->u32DeadlineUs = u32DeadlineUs_;
+  pstEvent_->bQueued = true;
+  
+  /* Walk to the first event that is due later than this one */
+  ppstLink = &UsTimer_pstHead;
+  while( (*ppstLink != NULL) && 
+         ((s32)((*ppstLink)->u32DeadlineUs - u32DeadlineUs_) <= 0) )
+  {
+    ppstLink = &((*ppstLink)->pstNext);
+  }
+  
+  pstEvent_->pstNext = *ppstLink;
+  *ppstLink = pstEvent_;
+  
+  /* From a call-back the service loop is already running and will see the 
+  new head itself (the compiler does not allow recursion) */
+  if( (UsTimer_pstHead == pstEvent_) && !UsTimer_bServicing )
+  {
+    UsTimerService();
+  }
+  
+  INTCON0bits.GIEL = u8GieSave;
+  
+} /* end UsTimerStartAt() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UsTimerStop(UsTimerEventType* pstEvent_)
+
+@brief Removes an event from the queue so its call-back does not run.
+
+Requires:
+- pstEvent_ set up with UsTimerSetup
+
+Promises:
+- The event is idle; stopping an idle event does nothing
+- Timer0 is left as it is: if the event was first, the next overflow simply
+  finds nothing due and arms the following event
+
+*/
+void UsTimerStop(UsTimerEventType* pstEvent_)
+{
+  UsTimerEventType* volatile* ppstLink;
+  u8 u8GieSave = INTCON0bits.GIEL;
+  
+  INTCON0bits.GIEL = 0;
+  
+  if(pstEvent_->bQueued)
+  {
+    ppstLink = &UsTimer_pstHead;
+    while( (*ppstLink != NULL) && (*ppstLink != pstEvent_) )
+    {
+      ppstLink = &((*ppstLink)->pstNext);
+    }
+    
+    if(*ppstLink == pstEvent_)
+    {
+      *ppstLink = pstEvent_->pstNext;
+    }
+    
+    pstEvent_->pstNext = NULL;
+    pstEvent_->bQueued = false;
+  }
+  
+  INTCON0bits.GIEL = u8GieSave;
+  
+} /* end UsTimerStop() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u32 UsTimerNow(void)
+
+@brief Returns the current time in microseconds.
+
+Requires:
+- UsTimerInitialize has been called
+
+Promises:
+- Returns the 32-bit microsecond count (wraps every 2^32 us); safe from the
+  main loop and low priority ISRs (TMR1_ISR uses UsTimerNowFromHighIsr)
+
+*/
+u32 UsTimerNow(void)
+{
+  u32 u32Now;
+  u8 u8GieSave = INTCON0bits.GIEL;
+  
+  INTCON0bits.GIEL = 0;
+  u32Now = UsTimerRead();
+  INTCON0bits.GIEL = u8GieSave;
+  
+  return u32Now;
+  
+} /* end UsTimerNow() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn u32 UsTimerNowFromHighIsr(void)
+
+@brief Returns the current time in microseconds without touching GIEL.
+
+TMR1_ISR can't wait for the code it interrupted, so while the epoch and TMR0 
+are being changed it gets the time from just before the change instead.
+
+Requires:
+- Called only from high priority interrupt context
+- UsTimerInitialize has been called
+
+Promises:
+- Returns the same clock as UsTimerNow(), or up to a few microseconds behind
+  it if TMR0 was being re-armed or its overflow handled
+
+*/
+u32 UsTimerNowFromHighIsr(void)
+{
+  if(UsTimer_u8Sequence & 0x01)
+  {
+    return UsTimer_u32Frozen;
+  }
+  
+  /* Tell any interrupted UsTimerRead() that TMR0H has been re-latched */
+  UsTimer_u8HighReads++;
+  return UsTimerRead();
+  
+} /* end UsTimerNowFromHighIsr() */
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UsTimerInitialize(void)
+
+@brief Starts Timer0 as the free-running microsecond counter with an empty queue.
+
+Should only be called once in main init section.
+
+Requires:
+- Fosc is 64MHz, the reset operating point, and ClockInitialize has not 
+  run yet
+
+Promises:
+- Timer0: enabled, 16-bit, Fosc/4, async, 1:1 postscaler and the 1:16 
+  prescaler of CLOCK_OP_64MHZ, so one tick is 1us.  From then on clock.c
+  owns the prescaler and rescales it at each operating point change (1:4 at
+  16MHz) to keep the 1us tick.
+- TMR0 cleared, TMR0IF cleared and the interrupt enabled
+- Queue empty and UsTimerNow() starts from 0
+
+*/
+void UsTimerInitialize(void)
+{
+  UsTimer_pstHead = NULL;
+  UsTimer_u32Epoch = 0;
+  UsTimer_bServicing = false;
+  UsTimer_u8Sequence = 0;
+  UsTimer_u8HighReads = 0;
+  G_u16UsTimerLateMaxUs = 0;
+  
+  T0CON0 = 0x10; // b'00010000' 16-bit, off while configuring
+  T0CON1 = 0x54; // b'01010100'
+  TMR0H = 0;
+  TMR0L = 0;
+  
+  PIR3bits.TMR0IF = 0;
+  PIE3bits.TMR0IE = 1;
+  T0CON0bits.EN = 1;
+  
+} /* end UsTimerInitialize() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn void UsTimerOverflow(void)
+
+@brief Called by TMR0_ISR each time Timer0 overflows.
+
+Requires:
+- TMR0IF is set
+
+Promises:
+- TMR0IF is cleared and the epoch moves on by one full Timer0 count, as one
+  change to UsTimerNowFromHighIsr(); clearing the flag first means an 
+  overflow during the call-backs is seen
+- Every due event has run and Timer0 is armed for the next one if it is 
+  within one period
+
+*/
+void UsTimerOverflow(void)
+{
+  /* The flag is still set, so the read already counts this wrap */
+  UsTimer_u32Frozen = UsTimerRead();
+  UsTimer_u8Sequence++;
+  PIR3bits.TMR0IF = 0;
+  UsTimer_u32Epoch += 0x10000;
+  UsTimer_u8Sequence++;
+  
+  UsTimerService();
+  
+} /* end UsTimerOverflow() */
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static u32 UsTimerRead(void)
+
+@brief Reads the epoch plus TMR0, allowing for an overflow that the ISR has
+not handled yet.
+
+Requires:
+- GIEL is off (or running in an ISR)
+- In TMR1_ISR, UsTimer_u8Sequence is even
+
+Promises:
+- Returns the current microsecond time
+
+*/
+static u32 UsTimerRead(void)
+{
+  u16 u16Count;
+  u8 u8HighReads;
+  
+  /* TMR0L must be read first: it latches TMR0H.  A read from TMR1_ISR in
+  between latches it again, so read both once more. */
+  do
+  {
+    u8HighReads = UsTimer_u8HighReads;
+    u16Count  = TMR0L;
+    u16Count |= (u16)TMR0H << 8;
+  } while(u8HighReads != UsTimer_u8HighReads);
+  
+  /* A small count with the flag set means the wrap happened but the epoch
+  has not been moved yet */
+  if( PIR3bits.TMR0IF && (u16Count < 0x8000) )
+  {
+    return UsTimer_u32Epoch + 0x10000 + u16Count;
+  }
+  
+  return UsTimer_u32Epoch + u16Count;
+  
+} /* end UsTimerRead() */
+
+
+/*!--------------------------------------------------------------------------------------------------------------------
+@fn static void UsTimerService(void)
+
+@brief Runs every event that is due and arms Timer0 for the next one.
+
+Requires:
+- GIEL is off (or running in TMR0_ISR)
+
+Promises:
+- Events within US_TIMER_REARM_TICKS of their deadline are run now, since 
+  they would be due before Timer0 could be loaded
+- If the new first event is due within one Timer0 period, TMR0 is loaded to
+  overflow at its deadline, the epoch moved to match and TMR0IF cleared, as
+  one change to UsTimerNowFromHighIsr()
+
+*/
+static void UsTimerService(void)
+{
+  UsTimerEventType* pstEvent;
+  u32 u32Now;
+  s32 s32Remaining;
+  u16 u16Count;
+  
+  UsTimer_bServicing = true;
+  
+  while(UsTimer_pstHead != NULL)
+  {
+    u32Now = UsTimerRead();
+    s32Remaining = (s32)(UsTimer_pstHead->u32DeadlineUs - u32Now);
+    
+    if(s32Remaining > (s32)US_TIMER_REARM_TICKS)
+    {
+      if(s32Remaining < 0x10000)
+      {
+        /* Load TMR0 so it overflows at the deadline.  The count is based on the
+        read above, so time spent since the overflow (ISR latency) is kept. */
+        u16Count = (u16)(0x10000 - (u32)s32Remaining + US_TIMER_REARM_TICKS);
+        UsTimer_u32Frozen = u32Now;
+        UsTimer_u8Sequence++;
+        TMR0H = (u8)(u16Count >> 8);
+        TMR0L = (u8)(u16Count & 0x00FF);
+        PIR3bits.TMR0IF = 0;
+        UsTimer_u32Epoch = UsTimer_pstHead->u32DeadlineUs - 0x10000;
+        UsTimer_u8Sequence++;
+      }
+      
+      break;
+    }
+    
+    /* Due (or nearly): unlink before the call-back so it can re-queue itself */
+    pstEvent = UsTimer_pstHead;
+    UsTimer_pstHead = pstEvent->pstNext;
+    pstEvent->pstNext = NULL;
+    pstEvent->bQueued = false;
+    
+    if( (s32Remaining < 0) && ((u32)(-s32Remaining) > G_u16UsTimerLateMaxUs) )
+    {
+      G_u16UsTimerLateMaxUs = ((u32)(-s32Remaining) > 0xFFFF) ? 0xFFFF : (u16)(-s32Remaining);
+    }
+    
+    pstEvent->pfnCallback(pstEvent->u16Param);
+  }
+  
+  UsTimer_bServicing = false;
+  
+} /* end UsTimerService() */
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,81 @@
+/*!*********************************************************************************************************************
+@file us_timer.h                                                                
+@brief Header file for the microsecond one-shot event queue on Timer0
+
+**********************************************************************************************************************/
+
+#ifndef __US_TIMER_H
+#define __US_TIMER_H
+
+/**********************************************************************************************************************
+Type Definitions
+**********************************************************************************************************************/
+
+struct UsTimerEvent;
+
+/*! @brief Event call-back; runs in TMR0_ISR and receives the u16Param given to UsTimerSetup */
+typedef void (*UsTimerCallbackType)(u16 u16Param_);
+
+/*! 
+@struct UsTimerEventType
+@brief One pending microsecond event.  Owned by the caller, usually static.
+*/
+typedef struct UsTimerEvent
+{
+  struct UsTimerEvent* pstNext;       /*!< @brief Next event in deadline order */
+  u32 u32DeadlineUs;                  /*!< @brief UsTimerNow() value the event is due at */
+  UsTimerCallbackType pfnCallback;    /*!< @brief Called from TMR0_ISR; KEEP IT SHORT */
+  u16 u16Param;                       /*!< @brief Passed to pfnCallback */
+  bool bQueued;                       /*!< @brief true while the event is waiting in the queue */
+} UsTimerEventType;
+
+
+/**********************************************************************************************************************
+Function Declarations
+**********************************************************************************************************************/
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @publicsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void UsTimerSetup(UsTimerEventType* pstEvent_, UsTimerCallbackType pfnCallback_, u16 u16Param_);
+void UsTimerStart(UsTimerEventType* pstEvent_, u32 u32DelayUs_);
+void UsTimerStartAt(UsTimerEventType* pstEvent_, u32 u32DeadlineUs_);
+void UsTimerStop(UsTimerEventType* pstEvent_);
+u32  UsTimerNow(void);
+u32  UsTimerNowFromHighIsr(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @protectedsection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+void UsTimerInitialize(void);
+void UsTimerOverflow(void);
+
+
+/*------------------------------------------------------------------------------------------------------------------*/
+/*! @privatesection */                                                                                            
+/*--------------------------------------------------------------------------------------------------------------------*/
+
+
+
+/**********************************************************************************************************************
+Constants / Definitions
+**********************************************************************************************************************/
+#define US_TIMER_MAX_DELAY_US     (u32)0x7FFFFFFF      /*!< @brief Deadlines are compared as signed differences */
+
+/*! @brief Timer0 ticks (1us) that pass between reading TMR0 and writing the new 
+count when the next event is armed.  Added to the written value so the
+reload time doesn't push every event late.  Code takes no virtual time in
+the host build, so there nothing passes and anything added would run
+UsTimerNow() ahead at every re-arm. */
+#ifndef HOST_BUILD
+#define US_TIMER_REARM_TICKS      (u8)2
+#else
+#define US_TIMER_REARM_TICKS      (u8)0
+#endif
+
+
+#endif /* __US_TIMER_H */
+/*--------------------------------------------------------------------------------------------------------------------*/
+/* End of File                                                                                                        */
+/*--------------------------------------------------------------------------------------------------------------------*/
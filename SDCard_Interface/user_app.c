@@ -31,8 +31,6 @@ All Global variable names shall start with "G_<type>UserApp"
 ***********************************************************************************************************************/
 /* New variables */
 volatile u8 G_u8UserAppFlags;                  /*!< @brief Global state flags */
-volatile u8 G_u8UserAppTimePeriodHi;           /*!< @brief Global saved Timer1 high count for ISR */
-volatile u8 G_u8UserAppTimePeriodLo;           /*!< @brief Global saved Timer1 low count for ISR */
 
 u8 G_au8UserAppsinTable[] = 
 {
@@ -76,49 +74,6 @@ Function Definitions
 /*! @publicsection */                                                                                            
 /*--------------------------------------------------------------------------------------------------------------------*/
 
-/*!--------------------------------------------------------------------------------------------------------------------
-@fn void TimeXus(u16 u16TimeXus_)
-
-@brief
-Sets up Timer0 to provide an interrupt at u16Microseconds_
-
-Requires:
-- Timer0 configured such that each timer tick is 1 microsecond
-
-Promises:
-- Pre-loads TMR0H:L to clock out desired period
-- TMR0IF cleared
-- Timer0 enabled
-
-*/
-void TimeXus(u16 u16TimeXus_)
-{
-  u16 u16Temp = 65535;
-
-#if 0  
-  /* Handle edge case */
-  if(u16TimeXus_ == 0)
-  {
-      PIR3bits.TMR0IF = 1;
-      return;
-  }
-#endif
-  
-  /* Disable the timer during config */
-  T0CON0bits.EN = 0;
-  
-  /* Preload TMR0H and TMR0L based on u16TimeXus */
-  u16Temp -= u16TimeXus_;
-  TMR0H = (u8)( (u16Temp >> 8) & 0x00FF);
-  TMR0L = (u8)( u16Temp & 0x00FF);
-   
-  /* Clear TMR0IF and enable Timer 0 */
-  PIR3bits.TMR0IF = 0;
-  T0CON0bits.EN = 1;
-  
-} /* end TimeXus() */
-
-
 /*!--------------------------------------------------------------------------------------------------------------------
 @fn void InterruptTimerXus(u16 u16TimeXus_, bool bContinuous_)
 
@@ -126,58 +81,21 @@ void TimeXus(u16 u16TimeXus_)
 Maximum 32,767us.  Arguments higher than this will be capped back.
 Sets up Timer1 to provide an interrupt every u16TimeXus_ microseconds.
 This can be configured as a single event, or continuous.
-Note: it would be much better to pass a call-back function
-parameter to this function to register the call-back for the ISR
-to use, but we'll hard-code it for now.
+Kept for the existing activities; new code should call TimerStart() directly.
 
 Requires:
-- Timer1 configured such that each timer tick is 0.5 microseconds
-- TMR1_ISR holds code to respond to the interrupt
+- TimerInitialize has been called
+- Call-back registered with TimerSetCallback(TIMER_1, ...)
 - bContinuous_ is true if the timer should run continuously;
   false if it should run once and stop.
 
 Promises:
-- Pre-loads TMR1H:L to clock out desired period
-- G_u8UserAppTimePeriodHi/Lo updated to save period
-- _U8_CONTINUOUS updated per bContinuous_
-- TMR1IF cleared and interrupt enabled
-- Timer1 enabled
+- Timer1 started through TimerStart() in the matching mode
 
 */
 void InterruptTimerXus(u16 u16TimeXus_, bool bContinuous_)
 {
-  u16 u16Temp;
-
-  /* Disable the timer during config */
-  T1CONbits.ON = 0;
-  
-  /* Correct the input parameter if it's too high */
-  if(u16TimeXus_ > 32767)
-  {
-    u16TimeXus_ = 32767;
-  }
-
-  /* Double the time so it's in us not 0.5us*/
-  u16Temp = u16TimeXus_ << 1;
-   
-  /* Calculate, save, and preload TMR1H and TMR1L based on u16TimeXus_ */
-  u16Temp = 65535 - u16Temp;
-  G_u8UserAppTimePeriodHi = (u8)( (u16Temp >> 8) & 0x00FF);
-  G_u8UserAppTimePeriodLo = (u8)( u16Temp & 0x00FF);
-  TMR1H = G_u8UserAppTimePeriodHi;
-  TMR1L = G_u8UserAppTimePeriodLo;
-  
-  /* Flag continuous mode if required */
-  G_u8UserAppFlags &= ~_U8_CONTINUOUS;
-  if(bContinuous_)
-  {
-    G_u8UserAppFlags |= _U8_CONTINUOUS;
-  }
-  
-  /* Clear the interrupt flag, enable interrupt and enable Timer */
-  PIR3bits.TMR1IF = 0;
-  PIE3bits.TMR1IE = 1;
-  T1CONbits.ON = 1;
+  TimerStart(TIMER_1, u16TimeXus_, bContinuous_ ? TIMER_CONTINUOUS : TIMER_ONE_SHOT);
   
 } /* end InterruptTimerXus() */
 
@@ -206,17 +124,6 @@ void UserAppInitialize(void)
     /* LED initialization */
     LATA &= 0xC0;
     
-    /* Timer0 control register initialization to turn timer on, asynch mode, 16-bit
-     * Fosc/4, 1:16 prescaler, 1:1 postscaler  */
-    T0CON0 = 0x90; // b'10010000'
-    T0CON1 = 0x54; // b'01010100'
-    
-    /* Timer1 initialization:
-     * 1:8 prescale, synced, enabled */
-    T1GCON = 0x00;
-    T1CLK  = 0x01;  
-    T1CON  = 0x31;  // b'00110001'
-    
 } /* end UserAppInitialize() */
 
   
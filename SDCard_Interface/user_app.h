@@ -19,7 +19,7 @@ Function Declarations
 /*------------------------------------------------------------------------------------------------------------------*/
 /*! @publicsection */                                                                                            
 /*--------------------------------------------------------------------------------------------------------------------*/
-void TimeXus(u16 u16TimeXus_);
+void InterruptTimerXus(u16 u16TimeXus_, bool bContinuous_);
 
 
 /*------------------------------------------------------------------------------------------------------------------*/
@@ -39,7 +39,6 @@ void UserAppRun(void);
 Constants / Definitions
 **********************************************************************************************************************/
 /* G_u8UserAppFlags */
-#define _U8_CONTINUOUS     (u8)0x01      /* Set to run Timer 1 continously */
 /* endvG_u8UserAppFlags */
 
 
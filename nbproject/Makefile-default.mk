@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=../../../Desktop/ProjectTemplate/encm369_pic18.c ../../../Desktop/ProjectTemplate/main.c ../../../Desktop/ProjectTemplate/user_app.c
+SOURCEFILES_QUOTED_IF_SPACED=SDCard_Interface/adpcm.c SDCard_Interface/audio.c SDCard_Interface/clock.c SDCard_Interface/crc.c SDCard_Interface/defer.c SDCard_Interface/encm369_pic18.c SDCard_Interface/event_queue.c SDCard_Interface/interrupts.c SDCard_Interface/isr_profile.c SDCard_Interface/loop_stats.c SDCard_Interface/main.c SDCard_Interface/region_profile.c SDCard_Interface/scheduler.c SDCard_Interface/sd.c SDCard_Interface/sd_cache.c SDCard_Interface/spi.c SDCard_Interface/stack_guard.c SDCard_Interface/telemetry.c SDCard_Interface/time_base.c SDCard_Interface/timer.c SDCard_Interface/timer_wheel.c SDCard_Interface/trace.c SDCard_Interface/uart.c SDCard_Interface/us_timer.c SDCard_Interface/user_app.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1 ${OBJECTDIR}/_ext/1404574511/main.p1 ${OBJECTDIR}/_ext/1404574511/user_app.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1.d ${OBJECTDIR}/_ext/1404574511/main.p1.d ${OBJECTDIR}/_ext/1404574511/user_app.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/SDCard_Interface/adpcm.p1 ${OBJECTDIR}/SDCard_Interface/audio.p1 ${OBJECTDIR}/SDCard_Interface/clock.p1 ${OBJECTDIR}/SDCard_Interface/crc.p1 ${OBJECTDIR}/SDCard_Interface/defer.p1 ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1 ${OBJECTDIR}/SDCard_Interface/event_queue.p1 ${OBJECTDIR}/SDCard_Interface/interrupts.p1 ${OBJECTDIR}/SDCard_Interface/isr_profile.p1 ${OBJECTDIR}/SDCard_Interface/loop_stats.p1 ${OBJECTDIR}/SDCard_Interface/main.p1 ${OBJECTDIR}/SDCard_Interface/region_profile.p1 ${OBJECTDIR}/SDCard_Interface/scheduler.p1 ${OBJECTDIR}/SDCard_Interface/sd.p1 ${OBJECTDIR}/SDCard_Interface/sd_cache.p1 ${OBJECTDIR}/SDCard_Interface/spi.p1 ${OBJECTDIR}/SDCard_Interface/stack_guard.p1 ${OBJECTDIR}/SDCard_Interface/telemetry.p1 ${OBJECTDIR}/SDCard_Interface/time_base.p1 ${OBJECTDIR}/SDCard_Interface/timer.p1 ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1 ${OBJECTDIR}/SDCard_Interface/trace.p1 ${OBJECTDIR}/SDCard_Interface/uart.p1 ${OBJECTDIR}/SDCard_Interface/us_timer.p1 ${OBJECTDIR}/SDCard_Interface/user_app.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/SDCard_Interface/adpcm.p1.d ${OBJECTDIR}/SDCard_Interface/audio.p1.d ${OBJECTDIR}/SDCard_Interface/clock.p1.d ${OBJECTDIR}/SDCard_Interface/crc.p1.d ${OBJECTDIR}/SDCard_Interface/defer.p1.d ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1.d ${OBJECTDIR}/SDCard_Interface/event_queue.p1.d ${OBJECTDIR}/SDCard_Interface/interrupts.p1.d ${OBJECTDIR}/SDCard_Interface/isr_profile.p1.d ${OBJECTDIR}/SDCard_Interface/loop_stats.p1.d ${OBJECTDIR}/SDCard_Interface/main.p1.d ${OBJECTDIR}/SDCard_Interface/region_profile.p1.d ${OBJECTDIR}/SDCard_Interface/scheduler.p1.d ${OBJECTDIR}/SDCard_Interface/sd.p1.d ${OBJECTDIR}/SDCard_Interface/sd_cache.p1.d ${OBJECTDIR}/SDCard_Interface/spi.p1.d ${OBJECTDIR}/SDCard_Interface/stack_guard.p1.d ${OBJECTDIR}/SDCard_Interface/telemetry.p1.d ${OBJECTDIR}/SDCard_Interface/time_base.p1.d ${OBJECTDIR}/SDCard_Interface/timer.p1.d ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1.d ${OBJECTDIR}/SDCard_Interface/trace.p1.d ${OBJECTDIR}/SDCard_Interface/uart.p1.d ${OBJECTDIR}/SDCard_Interface/us_timer.p1.d ${OBJECTDIR}/SDCard_Interface/user_app.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1 ${OBJECTDIR}/_ext/1404574511/main.p1 ${OBJECTDIR}/_ext/1404574511/user_app.p1
+OBJECTFILES=${OBJECTDIR}/SDCard_Interface/adpcm.p1 ${OBJECTDIR}/SDCard_Interface/audio.p1 ${OBJECTDIR}/SDCard_Interface/clock.p1 ${OBJECTDIR}/SDCard_Interface/crc.p1 ${OBJECTDIR}/SDCard_Interface/defer.p1 ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1 ${OBJECTDIR}/SDCard_Interface/event_queue.p1 ${OBJECTDIR}/SDCard_Interface/interrupts.p1 ${OBJECTDIR}/SDCard_Interface/isr_profile.p1 ${OBJECTDIR}/SDCard_Interface/loop_stats.p1 ${OBJECTDIR}/SDCard_Interface/main.p1 ${OBJECTDIR}/SDCard_Interface/region_profile.p1 ${OBJECTDIR}/SDCard_Interface/scheduler.p1 ${OBJECTDIR}/SDCard_Interface/sd.p1 ${OBJECTDIR}/SDCard_Interface/sd_cache.p1 ${OBJECTDIR}/SDCard_Interface/spi.p1 ${OBJECTDIR}/SDCard_Interface/stack_guard.p1 ${OBJECTDIR}/SDCard_Interface/telemetry.p1 ${OBJECTDIR}/SDCard_Interface/time_base.p1 ${OBJECTDIR}/SDCard_Interface/timer.p1 ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1 ${OBJECTDIR}/SDCard_Interface/trace.p1 ${OBJECTDIR}/SDCard_Interface/uart.p1 ${OBJECTDIR}/SDCard_Interface/us_timer.p1 ${OBJECTDIR}/SDCard_Interface/user_app.p1
 
 # Source Files
-SOURCEFILES=../../../Desktop/ProjectTemplate/encm369_pic18.c ../../../Desktop/ProjectTemplate/main.c ../../../Desktop/ProjectTemplate/user_app.c
+SOURCEFILES=SDCard_Interface/adpcm.c SDCard_Interface/audio.c SDCard_Interface/clock.c SDCard_Interface/crc.c SDCard_Interface/defer.c SDCard_Interface/encm369_pic18.c SDCard_Interface/event_queue.c SDCard_Interface/interrupts.c SDCard_Interface/isr_profile.c SDCard_Interface/loop_stats.c SDCard_Interface/main.c SDCard_Interface/region_profile.c SDCard_Interface/scheduler.c SDCard_Interface/sd.c SDCard_Interface/sd_cache.c SDCard_Interface/spi.c SDCard_Interface/stack_guard.c SDCard_Interface/telemetry.c SDCard_Interface/time_base.c SDCard_Interface/timer.c SDCard_Interface/timer_wheel.c SDCard_Interface/trace.c SDCard_Interface/uart.c SDCard_Interface/us_timer.c SDCard_Interface/user_app.c
 
 
 
@@ -94,54 +94,406 @@ MP_PROCESSOR_OPTION=18F27Q43
 # ------------------------------------------------------------------------------------
 # Rules for buildStep: compile
 ifeq ($(TYPE_IMAGE), DEBUG_RUN)
-${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1: ../../../Desktop/ProjectTemplate/encm369_pic18.c  nbproject/Makefile-${CND_CONF}.mk 
-	@${MKDIR} "${OBJECTDIR}/_ext/1404574511" 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1.d 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1 ../../../Desktop/ProjectTemplate/encm369_pic18.c 
-	@-${MV} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.d ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
-	
-${OBJECTDIR}/_ext/1404574511/main.p1: ../../../Desktop/ProjectTemplate/main.c  nbproject/Makefile-${CND_CONF}.mk 
-	@${MKDIR} "${OBJECTDIR}/_ext/1404574511" 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/main.p1.d 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/main.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/_ext/1404574511/main.p1 ../../../Desktop/ProjectTemplate/main.c 
-	@-${MV} ${OBJECTDIR}/_ext/1404574511/main.d ${OBJECTDIR}/_ext/1404574511/main.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/_ext/1404574511/main.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
-	
-${OBJECTDIR}/_ext/1404574511/user_app.p1: ../../../Desktop/ProjectTemplate/user_app.c  nbproject/Makefile-${CND_CONF}.mk 
-	@${MKDIR} "${OBJECTDIR}/_ext/1404574511" 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/user_app.p1.d 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/user_app.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/_ext/1404574511/user_app.p1 ../../../Desktop/ProjectTemplate/user_app.c 
-	@-${MV} ${OBJECTDIR}/_ext/1404574511/user_app.d ${OBJECTDIR}/_ext/1404574511/user_app.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/_ext/1404574511/user_app.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+${OBJECTDIR}/SDCard_Interface/adpcm.p1: SDCard_Interface/adpcm.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/adpcm.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/adpcm.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/adpcm.p1 SDCard_Interface/adpcm.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/adpcm.d ${OBJECTDIR}/SDCard_Interface/adpcm.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/adpcm.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/audio.p1: SDCard_Interface/audio.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/audio.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/audio.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/audio.p1 SDCard_Interface/audio.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/audio.d ${OBJECTDIR}/SDCard_Interface/audio.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/audio.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/clock.p1: SDCard_Interface/clock.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/clock.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/clock.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/clock.p1 SDCard_Interface/clock.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/clock.d ${OBJECTDIR}/SDCard_Interface/clock.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/clock.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/crc.p1: SDCard_Interface/crc.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/crc.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/crc.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/crc.p1 SDCard_Interface/crc.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/crc.d ${OBJECTDIR}/SDCard_Interface/crc.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/crc.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/defer.p1: SDCard_Interface/defer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/defer.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/defer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/defer.p1 SDCard_Interface/defer.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/defer.d ${OBJECTDIR}/SDCard_Interface/defer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/defer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1: SDCard_Interface/encm369_pic18.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1 SDCard_Interface/encm369_pic18.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.d ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/event_queue.p1: SDCard_Interface/event_queue.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/event_queue.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/event_queue.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/event_queue.p1 SDCard_Interface/event_queue.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/event_queue.d ${OBJECTDIR}/SDCard_Interface/event_queue.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/event_queue.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/interrupts.p1: SDCard_Interface/interrupts.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/interrupts.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/interrupts.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/interrupts.p1 SDCard_Interface/interrupts.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/interrupts.d ${OBJECTDIR}/SDCard_Interface/interrupts.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/interrupts.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/isr_profile.p1: SDCard_Interface/isr_profile.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/isr_profile.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/isr_profile.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/isr_profile.p1 SDCard_Interface/isr_profile.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/isr_profile.d ${OBJECTDIR}/SDCard_Interface/isr_profile.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/isr_profile.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/loop_stats.p1: SDCard_Interface/loop_stats.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/loop_stats.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/loop_stats.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/loop_stats.p1 SDCard_Interface/loop_stats.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/loop_stats.d ${OBJECTDIR}/SDCard_Interface/loop_stats.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/loop_stats.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/main.p1: SDCard_Interface/main.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/main.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/main.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/main.p1 SDCard_Interface/main.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/main.d ${OBJECTDIR}/SDCard_Interface/main.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/main.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/region_profile.p1: SDCard_Interface/region_profile.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/region_profile.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/region_profile.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/region_profile.p1 SDCard_Interface/region_profile.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/region_profile.d ${OBJECTDIR}/SDCard_Interface/region_profile.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/region_profile.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/scheduler.p1: SDCard_Interface/scheduler.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/scheduler.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/scheduler.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/scheduler.p1 SDCard_Interface/scheduler.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/scheduler.d ${OBJECTDIR}/SDCard_Interface/scheduler.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/scheduler.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/sd.p1: SDCard_Interface/sd.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/sd.p1 SDCard_Interface/sd.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/sd.d ${OBJECTDIR}/SDCard_Interface/sd.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/sd.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/sd_cache.p1: SDCard_Interface/sd_cache.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd_cache.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd_cache.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/sd_cache.p1 SDCard_Interface/sd_cache.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/sd_cache.d ${OBJECTDIR}/SDCard_Interface/sd_cache.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/sd_cache.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/spi.p1: SDCard_Interface/spi.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/spi.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/spi.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/spi.p1 SDCard_Interface/spi.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/spi.d ${OBJECTDIR}/SDCard_Interface/spi.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/spi.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/stack_guard.p1: SDCard_Interface/stack_guard.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/stack_guard.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/stack_guard.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/stack_guard.p1 SDCard_Interface/stack_guard.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/stack_guard.d ${OBJECTDIR}/SDCard_Interface/stack_guard.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/stack_guard.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/telemetry.p1: SDCard_Interface/telemetry.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/telemetry.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/telemetry.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/telemetry.p1 SDCard_Interface/telemetry.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/telemetry.d ${OBJECTDIR}/SDCard_Interface/telemetry.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/telemetry.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/time_base.p1: SDCard_Interface/time_base.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/time_base.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/time_base.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/time_base.p1 SDCard_Interface/time_base.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/time_base.d ${OBJECTDIR}/SDCard_Interface/time_base.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/time_base.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/timer.p1: SDCard_Interface/timer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/timer.p1 SDCard_Interface/timer.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/timer.d ${OBJECTDIR}/SDCard_Interface/timer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/timer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/timer_wheel.p1: SDCard_Interface/timer_wheel.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1 SDCard_Interface/timer_wheel.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/timer_wheel.d ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/trace.p1: SDCard_Interface/trace.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/trace.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/trace.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/trace.p1 SDCard_Interface/trace.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/trace.d ${OBJECTDIR}/SDCard_Interface/trace.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/trace.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/uart.p1: SDCard_Interface/uart.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/uart.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/uart.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/uart.p1 SDCard_Interface/uart.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/uart.d ${OBJECTDIR}/SDCard_Interface/uart.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/uart.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/us_timer.p1: SDCard_Interface/us_timer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/us_timer.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/us_timer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/us_timer.p1 SDCard_Interface/us_timer.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/us_timer.d ${OBJECTDIR}/SDCard_Interface/us_timer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/us_timer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/user_app.p1: SDCard_Interface/user_app.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/user_app.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/user_app.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/user_app.p1 SDCard_Interface/user_app.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/user_app.d ${OBJECTDIR}/SDCard_Interface/user_app.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/user_app.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 else
-${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1: ../../../Desktop/ProjectTemplate/encm369_pic18.c  nbproject/Makefile-${CND_CONF}.mk 
-	@${MKDIR} "${OBJECTDIR}/_ext/1404574511" 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1.d 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1 ../../../Desktop/ProjectTemplate/encm369_pic18.c 
-	@-${MV} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.d ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/_ext/1404574511/encm369_pic18.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
-	
-${OBJECTDIR}/_ext/1404574511/main.p1: ../../../Desktop/ProjectTemplate/main.c  nbproject/Makefile-${CND_CONF}.mk 
-	@${MKDIR} "${OBJECTDIR}/_ext/1404574511" 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/main.p1.d 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/main.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/_ext/1404574511/main.p1 ../../../Desktop/ProjectTemplate/main.c 
-	@-${MV} ${OBJECTDIR}/_ext/1404574511/main.d ${OBJECTDIR}/_ext/1404574511/main.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/_ext/1404574511/main.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
-	
-${OBJECTDIR}/_ext/1404574511/user_app.p1: ../../../Desktop/ProjectTemplate/user_app.c  nbproject/Makefile-${CND_CONF}.mk 
-	@${MKDIR} "${OBJECTDIR}/_ext/1404574511" 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/user_app.p1.d 
-	@${RM} ${OBJECTDIR}/_ext/1404574511/user_app.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/_ext/1404574511/user_app.p1 ../../../Desktop/ProjectTemplate/user_app.c 
-	@-${MV} ${OBJECTDIR}/_ext/1404574511/user_app.d ${OBJECTDIR}/_ext/1404574511/user_app.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/_ext/1404574511/user_app.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+${OBJECTDIR}/SDCard_Interface/adpcm.p1: SDCard_Interface/adpcm.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/adpcm.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/adpcm.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/adpcm.p1 SDCard_Interface/adpcm.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/adpcm.d ${OBJECTDIR}/SDCard_Interface/adpcm.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/adpcm.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/audio.p1: SDCard_Interface/audio.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/audio.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/audio.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/audio.p1 SDCard_Interface/audio.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/audio.d ${OBJECTDIR}/SDCard_Interface/audio.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/audio.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/clock.p1: SDCard_Interface/clock.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/clock.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/clock.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/clock.p1 SDCard_Interface/clock.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/clock.d ${OBJECTDIR}/SDCard_Interface/clock.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/clock.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/crc.p1: SDCard_Interface/crc.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/crc.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/crc.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/crc.p1 SDCard_Interface/crc.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/crc.d ${OBJECTDIR}/SDCard_Interface/crc.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/crc.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/defer.p1: SDCard_Interface/defer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/defer.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/defer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/defer.p1 SDCard_Interface/defer.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/defer.d ${OBJECTDIR}/SDCard_Interface/defer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/defer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1: SDCard_Interface/encm369_pic18.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1 SDCard_Interface/encm369_pic18.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.d ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/encm369_pic18.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/event_queue.p1: SDCard_Interface/event_queue.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/event_queue.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/event_queue.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/event_queue.p1 SDCard_Interface/event_queue.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/event_queue.d ${OBJECTDIR}/SDCard_Interface/event_queue.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/event_queue.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/interrupts.p1: SDCard_Interface/interrupts.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/interrupts.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/interrupts.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/interrupts.p1 SDCard_Interface/interrupts.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/interrupts.d ${OBJECTDIR}/SDCard_Interface/interrupts.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/interrupts.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/isr_profile.p1: SDCard_Interface/isr_profile.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/isr_profile.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/isr_profile.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/isr_profile.p1 SDCard_Interface/isr_profile.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/isr_profile.d ${OBJECTDIR}/SDCard_Interface/isr_profile.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/isr_profile.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/loop_stats.p1: SDCard_Interface/loop_stats.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/loop_stats.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/loop_stats.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/loop_stats.p1 SDCard_Interface/loop_stats.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/loop_stats.d ${OBJECTDIR}/SDCard_Interface/loop_stats.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/loop_stats.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/main.p1: SDCard_Interface/main.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/main.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/main.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/main.p1 SDCard_Interface/main.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/main.d ${OBJECTDIR}/SDCard_Interface/main.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/main.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/region_profile.p1: SDCard_Interface/region_profile.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/region_profile.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/region_profile.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/region_profile.p1 SDCard_Interface/region_profile.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/region_profile.d ${OBJECTDIR}/SDCard_Interface/region_profile.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/region_profile.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/scheduler.p1: SDCard_Interface/scheduler.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/scheduler.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/scheduler.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/scheduler.p1 SDCard_Interface/scheduler.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/scheduler.d ${OBJECTDIR}/SDCard_Interface/scheduler.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/scheduler.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/sd.p1: SDCard_Interface/sd.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/sd.p1 SDCard_Interface/sd.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/sd.d ${OBJECTDIR}/SDCard_Interface/sd.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/sd.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/sd_cache.p1: SDCard_Interface/sd_cache.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd_cache.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/sd_cache.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/sd_cache.p1 SDCard_Interface/sd_cache.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/sd_cache.d ${OBJECTDIR}/SDCard_Interface/sd_cache.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/sd_cache.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/spi.p1: SDCard_Interface/spi.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/spi.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/spi.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/spi.p1 SDCard_Interface/spi.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/spi.d ${OBJECTDIR}/SDCard_Interface/spi.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/spi.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/stack_guard.p1: SDCard_Interface/stack_guard.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/stack_guard.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/stack_guard.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/stack_guard.p1 SDCard_Interface/stack_guard.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/stack_guard.d ${OBJECTDIR}/SDCard_Interface/stack_guard.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/stack_guard.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/telemetry.p1: SDCard_Interface/telemetry.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/telemetry.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/telemetry.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/telemetry.p1 SDCard_Interface/telemetry.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/telemetry.d ${OBJECTDIR}/SDCard_Interface/telemetry.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/telemetry.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/time_base.p1: SDCard_Interface/time_base.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/time_base.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/time_base.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/time_base.p1 SDCard_Interface/time_base.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/time_base.d ${OBJECTDIR}/SDCard_Interface/time_base.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/time_base.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/timer.p1: SDCard_Interface/timer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/timer.p1 SDCard_Interface/timer.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/timer.d ${OBJECTDIR}/SDCard_Interface/timer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/timer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/timer_wheel.p1: SDCard_Interface/timer_wheel.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1 SDCard_Interface/timer_wheel.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/timer_wheel.d ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/timer_wheel.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/trace.p1: SDCard_Interface/trace.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/trace.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/trace.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/trace.p1 SDCard_Interface/trace.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/trace.d ${OBJECTDIR}/SDCard_Interface/trace.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/trace.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/uart.p1: SDCard_Interface/uart.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/uart.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/uart.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/uart.p1 SDCard_Interface/uart.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/uart.d ${OBJECTDIR}/SDCard_Interface/uart.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/uart.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/us_timer.p1: SDCard_Interface/us_timer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/us_timer.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/us_timer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/us_timer.p1 SDCard_Interface/us_timer.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/us_timer.d ${OBJECTDIR}/SDCard_Interface/us_timer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/us_timer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/SDCard_Interface/user_app.p1: SDCard_Interface/user_app.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}/SDCard_Interface" 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/user_app.p1.d 
+	@${RM} ${OBJECTDIR}/SDCard_Interface/user_app.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-download -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto     -o ${OBJECTDIR}/SDCard_Interface/user_app.p1 SDCard_Interface/user_app.c 
+	@-${MV} ${OBJECTDIR}/SDCard_Interface/user_app.d ${OBJECTDIR}/SDCard_Interface/user_app.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/SDCard_Interface/user_app.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 endif
 